@@ -35,7 +35,12 @@ Copyright (c) 2023 Weslley Fábio
 // #include "LR1110_Driver/lr11xx_crypto_engine.h"
 // #include "LR1110_Driver/lr11xx_system.h"
 // #include "LR1110_Driver/wifi.h"
+#if defined(LR11XX_SIM)
+#include "LR1110_Driver/lr11xx_sim.h"
+#else
 #include "bsp.h"
+#endif
+#include "LR1110_Driver/lr11xx_wifi_types.h"
 
 /* Define ------------------------------------------------------------*/
 
@@ -57,6 +62,98 @@ Copyright (c) 2023 Weslley Fábio
 #define LR1110_SPI_COMMUNICATION_ERROR 1
 #define LR1110_CONFIGURATION_ERROR 2
 #define LR1110_NO_WIFI_FOUND 3
+#define LR1110_SCAN_TIMEOUT_ERROR 4
+#define LR1110_FINGERPRINT_FORMAT_ERROR 5
+
+// Margem somada à duração nominal de um scan Wi-Fi antes de considerá-lo travado
+#define LR1110_WIFI_SCAN_DEADLINE_MARGIN_MS 500
+
+// Timeout de cada varredura dos scans por número de varreduras (lr11xx_wifi_scan) dos perfis de scan
+#define LR1110_WIFI_SCAN_TIMEOUT_MS 10
+
+// Prazo de um scan Wi-Fi: cada canal é varrido nb_scan_per_channel vezes, cada varredura dura no máximo timeout_ms
+#define LR1110_WIFI_SCAN_DEADLINE_MS(nb_channels, nb_scan_per_channel, timeout_ms) \
+    ((uint32_t)(nb_channels) * (nb_scan_per_channel) * (timeout_ms) + LR1110_WIFI_SCAN_DEADLINE_MARGIN_MS)
+
+// Duração máxima de um scan lr11xx_wifi_scan_time_limit B/G/N: 2 x canais x timeout por canal, mais 1% de tolerância
+// do cristal e o overhead fixo de 54,86 ms
+#define LR1110_WIFI_SCAN_TIME_LIMIT_OFFSET_MS 55
+#define LR1110_WIFI_SCAN_TIME_LIMIT_MAX_MS(nb_channels, timeout_per_channel_ms) \
+    (((uint32_t)2 * (nb_channels) * (timeout_per_channel_ms) * 101 + 99) / 100 + LR1110_WIFI_SCAN_TIME_LIMIT_OFFSET_MS)
+
+// Canais 1 a 14 da banda de 2,4 GHz
+#define LR1110_WIFI_NB_CHANNELS 14
+#define LR1110_WIFI_ALL_CHANNELS_MASK 0x3FFF
+
+// Canais 1, 6 e 11, sem sobreposição e onde ficam a maioria das redes
+#define LR1110_WIFI_NON_OVERLAPPING_CHANNELS_MASK \
+    (LR11XX_WIFI_CHANNEL_1_MASK | LR11XX_WIFI_CHANNEL_6_MASK | LR11XX_WIFI_CHANNEL_11_MASK)
+
+// Máscaras regulatórias: canais 1 a 11 (EUA, Canadá, Taiwan e territórios americanos), 1 a 13 (maior parte do
+// mundo) e 1 a 14 (Japão, canal 14 só em 802.11b)
+#define LR1110_WIFI_CHANNELS_1_TO_11_MASK 0x07FF
+#define LR1110_WIFI_CHANNELS_1_TO_13_MASK 0x1FFF
+
+// Scan de busca do código de país de HE_WifiSearchCountryCode
+#define LR1110_COUNTRY_CODE_SCAN_PER_CHANNEL 3
+#define LR1110_COUNTRY_CODE_SCAN_TIMEOUT_MS 110
+// Resultados de código de país lidos por transação SPI em HE_WifiSearchCountryCode
+#define LR1110_COUNTRY_CODE_RESULTS_PER_READ 16
+
+// Padrões de HE_ChannelPlannerInit: amplia o scan abaixo de 3 redes, planeja os canais com 90% das redes vistas
+#define LR1110_CHANNEL_PLAN_DEFAULT_MIN_NETWORKS 3
+#define LR1110_CHANNEL_PLAN_DEFAULT_COVERAGE_PERCENT 90
+
+// Scans em todos os canais antes de planejar, e depois um a cada LR1110_CHANNEL_PLAN_FULL_SCAN_PERIOD scans para
+// continuar aprendendo os canais fora do plano
+#define LR1110_CHANNEL_PLAN_WARMUP_SCANS 3
+#define LR1110_CHANNEL_PLAN_FULL_SCAN_PERIOD 16
+
+// Peso dos novos scans na média móvel da ocupação dos canais: 1 / 2^LR1110_CHANNEL_PLAN_EWMA_SHIFT
+#define LR1110_CHANNEL_PLAN_EWMA_SHIFT 2
+
+// Perfis de scan do agendador de energia, do mais completo (0) ao mais econômico, ver HE_EnergySchedulerProfile
+#define LR1110_ENERGY_NB_PROFILES 4
+#define LR1110_ENERGY_DEFAULT_PROFILE 1 // o scan histórico de HE_NetworkReading
+
+// Orçamento diário contabilizado em janelas de uma hora
+#define LR1110_ENERGY_NB_BUCKETS 24
+#define LR1110_ENERGY_BUCKET_MS (60u * 60u * 1000u)
+#define LR1110_ENERGY_DAY_MS (LR1110_ENERGY_NB_BUCKETS * LR1110_ENERGY_BUCKET_MS)
+
+// Peso do último scan na média móvel da carga de cada perfil: 1 / 2^LR1110_ENERGY_EWMA_SHIFT
+#define LR1110_ENERGY_EWMA_SHIFT 2
+
+// Limites dos timeouts ajustados por HE_TimeoutTunerUpdate. A detecção de preâmbulo é puxada até um intervalo de
+// beacon (102,4 ms) quando faltam redes
+#define LR1110_TIMEOUT_TUNER_MIN_PER_CHANNEL_MS 20
+#define LR1110_TIMEOUT_TUNER_MIN_PER_SCAN_MS 10
+#define LR1110_TIMEOUT_TUNER_BEACON_INTERVAL_MS 105
+
+// Piso do peso por RSSI na similaridade: uma rede pesa rssi - LR1110_SIMILARITY_RSSI_FLOOR_DBM, no mínimo 1
+#define LR1110_SIMILARITY_RSSI_FLOOR_DBM (-100)
+
+// Padrão de HE_SimilarityGateInit: abaixo de 60% de similaridade o dispositivo é considerado em movimento
+#define LR1110_SIMILARITY_DEFAULT_THRESHOLD_PERCENT 60
+
+// Redes após as quais o scan curto de HE_SimilarityGateProbe termina
+#define LR1110_SIMILARITY_PROBE_MAX_RESULTS (2 * NETWORKS_NUMBER)
+
+// Versão do formato compacto de fingerprint Wi-Fi gerado por HE_WifiFingerprintEncode
+#define LR1110_FINGERPRINT_VERSION 1
+
+// Cabeçalho do fingerprint: versão (bits 7:6), modo de canal (bits 5:4) e número de redes (bits 3:0)
+#define LR1110_FINGERPRINT_HEADER_SIZE 1
+#define LR1110_FINGERPRINT_MAX_NETWORKS 15
+
+// Modos de canal do fingerprint
+#define LR1110_FINGERPRINT_CHANNEL_NONE 0 // canais omitidos
+#define LR1110_FINGERPRINT_CHANNEL_COMMON 1 // todas as redes no mesmo canal, enviado uma única vez
+#define LR1110_FINGERPRINT_CHANNEL_PER_AP 2 // um canal por rede
+
+// RSSI quantizado em 4 bits: de LR1110_FINGERPRINT_RSSI_MIN_DBM a MIN + 15 * STEP, com saturação nos extremos
+#define LR1110_FINGERPRINT_RSSI_MIN_DBM (-100)
+#define LR1110_FINGERPRINT_RSSI_STEP_DB 4
 
 // Inicializador para a estrutura wifi_t
 #define LR1110_WIFI_T_INITIALIZER \
@@ -83,6 +180,24 @@ Copyright (c) 2023 Weslley Fábio
         .lr1110_error = LR1110_NO_WIFI_FOUND}
 
 #define LR1110_SUCCESS 0
+
+// Máscara de lr11xx_wifi_mac_origin_t ou lr11xx_wifi_frame_type_t para os estágios de filtro
+#define LR1110_FILTER_MASK(value) (1u << (value))
+
+// Rádios que podem ter cache de redes, planejador de canais, agendador de energia e ajuste de timeouts próprios
+#define LR1110_MAX_RADIOS 2
+
+// Capacidade da tabela do cache de redes, potência de 2, com ocupação limitada a 3/4 para sondagens curtas
+#define LR1110_AP_CACHE_CAPACITY 64
+#define LR1110_AP_CACHE_MAX_ENTRIES ((LR1110_AP_CACHE_CAPACITY * 3) / 4)
+
+// Peso das novas leituras na média móvel exponencial do RSSI: 1 / 2^LR1110_AP_CACHE_EWMA_SHIFT
+#define LR1110_AP_CACHE_EWMA_SHIFT 2
+
+// Padrões de HE_ApCacheInit: rede esquecida após 10 minutos sem ser vista, mudança a partir de 8 dB
+#define LR1110_AP_CACHE_DEFAULT_MAX_AGE_MS (10u * 60u * 1000u)
+#define LR1110_AP_CACHE_DEFAULT_RSSI_DELTA_DB 8
+
 /* Typedef -----------------------------------------------------------*/
 
 // uint8_t nb_results;
@@ -129,6 +244,142 @@ typedef struct
     uint8_t lr1110_error;
 } LR1110ResponseNetworksToDevice_t;
 
+// Estágios do pipeline de filtros de redes, ver HE_FilterAccepts
+typedef enum
+{
+    LR1110_FILTER_LOCALLY_ADMINISTERED, //!< Rejeita MACs administrados localmente (bit 0x02 do primeiro byte)
+    LR1110_FILTER_OUI_DENY,             //!< Rejeita os MACs cujo OUI está na lista
+    LR1110_FILTER_OUI_ALLOW,            //!< Aceita somente os MACs cujo OUI está na lista
+    LR1110_FILTER_MIN_RSSI,             //!< Rejeita as redes com RSSI abaixo de min_rssi_dbm
+    LR1110_FILTER_MAC_ORIGIN,           //!< Aceita somente as origens de MAC presentes em mask
+    LR1110_FILTER_FRAME_TYPE,           //!< Aceita somente os tipos de quadro presentes em mask, se conhecidos
+    LR1110_FILTER_MOBILE_AP,            //!< Rejeita as redes cuja origem de MAC estimada é um AP móvel
+    LR1110_FILTER_RSSI_VALID,           //!< Rejeita as redes cujo RSSI foi medido em um quadro de outro dispositivo
+} LR1110_filter_type_t;
+
+typedef struct
+{
+    LR1110_filter_type_t type;
+    union
+    {
+        struct
+        {
+            const uint8_t (*ouis)[3]; //!< OUIs, 3 primeiros bytes do MAC
+            uint8_t nb_ouis;
+        } oui;
+        int8_t min_rssi_dbm;
+        uint8_t mask; //!< LR1110_FILTER_MASK das origens de MAC ou tipos de quadro aceitos
+    };
+} LR1110_filter_stage_t;
+
+typedef struct
+{
+    const LR1110_filter_stage_t *stages;
+    uint8_t nb_stages;
+} LR1110_filter_pipeline_t;
+
+// Rede candidata, comum a todos os formatos de resultado do scan
+typedef struct
+{
+    const uint8_t *mac;
+    int8_t rssi;
+    uint8_t channel_info_byte;
+    bool has_frame_type; //!< false nos formatos que não trazem o frame_type_info_byte
+    uint8_t frame_type_info_byte;
+} LR1110_filter_candidate_t;
+
+// Grava o código de país detectado em memória não volátil, para restaurá-lo com HE_SetCountryCode no boot
+typedef void (*LR1110_country_code_save_t)(const uint8_t *country_code);
+
+// Configuração de um scan Wi-Fi escolhida pelo agendador de energia
+typedef struct
+{
+    lr11xx_wifi_mode_t scan_mode;
+    uint16_t channel_mask;
+    uint8_t nb_scan_per_channel;
+} LR1110_scan_profile_t;
+
+// Orçamento de energia diário móvel e perfil de scan que o respeita, ver HE_EnergySchedulerRecordScan
+typedef struct
+{
+    uint32_t daily_budget_uah;
+    uint32_t min_interval_ms;
+    uint32_t max_interval_ms;
+    uint32_t spent_nah[LR1110_ENERGY_NB_BUCKETS]; //!< Carga gasta em cada hora das últimas 24, em nAh
+    uint32_t bucket_start_ms;
+    uint8_t bucket;
+    bool has_started;
+    uint32_t scan_charge_nah[LR1110_ENERGY_NB_PROFILES]; //!< Média móvel da carga por scan, 0 se desconhecida
+    uint32_t last_scan_nah;
+    uint8_t profile;
+    uint32_t interval_ms; //!< Intervalo até o próximo scan
+} LR1110_energy_scheduler_t;
+
+// Comparação com o último fingerprint informado, ver HE_SimilarityGateHasMoved
+typedef struct
+{
+    LR1110ResponseNetworksToDevice_t reference;
+    bool has_reference;
+    uint8_t threshold_percent;
+    uint8_t last_similarity_percent;
+} LR1110_similarity_gate_t;
+
+// Timeouts de lr11xx_wifi_scan_time_limit ajustados a cada scan, ver HE_TimeoutTunerUpdate
+typedef struct
+{
+    uint16_t per_channel_ms;    //!< Timeout por canal atual, antes do teto
+    uint16_t per_scan_ms;       //!< Timeout de detecção de preâmbulo atual, no máximo per_channel_ms
+    uint32_t target_latency_ms; //!< Duração desejada de um scan
+    uint8_t target_networks;    //!< Redes desejadas por scan
+    uint32_t max_scan_ms;       //!< Teto da duração de um scan, ver HE_TimeoutTunerPerChannel
+    uint32_t last_scan_ms;      //!< Tempo de rádio medido no último scan
+} LR1110_timeout_tuner_t;
+
+// Ocupação de cada canal aprendida nos scans anteriores, ver HE_ChannelPlannerMask
+typedef struct
+{
+    uint16_t occupancy_q4[LR1110_WIFI_NB_CHANNELS]; //!< Média móvel de redes por scan em cada canal, em 1/16
+    uint16_t nb_scans;
+    uint8_t min_networks;     //!< Abaixo disso o scan é ampliado para os canais restantes
+    uint8_t coverage_percent; //!< Fração da ocupação total coberta pelos canais do plano
+} LR1110_channel_planner_t;
+
+typedef enum
+{
+    LR1110_AP_CHANGE_NEW,   //!< Rede que não estava no cache
+    LR1110_AP_CHANGE_LOST,  //!< Rede não vista há mais de max_age_ms, removida do cache
+    LR1110_AP_CHANGE_MOVED, //!< RSSI médio distante do último informado em rssi_delta_db ou mais
+} LR1110_ap_change_type_t;
+
+typedef struct
+{
+    uint8_t mac[MAC_SIZE];
+    LR1110_ap_change_type_t type;
+    int8_t rssi; //!< RSSI médio, em dBm
+    uint8_t channel_info_byte;
+} LR1110_ap_change_t;
+
+typedef struct
+{
+    uint8_t mac[MAC_SIZE];
+    bool is_used;
+    uint8_t channel_info_byte;
+    int16_t rssi_q4;      //!< Média móvel exponencial do RSSI, em 1/16 dBm
+    int8_t reported_rssi; //!< RSSI da última mudança informada, referência para LR1110_AP_CHANGE_MOVED
+    uint16_t hits;
+    uint32_t last_seen_ms;
+} LR1110_ap_cache_entry_t;
+
+// Cache de redes entre scans, tabela de endereçamento aberto com sondagem linear indexada pelo MAC
+typedef struct
+{
+    LR1110_ap_cache_entry_t entries[LR1110_AP_CACHE_CAPACITY];
+    uint8_t nb_entries;
+    uint8_t nb_last_changes; //!< Mudanças da última atualização, 0 se nada mudou
+    uint8_t rssi_delta_db;
+    uint32_t max_age_ms;
+} LR1110_ap_cache_t;
+
 // lr11xx_system_rfswitch_cfg_t smtc_shield_lr11xx_common_rf_switch_cfg = {
 //     .enable = LR11XX_SYSTEM_RFSW0_HIGH | LR11XX_SYSTEM_RFSW1_HIGH,
 //     .standby = 0,
@@ -146,6 +397,71 @@ typedef struct
 
 void teste_lr1110(void);
 LR1110ResponseNetworksToDevice_t HE_NetworkReading(void);
+LR1110ResponseNetworksToDevice_t HE_NetworkReadingOnRadio(const void *context);
+void HE_SetNetworksToReport(const uint8_t count);
+void HE_SetFilterPipeline(const LR1110_filter_pipeline_t *pipeline);
+const LR1110_filter_pipeline_t *HE_GetFilterPipeline(void);
+bool HE_FilterAccepts(const LR1110_filter_pipeline_t *pipeline, const LR1110_filter_candidate_t *candidate);
+uint8_t HE_FilterMacTypeChannelResults(const LR1110_filter_pipeline_t *pipeline,
+                                       lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results);
+uint8_t HE_FilterBasicCompleteResults(const LR1110_filter_pipeline_t *pipeline,
+                                      lr11xx_wifi_basic_complete_result_t *results, const uint8_t nb_results);
+uint8_t HE_GetNetworksToReport(void);
+uint8_t HE_WifiScanAndWait(const void *context, const uint32_t deadline_ms,
+                           lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results);
+uint8_t HE_WifiFingerprintEncode(const LR1110ResponseNetworksToDevice_t *networks, const bool with_channels,
+                                 uint8_t *payload, const uint8_t payload_size);
+uint8_t HE_WifiFingerprintDecode(const uint8_t *payload, const uint8_t payload_size,
+                                 LR1110ResponseNetworksToDevice_t *networks);
+void HE_ApCacheInit(LR1110_ap_cache_t *cache, const uint32_t max_age_ms, const uint8_t rssi_delta_db);
+uint8_t HE_ApCacheUpdate(LR1110_ap_cache_t *cache, const lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                         const uint8_t nb_results, const uint32_t now_ms, LR1110_ap_change_t *changes,
+                         const uint8_t max_changes);
+const LR1110_ap_cache_entry_t *HE_ApCacheFind(const LR1110_ap_cache_t *cache, const uint8_t *mac);
+bool HE_SetApCache(const void *context, LR1110_ap_cache_t *cache);
+uint8_t HE_WifiScanChannelsAndWait(const void *context, const LR1110_scan_profile_t *profile,
+                                   const uint16_t channel_mask, const uint8_t max_results, const uint32_t deadline_ms,
+                                   lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results);
+void HE_ChannelPlannerInit(LR1110_channel_planner_t *planner, const uint8_t min_networks,
+                           const uint8_t coverage_percent);
+uint16_t HE_ChannelPlannerMask(const LR1110_channel_planner_t *planner);
+void HE_ChannelPlannerUpdate(LR1110_channel_planner_t *planner, const uint16_t channel_mask,
+                             const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results);
+bool HE_SetChannelPlanner(const void *context, LR1110_channel_planner_t *planner);
+uint8_t HE_WifiSimilarity(const LR1110ResponseNetworksToDevice_t *reference,
+                          const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results);
+void HE_SimilarityGateInit(LR1110_similarity_gate_t *gate, const uint8_t threshold_percent);
+void HE_SimilarityGateSetReference(LR1110_similarity_gate_t *gate, const LR1110ResponseNetworksToDevice_t *reported);
+bool HE_SimilarityGateHasMoved(LR1110_similarity_gate_t *gate,
+                               const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results);
+uint8_t HE_SimilarityGateProbe(const void *context, LR1110_similarity_gate_t *gate, bool *has_moved);
+void HE_EnergySchedulerInit(LR1110_energy_scheduler_t *scheduler, const uint32_t daily_budget_uah,
+                            const uint32_t min_interval_ms, const uint32_t max_interval_ms);
+uint32_t HE_EnergySchedulerScanCharge(const lr11xx_wifi_cumulative_timings_t *timings);
+void HE_EnergySchedulerRecordScan(LR1110_energy_scheduler_t *scheduler, const lr11xx_wifi_cumulative_timings_t *timings,
+                                  const uint32_t now_ms);
+uint32_t HE_EnergySchedulerSpentUah(const LR1110_energy_scheduler_t *scheduler);
+const LR1110_scan_profile_t *HE_EnergySchedulerProfile(const LR1110_energy_scheduler_t *scheduler);
+uint32_t HE_EnergySchedulerInterval(const LR1110_energy_scheduler_t *scheduler);
+bool HE_SetEnergyScheduler(const void *context, LR1110_energy_scheduler_t *scheduler);
+uint16_t HE_CountryCodeChannelMask(const uint8_t *country_code);
+void HE_SetCountryCode(const uint8_t *country_code);
+bool HE_GetCountryCode(uint8_t *country_code);
+uint16_t HE_GetRegulatoryChannelMask(void);
+void HE_SetCountryCodeSaveCallback(LR1110_country_code_save_t save);
+uint8_t HE_WifiSearchCountryCode(const void *context, uint8_t *country_code);
+bool HE_ApCacheHasChanged(const void *context);
+void HE_TimeoutTunerInit(LR1110_timeout_tuner_t *tuner, const uint32_t target_latency_ms,
+                         const uint8_t target_networks, const uint32_t max_scan_ms);
+uint16_t HE_TimeoutTunerPerChannel(const LR1110_timeout_tuner_t *tuner, const uint8_t nb_channels);
+uint16_t HE_TimeoutTunerPerScan(const LR1110_timeout_tuner_t *tuner, const uint8_t nb_channels);
+void HE_TimeoutTunerUpdate(LR1110_timeout_tuner_t *tuner, const lr11xx_wifi_cumulative_timings_t *timings,
+                           const uint8_t nb_channels, const uint8_t nb_results);
+bool HE_SetTimeoutTuner(const void *context, LR1110_timeout_tuner_t *tuner);
+uint8_t HE_WifiScanTimeLimitAndWait(const void *context, const lr11xx_wifi_mode_t scan_mode,
+                                    const uint16_t channel_mask, const uint8_t max_results,
+                                    const uint16_t timeout_per_channel_ms, const uint16_t timeout_per_scan_ms,
+                                    lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results);
 
 #endif /*__HE_LR1110_API_H_*/
 
@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      lr11xx_energy.h
+ *
+ * @brief     Charge estimation of the LR11XX activities
+ */
+
+#ifndef LR11XX_ENERGY_H
+#define LR11XX_ENERGY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- DEPENDENCIES ------------------------------------------------------------
+     */
+
+#include <stdint.h>
+#include "LR1110_Driver/lr11xx_system_types.h"
+#include "LR1110_Driver/lr11xx_wifi_types.h"
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC MACROS -----------------------------------------------------------
+     */
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC CONSTANTS --------------------------------------------------------
+     */
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC TYPES ------------------------------------------------------------
+     */
+
+    /*!
+     * @brief Activities of the LR11XX whose charge can be estimated
+     */
+    typedef enum
+    {
+        LR11XX_ENERGY_WIFI_CORRELATION = 0, //!< Wi-Fi preamble detection
+        LR11XX_ENERGY_WIFI_CAPTURE,         //!< Wi-Fi signal acquisition
+        LR11XX_ENERGY_WIFI_DEMODULATION,    //!< Wi-Fi software demodulation
+        LR11XX_ENERGY_GNSS_CAPTURE,         //!< GNSS signal acquisition
+        LR11XX_ENERGY_GNSS_PROCESSING,      //!< GNSS signal processing by the LR11XX
+        LR11XX_ENERGY_LORA_RX,              //!< LoRa reception, 125 kHz bandwidth
+        LR11XX_ENERGY_LORA_TX_LP_14_DBM,    //!< LoRa transmission on the low-power PA at +14 dBm
+        LR11XX_ENERGY_LORA_TX_HP_22_DBM,    //!< LoRa transmission on the high-power PA at +22 dBm
+        LR11XX_ENERGY_CRYPTO,               //!< Crypto engine operation
+        LR11XX_ENERGY_NB_ACTIVITIES,
+    } lr11xx_energy_activity_t;
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+     */
+
+    /*!
+     * @brief Get the current drawn from the battery by an activity
+     *
+     * @param [in] regulator The regulator configured with lr11xx_system_set_reg_mode
+     * @param [in] activity  Activity of the LR11XX
+     *
+     * @returns Current in uA, 0 for an unknown activity
+     */
+    uint32_t lr11xx_energy_get_current_ua(const lr11xx_system_reg_mode_t regulator,
+                                          const lr11xx_energy_activity_t activity);
+
+    /*!
+     * @brief Estimate the charge used by an activity
+     *
+     * Computed as a 32x32-bit multiplication by a precomputed fixed-point coefficient, without any division.
+     *
+     * @param [in] regulator   The regulator configured with lr11xx_system_set_reg_mode
+     * @param [in] activity    Activity of the LR11XX
+     * @param [in] duration_us Duration of the activity in microseconds
+     *
+     * @returns Charge in nAh, 0 for an unknown activity
+     */
+    uint32_t lr11xx_energy_get_charge_nah(const lr11xx_system_reg_mode_t regulator,
+                                          const lr11xx_energy_activity_t activity, const uint32_t duration_us);
+
+    /*!
+     * @brief Estimate the charge used by the Wi-Fi scans from their cumulative timing
+     *
+     * @param [in] regulator The regulator used during the Wi-Fi scans
+     * @param [in] timing    Cumulative timing read with lr11xx_wifi_read_cumulative_timing
+     *
+     * @returns Charge in nAh
+     */
+    uint32_t lr11xx_energy_get_wifi_charge_nah(const lr11xx_system_reg_mode_t regulator,
+                                               const lr11xx_wifi_cumulative_timings_t *timing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LR11XX_ENERGY_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -63,6 +63,155 @@ extern "C"
  */
 #define LR11XX_NOP (0x00)
 
+/**
+ * @brief Default maximum time, in milliseconds, the HAL waits for the BUSY line to be released
+ *
+ * Must cover the longest blocking operation (flash erase, calibration, Wi-Fi/GNSS scan).
+ */
+#ifndef LR11XX_HAL_BUSY_TIMEOUT_MS
+#define LR11XX_HAL_BUSY_TIMEOUT_MS (10000)
+#endif
+
+/**
+ * @brief Task notification index a task blocks on while the HAL waits for the radio
+ *
+ * Index 0 is left to the application: its notifications are neither consumed nor lost while a task waits on the
+ * radio. configTASK_NOTIFICATION_ARRAY_ENTRIES must be greater than this index.
+ */
+#ifndef LR11XX_HAL_NOTIFY_INDEX
+#define LR11XX_HAL_NOTIFY_INDEX (1)
+#endif
+
+/**
+ * @brief Maximum number of writes that can be queued between @ref lr11xx_hal_batch_begin and
+ * @ref lr11xx_hal_batch_submit before the queue is flushed
+ */
+#ifndef LR11XX_HAL_BATCH_MAX_TRANSACTIONS
+#define LR11XX_HAL_BATCH_MAX_TRANSACTIONS (16)
+#endif
+
+/**
+ * @brief Size of the buffer holding the command and data bytes of the queued writes
+ */
+#ifndef LR11XX_HAL_BATCH_BUFFER_SIZE
+#define LR11XX_HAL_BATCH_BUFFER_SIZE (128)
+#endif
+
+/**
+ * @brief Number of asynchronous requests that can be pending at the same time
+ */
+#ifndef LR11XX_HAL_ASYNC_QUEUE_LENGTH
+#define LR11XX_HAL_ASYNC_QUEUE_LENGTH (8)
+#endif
+
+/**
+ * @brief Largest command accepted by @ref lr11xx_hal_write_async and @ref lr11xx_hal_read_async
+ *
+ * The command is copied into the request so that the caller can release it once the request is submitted.
+ */
+#ifndef LR11XX_HAL_ASYNC_CMD_LENGTH_MAX
+#define LR11XX_HAL_ASYNC_CMD_LENGTH_MAX (16)
+#endif
+
+/**
+ * @brief Initial value of the CRC protecting SPI transactions when CRC over SPI is enabled
+ */
+#define LR11XX_HAL_CRC_INITIAL_VALUE (0xFF)
+
+/**
+ * @brief Number of times a transaction whose CRC does not match is sent again before giving up
+ */
+#ifndef LR11XX_HAL_CRC_MAX_RETRIES
+#define LR11XX_HAL_CRC_MAX_RETRIES (2)
+#endif
+
+/**
+ * @brief Maximum number of tasks that can wait for the same radio at the same time
+ *
+ * Extra tasks poll the lock every tick until a waiting slot is free.
+ */
+#ifndef LR11XX_HAL_LOCK_MAX_WAITERS
+#define LR11XX_HAL_LOCK_MAX_WAITERS (8)
+#endif
+
+/**
+ * @brief Largest transaction, command and data bytes, served ahead of longer ones waiting at the same task priority
+ *
+ * Covers status, IRQ and result-count reads so that they are not queued behind a long result readout.
+ */
+#ifndef LR11XX_HAL_LOCK_SHORT_TRANSACTION_SIZE
+#define LR11XX_HAL_LOCK_SHORT_TRANSACTION_SIZE (8)
+#endif
+
+/**
+ * @brief Maximum number of SPI buses the radios are connected to, the default SPI bus included
+ */
+#ifndef LR11XX_HAL_MAX_SPI_BUSES
+#define LR11XX_HAL_MAX_SPI_BUSES (2)
+#endif
+
+/**
+ * @brief Record per-opcode call counts, byte counts, BUSY wait and transfer time histograms
+ *
+ * Costs two timestamps and a table lookup per transaction, and LR11XX_HAL_INSTR_MAX_OPCODES entries of RAM per radio.
+ */
+#ifndef LR11XX_HAL_INSTRUMENTATION
+#define LR11XX_HAL_INSTRUMENTATION (0)
+#endif
+
+/**
+ * @brief Number of distinct opcodes tracked per radio, further opcodes are only counted as untracked
+ */
+#ifndef LR11XX_HAL_INSTR_MAX_OPCODES
+#define LR11XX_HAL_INSTR_MAX_OPCODES (32)
+#endif
+
+/**
+ * @brief Number of bins of the transfer time histogram
+ *
+ * Bin 0 counts transfers shorter than 1 us, bin n those in [2^(n-1), 2^n) us; the last bin also holds longer ones.
+ */
+#ifndef LR11XX_HAL_INSTR_HISTOGRAM_BINS
+#define LR11XX_HAL_INSTR_HISTOGRAM_BINS (16)
+#endif
+
+/**
+ * @brief Opcode recorded for direct reads, which carry no command
+ */
+#define LR11XX_HAL_INSTR_OPCODE_DIRECT_READ (0xFFFF)
+
+/**
+ * @brief Enable the transaction capture and replay of @ref lr11xx_hal_capture_start and @ref lr11xx_hal_replay_start
+ *
+ * Costs a test per transaction when no capture is running, and the copy of each transaction into the capture buffer
+ * when one is. Timestamps come from the same clock as the instrumentation.
+ */
+#ifndef LR11XX_HAL_CAPTURE
+#define LR11XX_HAL_CAPTURE (0)
+#endif
+
+/**
+ * @brief Size of the header of a capture record
+ *
+ * A capture is a sequence of records, all fields little-endian:
+ *   - uint16 record length, header included
+ *   - uint8  record type (@ref lr11xx_hal_capture_record_type_t) in bits 3:0, HAL status in bits 7:4
+ *   - uint8  command length
+ *   - uint32 start timestamp, in microseconds
+ *   - uint32 duration, in microseconds, BUSY wait and CRC retries included
+ *   - command bytes, followed by the data bytes: sent for a write, received for a read or a direct read
+ */
+#define LR11XX_HAL_CAPTURE_HEADER_SIZE (12)
+
+/**
+ * @brief Longest record handed over by @ref lr11xx_hal_read_records, sizes the record buffer on the stack
+ *
+ * The largest record read by the driver is the 79-byte Wi-Fi extended full result.
+ */
+#ifndef LR11XX_HAL_RECORD_MAX_LENGTH
+#define LR11XX_HAL_RECORD_MAX_LENGTH (80)
+#endif
+
     /*
      * -----------------------------------------------------------------------------
      * --- PUBLIC TYPES ------------------------------------------------------------
@@ -75,8 +224,153 @@ extern "C"
     {
         LR11XX_HAL_STATUS_OK = 0,
         LR11XX_HAL_STATUS_ERROR = 3,
+        LR11XX_HAL_STATUS_TIMEOUT = 4,
     } lr11xx_hal_status_t;
 
+    /*!
+     * @brief LR11XX HAL transaction type
+     */
+    typedef enum lr11xx_hal_transaction_type_e
+    {
+        LR11XX_HAL_TRANSACTION_WRITE = 0,       //!< Same as @ref lr11xx_hal_write
+        LR11XX_HAL_TRANSACTION_READ = 1,        //!< Same as @ref lr11xx_hal_read
+        LR11XX_HAL_TRANSACTION_DIRECT_READ = 2, //!< Same as @ref lr11xx_hal_direct_read, command is ignored
+    } lr11xx_hal_transaction_type_t;
+
+    /*!
+     * @brief LR11XX HAL transaction, one entry of a batch
+     */
+    typedef struct lr11xx_hal_transaction_s
+    {
+        lr11xx_hal_transaction_type_t type;
+        const uint8_t *command;
+        uint16_t command_length;
+        const uint8_t *tx_data; //!< Data sent after the command, only used by write transactions
+        uint8_t *rx_data;       //!< Response buffer, only used by read transactions
+        uint16_t data_length;
+    } lr11xx_hal_transaction_t;
+
+    /*!
+     * @brief Completion callback of an asynchronous request, called from the HAL worker task
+     *
+     * @param [in] context   Radio implementation parameters the request was submitted with
+     * @param [in] status    Status of the request
+     * @param [in] user_data User pointer given at submission
+     */
+    typedef void (*lr11xx_hal_async_callback_t)(const void *context, lr11xx_hal_status_t status, void *user_data);
+
+    /*!
+     * @brief Consumer of the records of a response, see @ref lr11xx_hal_read_records
+     *
+     * @param [in] user_data User pointer given to lr11xx_hal_read_records
+     * @param [in] index     Index of the record in the response
+     * @param [in] record    Record bytes as received, only valid during the call
+     */
+    typedef void (*lr11xx_hal_record_callback_t)(void *user_data, const uint16_t index, const uint8_t *record);
+
+    typedef struct lr11xx_hal_async_request_s lr11xx_hal_async_request_t;
+
+    /*!
+     * @brief Work executed by the HAL worker task for an asynchronous request
+     */
+    typedef lr11xx_hal_status_t (*lr11xx_hal_async_job_t)(const lr11xx_hal_async_request_t *request);
+
+    /*!
+     * @brief CRC over SPI counters
+     */
+    typedef struct lr11xx_hal_crc_stats_s
+    {
+        uint32_t nb_errors;   //!< Transactions detected as corrupted
+        uint32_t nb_retries;  //!< Transactions sent again after a CRC error
+        uint32_t nb_failures; //!< Transactions still corrupted after LR11XX_HAL_CRC_MAX_RETRIES retries
+    } lr11xx_hal_crc_stats_t;
+
+    /*!
+     * @brief Radio lock counters
+     */
+    typedef struct lr11xx_hal_lock_stats_s
+    {
+        uint32_t nb_acquisitions;  //!< Times the radio was locked, nested locks excluded
+        uint32_t nb_contentions;   //!< Acquisitions that had to wait for another task
+        uint32_t total_wait_ticks; //!< Time spent waiting for the radio, in FreeRTOS ticks
+        uint32_t max_wait_ticks;   //!< Longest wait for the radio, in FreeRTOS ticks
+        uint8_t max_waiters;       //!< Largest number of tasks waiting for the radio at the same time
+    } lr11xx_hal_lock_stats_t;
+
+    /*!
+     * @brief Per-radio transfer counters
+     */
+    typedef struct lr11xx_hal_stats_s
+    {
+        uint32_t nb_writes;        //!< Write transactions sent, retries included
+        uint32_t nb_reads;         //!< Read transactions sent, retries included
+        uint32_t nb_direct_reads;  //!< Direct read transactions sent, retries included
+        uint32_t nb_bytes_tx;      //!< Command and data bytes written, CRC excluded
+        uint32_t nb_bytes_rx;      //!< Data bytes read, stat1 and CRC excluded
+        uint32_t nb_busy_timeouts; //!< Transactions aborted because BUSY stayed high
+        lr11xx_hal_crc_stats_t crc;
+        lr11xx_hal_lock_stats_t lock;
+    } lr11xx_hal_stats_t;
+
+    /*!
+     * @brief Counters of one opcode, see LR11XX_HAL_INSTRUMENTATION
+     *
+     * A transaction sent again after a CRC error is counted once, the retries included in its transfer time.
+     */
+    typedef struct lr11xx_hal_opcode_stats_s
+    {
+        uint16_t opcode;       //!< First two command bytes, LR11XX_HAL_INSTR_OPCODE_DIRECT_READ for direct reads
+        uint32_t nb_calls;     //!< Transactions sent
+        uint32_t nb_bytes_tx;  //!< Command and data bytes written, CRC excluded
+        uint32_t nb_bytes_rx;  //!< Data bytes read, stat1 and CRC excluded
+        uint32_t busy_wait_us; //!< Time spent waiting for the radio to release BUSY
+        uint32_t transfer_us_histogram[LR11XX_HAL_INSTR_HISTOGRAM_BINS]; //!< Transfer time, BUSY wait excluded
+    } lr11xx_hal_opcode_stats_t;
+
+    /*!
+     * @brief Type of a capture record
+     */
+    typedef enum lr11xx_hal_capture_record_type_e
+    {
+        LR11XX_HAL_CAPTURE_RECORD_WRITE = 1,
+        LR11XX_HAL_CAPTURE_RECORD_READ = 2,
+        LR11XX_HAL_CAPTURE_RECORD_DIRECT_READ = 3,
+        LR11XX_HAL_CAPTURE_RECORD_RESET = 4,
+        LR11XX_HAL_CAPTURE_RECORD_WAKEUP = 5,
+    } lr11xx_hal_capture_record_type_t;
+
+    /*!
+     * @brief Capture and replay counters, see LR11XX_HAL_CAPTURE
+     */
+    typedef struct lr11xx_hal_capture_stats_s
+    {
+        uint32_t nb_records;           //!< Records written to the capture buffer
+        uint32_t nb_overwritten;       //!< Oldest records dropped to make room for new ones
+        uint32_t nb_too_large;         //!< Transactions not recorded because they do not fit in the capture buffer
+        uint32_t nb_replayed;          //!< Transactions answered from the replayed capture
+        uint32_t nb_replay_mismatches; //!< Transactions that did not match the next record, or past its end
+    } lr11xx_hal_capture_stats_t;
+
+    /*!
+     * @brief LR11XX HAL asynchronous request
+     *
+     * The request itself is copied at submission. Buffers it points to (tx_data, rx_data) must remain valid until the
+     * completion callback is called.
+     */
+    struct lr11xx_hal_async_request_s
+    {
+        lr11xx_hal_async_job_t job;
+        const void *context;
+        uint8_t command[LR11XX_HAL_ASYNC_CMD_LENGTH_MAX];
+        uint16_t command_length;
+        const uint8_t *tx_data;
+        uint8_t *rx_data;
+        uint16_t data_length;
+        uint32_t param; //!< Job specific parameter
+        lr11xx_hal_async_callback_t callback;
+        void *user_data;
+    };
+
     /*
      * -----------------------------------------------------------------------------
      * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -96,6 +390,26 @@ extern "C"
     lr11xx_hal_status_t lr11xx_hal_write(const void *context, const uint8_t *command, const uint16_t command_length,
                                          const uint8_t *data, const uint16_t data_length);
 
+    /*!
+     * @brief Radio data transfer - write of 32-bit words sent big-endian
+     *
+     * Same as @ref lr11xx_hal_write with the data given as host-order words. The words are byte-swapped on the fly
+     * while they are streamed to the SPI bus, so the caller needs no staging buffer.
+     *
+     * @remark Not queued by an open batch: the writes queued so far are sent first.
+     *
+     * @param [in] context          Radio implementation parameters
+     * @param [in] command          Pointer to the buffer to be transmitted
+     * @param [in] command_length   Buffer size to be transmitted
+     * @param [in] words            Pointer to the words to be transmitted
+     * @param [in] nb_words         Number of words to be transmitted
+     *
+     * @returns Operation status
+     */
+    lr11xx_hal_status_t lr11xx_hal_write_be32(const void *context, const uint8_t *command,
+                                              const uint16_t command_length, const uint32_t *words,
+                                              const uint16_t nb_words);
+
     /*!
      * @brief Radio data transfer - read
      *
@@ -119,6 +433,34 @@ extern "C"
     lr11xx_hal_status_t lr11xx_hal_read(const void *context, const uint8_t *command, const uint16_t command_length,
                                         uint8_t *data, const uint16_t data_length);
 
+    /*!
+     * @brief Radio data read request for a response made of fixed-size records, decoded while they are received
+     *
+     * Same transaction as @ref lr11xx_hal_read with data_length = record_length * nb_records, except that the
+     * response is never stored as a whole: each record is clocked into a buffer of LR11XX_HAL_RECORD_MAX_LENGTH bytes
+     * and handed to the callback before the next one is read.
+     *
+     * @remark The callback runs with NSS asserted: it must be short and must not access the radio.
+     *
+     * @remark With CRC over SPI, the response is checked once all records are received. On a CRC error the transaction
+     * is sent again and the callback is called again for every record, from index 0. Records are only valid if
+     * LR11XX_HAL_STATUS_OK is returned.
+     *
+     * @param [in] context        Radio implementation parameters
+     * @param [in] command        Pointer to the buffer to be transmitted
+     * @param [in] command_length Buffer size to be transmitted
+     * @param [in] record_length  Size of one record, at most LR11XX_HAL_RECORD_MAX_LENGTH
+     * @param [in] nb_records     Number of records of the response
+     * @param [in] callback       Called once per record, in order
+     * @param [in] user_data      Given back to the callback
+     *
+     * @returns Operation status, LR11XX_HAL_STATUS_ERROR if record_length is out of range
+     */
+    lr11xx_hal_status_t lr11xx_hal_read_records(const void *context, const uint8_t *command,
+                                                const uint16_t command_length, const uint16_t record_length,
+                                                const uint16_t nb_records, lr11xx_hal_record_callback_t callback,
+                                                void *user_data);
+
     /*!
      * @brief  Direct read from the SPI bus
      *
@@ -157,6 +499,325 @@ extern "C"
      */
     lr11xx_hal_status_t lr11xx_hal_wakeup(const void *context);
 
+    /*!
+     * @brief Set the maximum time the HAL waits for the radio to release the BUSY line
+     *
+     * When the timeout expires the pending transfer is not started and @ref LR11XX_HAL_STATUS_TIMEOUT is returned.
+     *
+     * @param [in] context    Radio implementation parameters
+     * @param [in] timeout_ms Timeout in milliseconds
+     */
+    void lr11xx_hal_set_busy_timeout(const void *context, const uint32_t timeout_ms);
+
+    /*!
+     * @brief BUSY falling edge notification
+     *
+     * @remark Only used when LR11XX_HAL_BUSY_EXTI is set to 1. The board must configure the BUSY pin as a falling edge
+     * EXTI and call this function from the interrupt handler. The waiting task then sleeps on its
+     * LR11XX_HAL_NOTIFY_INDEX task notification instead of polling the pin.
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_busy_irq_handler(const void *context);
+
+    /*!
+     * @brief Forget an IRQ DIO interrupt received so far
+     *
+     * To be called before starting the operation whose completion is awaited with @ref lr11xx_hal_wait_irq, after the
+     * IRQ status of the radio has been cleared.
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_clear_irq(const void *context);
+
+    /*!
+     * @brief Suspend the calling task until the radio raises its IRQ DIO, or until a deadline
+     *
+     * The radio is not locked while waiting: other tasks can use it, their commands then wait for BUSY.
+     *
+     * @remark With LR11XX_HAL_DIO_EXTI set to 1, the task sleeps on its LR11XX_HAL_NOTIFY_INDEX task notification
+     * until @ref lr11xx_hal_dio_irq_handler is called. Otherwise the end of the operation is detected on the BUSY line, checked once per FreeRTOS tick.
+     *
+     * @param [in] context    Radio implementation parameters
+     * @param [in] timeout_ms Deadline, in milliseconds from the call
+     *
+     * @returns LR11XX_HAL_STATUS_TIMEOUT if the deadline expired first
+     */
+    lr11xx_hal_status_t lr11xx_hal_wait_irq(const void *context, const uint32_t timeout_ms);
+
+    /*!
+     * @brief IRQ DIO rising edge notification
+     *
+     * @remark Only used when LR11XX_HAL_DIO_EXTI is set to 1. The board must configure the DIO routed by
+     * lr11xx_system_set_dio_irq_params as a rising edge EXTI and call this function from the interrupt handler.
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_dio_irq_handler(const void *context);
+
+    /*!
+     * @brief Run a list of transactions back-to-back
+     *
+     * Transactions are executed in order. Each one still waits for BUSY and gets its own NSS window, as required by the
+     * radio, but the whole list goes through a single HAL entry. Execution stops at the first failing transaction.
+     *
+     * @param [in]  context         Radio implementation parameters
+     * @param [in]  transactions    Array of transactions to execute
+     * @param [in]  nb_transactions Number of transactions in the array
+     * @param [out] nb_done         Number of transactions successfully executed. Can be NULL.
+     *
+     * @returns Operation status
+     */
+    lr11xx_hal_status_t lr11xx_hal_transfer_batch(const void *context, const lr11xx_hal_transaction_t *transactions,
+                                                  const uint8_t nb_transactions, uint8_t *nb_done);
+
+    /*!
+     * @brief Take exclusive access to a radio
+     *
+     * Every HAL entry point takes the lock of its radio for the duration of one transaction, so that tasks sharing a
+     * radio never interleave the command and response phases of a read. Hold it explicitly to make a sequence of
+     * transactions atomic; the lock is recursive.
+     *
+     * When several tasks wait, the radio goes to the highest priority task first. At equal priority, transactions of at
+     * most LR11XX_HAL_LOCK_SHORT_TRANSACTION_SIZE bytes are served first, then waiters are served in arrival order.
+     *
+     * Radios sharing an SPI bus keep separate locks; the HAL additionally holds a bus lock, with the same policy, while
+     * the NSS line of a radio is low.
+     *
+     * @remark Waiting tasks sleep on their LR11XX_HAL_NOTIFY_INDEX task notification. Before the scheduler starts the
+     * lock is a no-op. Must not be called from an interrupt.
+     *
+     * @param [in] context Radio implementation parameters
+     * @param [in] length  Command and data bytes of the transaction the lock is taken for, 0 if unknown
+     */
+    void lr11xx_hal_lock(const void *context, const uint16_t length);
+
+    /*!
+     * @brief Release a radio taken with @ref lr11xx_hal_lock
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_unlock(const void *context);
+
+    /*!
+     * @brief Start queuing writes
+     *
+     * Until @ref lr11xx_hal_batch_submit is called, @ref lr11xx_hal_write copies the command and data into an internal
+     * queue and returns immediately, so that the regular lr11xx_* driver calls can be grouped without modification.
+     * A read issued while the queue is open first flushes the pending writes, preserving the command order. The queue is
+     * also flushed when it is full.
+     *
+     * @remark The radio stays locked by the calling task until @ref lr11xx_hal_batch_submit.
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_batch_begin(const void *context);
+
+    /*!
+     * @brief Execute the queued writes and stop queuing
+     *
+     * @param [in] context Radio implementation parameters
+     *
+     * @returns Status of the first failing queued write, or of any implicit flush, @ref LR11XX_HAL_STATUS_OK otherwise
+     */
+    lr11xx_hal_status_t lr11xx_hal_batch_submit(const void *context);
+
+    /*!
+     * @brief Create the worker task and the request queue used by the asynchronous API
+     *
+     * Must be called once, after the FreeRTOS objects can be created, before any asynchronous request is submitted.
+     *
+     * @returns Operation status
+     */
+    lr11xx_hal_status_t lr11xx_hal_async_init(void);
+
+    /*!
+     * @brief Queue an asynchronous request
+     *
+     * The request is executed by the HAL worker task, in submission order, then its callback (if any) is called from
+     * the worker task. This function does not wait: it fails if the queue is full.
+     *
+     * @param [in] request Request to copy into the queue
+     *
+     * @returns Operation status
+     */
+    lr11xx_hal_status_t lr11xx_hal_async_submit(const lr11xx_hal_async_request_t *request);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_hal_write
+     *
+     * @param [in] context          Radio implementation parameters
+     * @param [in] command          Pointer to the buffer to be transmitted, copied at submission
+     * @param [in] command_length   Buffer size to be transmitted, at most LR11XX_HAL_ASYNC_CMD_LENGTH_MAX
+     * @param [in] data             Pointer to the buffer to be transmitted, must be valid until completion
+     * @param [in] data_length      Buffer size to be transmitted
+     * @param [in] callback         Completion callback. Can be NULL.
+     * @param [in] user_data        User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_hal_status_t lr11xx_hal_write_async(const void *context, const uint8_t *command,
+                                               const uint16_t command_length, const uint8_t *data,
+                                               const uint16_t data_length, lr11xx_hal_async_callback_t callback,
+                                               void *user_data);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_hal_read
+     *
+     * @param [in]  context          Radio implementation parameters
+     * @param [in]  command          Pointer to the buffer to be transmitted, copied at submission
+     * @param [in]  command_length   Buffer size to be transmitted, at most LR11XX_HAL_ASYNC_CMD_LENGTH_MAX
+     * @param [out] data             Pointer to the buffer to be received, must be valid until completion
+     * @param [in]  data_length      Buffer size to be received
+     * @param [in]  callback         Completion callback. Can be NULL.
+     * @param [in]  user_data        User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_hal_status_t lr11xx_hal_read_async(const void *context, const uint8_t *command,
+                                              const uint16_t command_length, uint8_t *data,
+                                              const uint16_t data_length, lr11xx_hal_async_callback_t callback,
+                                              void *user_data);
+
+    /*!
+     * @brief Enable or disable the CRC over SPI transport
+     *
+     * When enabled, a CRC byte is appended to every command and the CRC sent back by the radio at the end of every
+     * response is checked. A corrupted transaction is sent again, up to LR11XX_HAL_CRC_MAX_RETRIES times; the other
+     * transactions of the sequence are not replayed.
+     *
+     * @remark The radio side is configured with @ref lr11xx_system_enable_spi_crc, which calls this function. A reset
+     * of the radio disables the CRC transport.
+     *
+     * @param [in] context Radio implementation parameters
+     * @param [in] enable  true to enable the CRC transport
+     */
+    void lr11xx_hal_set_crc_mode(const void *context, const bool enable);
+
+    /*!
+     * @brief Read the CRC over SPI counters
+     *
+     * @param [in]  context Radio implementation parameters
+     * @param [out] stats   Counters since boot or since the last call to @ref lr11xx_hal_reset_stats
+     */
+    void lr11xx_hal_get_crc_stats(const void *context, lr11xx_hal_crc_stats_t *stats);
+
+    /*!
+     * @brief Read the transfer counters of a radio
+     *
+     * @param [in]  context Radio implementation parameters
+     * @param [out] stats   Counters since boot or since the last call to @ref lr11xx_hal_reset_stats
+     */
+    void lr11xx_hal_get_stats(const void *context, lr11xx_hal_stats_t *stats);
+
+    /*!
+     * @brief Clear the transfer counters of a radio, CRC counters included
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_reset_stats(const void *context);
+
+    /*!
+     * @brief Read the per-opcode counters of a radio
+     *
+     * @remark Always returns 0 unless LR11XX_HAL_INSTRUMENTATION is set to 1.
+     *
+     * @param [in]  context      Radio implementation parameters
+     * @param [out] stats        Array receiving the counters, in first-use order of the opcodes
+     * @param [in]  max_stats    Number of entries of the array
+     * @param [out] nb_untracked Transactions not recorded because the opcode table was full. Can be NULL.
+     *
+     * @returns Number of entries written
+     */
+    uint8_t lr11xx_hal_get_opcode_stats(const void *context, lr11xx_hal_opcode_stats_t *stats, const uint8_t max_stats,
+                                        uint32_t *nb_untracked);
+
+    /*!
+     * @brief Print the per-opcode counters of a radio, one line per opcode
+     *
+     * Prints a copy taken with lr11xx_hal_get_opcode_stats, in a static buffer: call it from one task at a time.
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_dump_opcode_stats(const void *context);
+
+    /*!
+     * @brief Clear the per-opcode counters of a radio
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_reset_opcode_stats(const void *context);
+
+    /*!
+     * @brief Start recording the transactions of a radio into a ring buffer
+     *
+     * Once the buffer is full, the oldest records are dropped to make room for new ones. The format of the records is
+     * described with LR11XX_HAL_CAPTURE_HEADER_SIZE.
+     *
+     * @remark Does nothing unless LR11XX_HAL_CAPTURE is set to 1.
+     *
+     * @param [in] context Radio implementation parameters
+     * @param [in] buffer  Ring buffer, must remain valid until @ref lr11xx_hal_capture_stop
+     * @param [in] size    Size of the ring buffer, at most 65535 bytes per record are recorded
+     */
+    void lr11xx_hal_capture_start(const void *context, uint8_t *buffer, const uint32_t size);
+
+    /*!
+     * @brief Stop recording the transactions of a radio, the records left in the buffer are dropped
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_capture_stop(const void *context);
+
+    /*!
+     * @brief Move the oldest records out of the capture buffer
+     *
+     * Only whole records are copied. Records read one after the other form a capture that can be given to
+     * @ref lr11xx_hal_replay_start.
+     *
+     * @param [in]  context    Radio implementation parameters
+     * @param [out] buffer     Buffer receiving the records
+     * @param [in]  max_length Size of the buffer
+     *
+     * @returns Number of bytes written
+     */
+    uint32_t lr11xx_hal_capture_read(const void *context, uint8_t *buffer, const uint32_t max_length);
+
+    /*!
+     * @brief Answer the transactions of a radio from a capture instead of the SPI bus
+     *
+     * Each transaction is checked against the next record: the type, the command bytes and the data written must
+     * match. The recorded data and status are then given back, without waiting. A transaction that does not match, or
+     * comes past the end of the capture, returns LR11XX_HAL_STATUS_ERROR.
+     *
+     * @remark Does nothing unless LR11XX_HAL_CAPTURE is set to 1. Recording is suspended while replaying.
+     *
+     * @param [in] context Radio implementation parameters
+     * @param [in] capture Records, must remain valid until @ref lr11xx_hal_replay_stop
+     * @param [in] length  Size of the capture
+     */
+    void lr11xx_hal_replay_start(const void *context, const uint8_t *capture, const uint32_t length);
+
+    /*!
+     * @brief Send the transactions of a radio to the SPI bus again
+     *
+     * @param [in] context Radio implementation parameters
+     */
+    void lr11xx_hal_replay_stop(const void *context);
+
+    /*!
+     * @brief Read the capture and replay counters of a radio
+     *
+     * @param [in]  context Radio implementation parameters
+     * @param [out] stats   Counters since the capture or the replay was started
+     */
+    void lr11xx_hal_get_capture_stats(const void *context, lr11xx_hal_capture_stats_t *stats);
+
+    /*!
+     * @brief Lookup table of the polynomial 0x65 CRC, one entry per byte value
+     */
+    extern const uint8_t lr11xx_hal_crc_table[256];
+
     /*!
      * @brief Return the computed CRC
      *
@@ -172,21 +833,7 @@ extern "C"
 
         for (uint16_t i = 0; i < length; i++)
         {
-            uint8_t extract = buffer[i];
-            uint8_t sum;
-
-            for (uint8_t j = 8; j > 0; j--)
-            {
-                sum = (crc ^ extract) & 0x01;
-                crc >>= 1;
-
-                if (sum != 0)
-                {
-                    crc ^= 0x65;
-                }
-
-                extract >>= 1;
-            }
+            crc = lr11xx_hal_crc_table[crc ^ buffer[i]];
         }
 
         return crc;
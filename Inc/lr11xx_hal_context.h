@@ -0,0 +1,217 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      lr11xx_hal_context.h
+ *
+ * @brief     Radio context of the HTNB32L implementation of the LR11XX HAL
+ */
+
+#ifndef LR11XX_HAL_CONTEXT_H
+#define LR11XX_HAL_CONTEXT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#if defined(LR11XX_SIM)
+#include "LR1110_Driver/lr11xx_sim.h"
+#else
+#include "HT_GPIO_Api.h"
+#endif
+#include "LR1110_Driver/lr11xx_hal.h"
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC MACROS -----------------------------------------------------------
+     */
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC CONSTANTS --------------------------------------------------------
+     */
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC TYPES ------------------------------------------------------------
+     */
+
+    /*!
+     * @brief Full-duplex SPI transfer of the bus a radio is connected to
+     *
+     * Must block until the transfer is over. Both buffers hold length bytes; tx_buffer and rx_buffer may be the same.
+     */
+    typedef void (*lr11xx_hal_spi_transfer_t)(uint8_t *tx_buffer, uint8_t *rx_buffer, uint16_t length);
+
+    /*!
+     * @brief GPIO line of a radio
+     */
+    typedef struct lr11xx_hal_gpio_s
+    {
+        GPIO_TypeDef *instance;
+        uint16_t pin;
+    } lr11xx_hal_gpio_t;
+
+    /*!
+     * @brief Write queue of an open batch
+     */
+    typedef struct lr11xx_hal_batch_s
+    {
+        bool is_open;
+        lr11xx_hal_status_t status;
+        uint8_t nb_transactions;
+        uint16_t buffer_used;
+        lr11xx_hal_transaction_t transactions[LR11XX_HAL_BATCH_MAX_TRANSACTIONS];
+        uint8_t buffer[LR11XX_HAL_BATCH_BUFFER_SIZE];
+    } lr11xx_hal_batch_t;
+
+    /*!
+     * @brief Task waiting for a radio
+     */
+    typedef struct lr11xx_hal_lock_waiter_s
+    {
+        void *task;        //!< FreeRTOS task handle
+        uint32_t priority; //!< Task priority when it started waiting
+        bool is_short;     //!< Waiting for a transaction of at most LR11XX_HAL_LOCK_SHORT_TRANSACTION_SIZE bytes
+        uint32_t ticket;   //!< Arrival order
+    } lr11xx_hal_lock_waiter_t;
+
+    /*!
+     * @brief Recursive lock of a radio, handed over to the waiters by priority
+     */
+    typedef struct lr11xx_hal_lock_s
+    {
+        void *volatile owner; //!< FreeRTOS task holding the radio, NULL if free
+        uint16_t depth;
+        uint8_t nb_waiters;
+        uint32_t next_ticket;
+        lr11xx_hal_lock_waiter_t waiters[LR11XX_HAL_LOCK_MAX_WAITERS];
+    } lr11xx_hal_lock_t;
+
+    /*!
+     * @brief Per-opcode counters of a radio
+     */
+    typedef struct lr11xx_hal_instr_s
+    {
+        uint8_t nb_opcodes;
+        uint32_t nb_untracked;
+        uint32_t busy_wait_us; //!< Running total of BUSY wait, sampled around each transaction
+        lr11xx_hal_opcode_stats_t opcodes[LR11XX_HAL_INSTR_MAX_OPCODES];
+    } lr11xx_hal_instr_t;
+
+    /*!
+     * @brief Capture ring buffer and replayed capture of a radio
+     */
+    typedef struct lr11xx_hal_capture_s
+    {
+        uint8_t *buffer; //!< NULL when not recording
+        uint32_t size;
+        uint32_t head; //!< Where the next record is written
+        uint32_t tail; //!< Oldest record
+        uint32_t used;
+        const uint8_t *replay; //!< NULL when not replaying
+        uint32_t replay_length;
+        uint32_t replay_offset;
+        bool is_record_open;       //!< A record is being written, see lr11xx_hal_capture_open
+        uint32_t record_start;     //!< Header of the record being written
+        uint32_t record_data_head; //!< Where the data of the record being written starts
+        uint32_t record_data_used; //!< Ring usage when the data of the record being written starts
+        uint16_t record_data_left; //!< Data bytes of the record being written still to come
+        uint16_t record_data_length;
+        lr11xx_hal_capture_stats_t stats;
+    } lr11xx_hal_capture_t;
+
+    /*!
+     * @brief Run-time state of a radio, owned by the HAL
+     */
+    typedef struct lr11xx_hal_state_s
+    {
+        uint32_t busy_timeout_ms;
+        void *volatile busy_waiting_task; //!< FreeRTOS task blocked on the BUSY falling edge, NULL if none
+        void *volatile irq_waiting_task;  //!< FreeRTOS task blocked on the IRQ DIO, NULL if none
+        volatile bool is_irq_pending;     //!< IRQ DIO edge received and not yet consumed by lr11xx_hal_wait_irq
+        bool is_crc_enabled;
+        lr11xx_hal_batch_t batch;
+        lr11xx_hal_lock_t lock;
+        lr11xx_hal_lock_t *bus_lock; //!< Lock of the SPI bus, shared by all the radios connected to it, never NULL
+        lr11xx_hal_stats_t stats;
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+        lr11xx_hal_instr_t instr;
+#endif
+#if (LR11XX_HAL_CAPTURE == 1)
+        lr11xx_hal_capture_t capture;
+#endif
+    } lr11xx_hal_state_t;
+
+    /*!
+     * @brief Radio context given as context parameter to every lr11xx_* call
+     *
+     * One context is needed per LR11XX connected to the MCU. A NULL context selects the default radio, wired as
+     * described by the GPIO_*_LR1110_* board macros on the default SPI bus.
+     *
+     * A context must be initialized with lr11xx_hal_context_init before its first use: the HAL does not resolve the
+     * fields of a hand-filled or zero-initialized context.
+     */
+    typedef struct lr11xx_hal_context_s
+    {
+        lr11xx_hal_spi_transfer_t spi_transfer; //!< SPI bus of the radio, never NULL once initialized
+        lr11xx_hal_gpio_t nss;
+        lr11xx_hal_gpio_t busy;
+        lr11xx_hal_gpio_t nreset;
+        lr11xx_hal_state_t state;
+    } lr11xx_hal_context_t;
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+     */
+
+    /*!
+     * @brief Initialize a radio context
+     *
+     * The GPIOs must already be configured by the board: NSS and NRESET as outputs driven high, BUSY as input.
+     *
+     * Radios given the same spi_transfer share one SPI bus, with one NSS line each: their transfers are serialized.
+     *
+     * @param [out] radio        Context to initialize
+     * @param [in]  spi_transfer SPI bus of the radio, NULL for the default SPI bus
+     * @param [in]  nss          Chip select line
+     * @param [in]  busy         BUSY line
+     * @param [in]  nreset       Reset line
+     *
+     * @returns LR11XX_HAL_STATUS_ERROR if the radio is on a new bus and LR11XX_HAL_MAX_SPI_BUSES buses are already
+     * in use, in which case the context must not be used
+     */
+    lr11xx_hal_status_t lr11xx_hal_context_init(lr11xx_hal_context_t *radio, lr11xx_hal_spi_transfer_t spi_transfer,
+                                                const lr11xx_hal_gpio_t nss, const lr11xx_hal_gpio_t busy,
+                                                const lr11xx_hal_gpio_t nreset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LR11XX_HAL_CONTEXT_H
+
+/* --- EOF ------------------------------------------------------------------ */
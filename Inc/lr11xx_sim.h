@@ -0,0 +1,272 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      lr11xx_sim.h
+ *
+ * @brief     Host simulator of the LR11XX radio and of the HTNB32L board primitives used by the driver
+ */
+
+
+/*
+ * Host build
+ * ----------
+ * Defining LR11XX_SIM replaces the HTNB32L SDK headers used by the driver (GPIO, SPI, bsp) with this file, and
+ * lr11xx_sim.c provides the corresponding functions on top of a software model of the LR1110. The regular HAL,
+ * driver and application sources then run unchanged on a Linux box:
+ *
+ *   ln -s Inc LR1110_Driver
+ *   gcc -DLR11XX_SIM -I. -I<FreeRTOS-Kernel>/include -I<FreeRTOS-Kernel>/portable/ThirdParty/GCC/Posix \
+ *       -I<dir of FreeRTOSConfig.h> <all Src .c files> <FreeRTOS-Kernel sources> <FreeRTOS POSIX port> main.c -lpthread
+ *
+ * FreeRTOS itself runs on its POSIX port. The scenarios are best run from a task: lr11xx_update_firmware calls
+ * vTaskDelay, and the HAL lock only arbitrates once the scheduler is running. FreeRTOSConfig.h must set
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES above LR11XX_HAL_NOTIFY_INDEX, as on the target.
+ *
+ * Timing is virtual: SPI transfers, delay_us and command processing advance a microsecond clock read with
+ * lr11xx_sim_get_time_us. Reading BUSY while the model is busy jumps the clock to the end of the operation, so a
+ * scan that lasts seconds on the chip completes instantly and deterministically on the host.
+ *
+ * A single radio is modelled, on the default pins. The SPI bus of every context reaches it, so contexts
+ * with other pins must not be used.
+ */
+
+#ifndef LR11XX_SIM_H
+#define LR11XX_SIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/**
+ * @brief Maximum number of access points of the synthetic Wi-Fi environment
+ */
+#ifndef LR11XX_SIM_MAX_ACCESS_POINTS
+#define LR11XX_SIM_MAX_ACCESS_POINTS (64)
+#endif
+
+/**
+ * @brief Instrumentation timestamps follow the virtual clock
+ */
+#define LR11XX_HAL_INSTR_TIMESTAMP_US() ((uint32_t)lr11xx_sim_get_time_us())
+
+/*
+ * Board definitions normally provided by the HTNB32L SDK
+ */
+#define TRUE (1)
+#define FALSE (0)
+
+#define PRINT_LOGS(level, ...) printf(__VA_ARGS__)
+
+#define LR11XX_SIM_GPIO (&lr11xx_sim_gpio_port)
+
+#define GPIO_NSS_LR1110_PIN (0)
+#define GPIO_NSS_LR1110_INSTANCE LR11XX_SIM_GPIO
+#define GPIO_BUSY_LR1110_PIN (1)
+#define GPIO_BUSY_LR1110_INSTANCE LR11XX_SIM_GPIO
+#define GPIO_BUSY_LR1110_ALT_FUNC (0)
+#define GPIO_BUSY_LR1110_PAD_ID (0)
+#define GPIO_NRESET_LR1110_PIN (2)
+#define GPIO_NRESET_LR1110_INSTANCE LR11XX_SIM_GPIO
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC TYPES ------------------------------------------------------------
+     */
+
+    typedef struct
+    {
+        uint32_t id;
+    } GPIO_TypeDef;
+
+    typedef enum
+    {
+        PIN_OFF = 0,
+        PIN_ON = 1,
+    } GPIO_PinState;
+
+    typedef enum
+    {
+        GPIO_DirectionInput = 0,
+        GPIO_DirectionOutput = 1,
+    } GPIO_PinDirection;
+
+    typedef enum
+    {
+        PAD_AutoPull = 0,
+        PAD_InternalPullUp = 1,
+        PAD_InternalPullDown = 2,
+    } PAD_PullType;
+
+    typedef enum
+    {
+        GPIO_EXTI_DISABLED = 0,
+        GPIO_EXTI_EDGE_RISING = 1,
+        GPIO_EXTI_EDGE_FALLING = 2,
+    } GPIO_ExtiType;
+
+    typedef struct
+    {
+        uint32_t af;
+        uint32_t pad_id;
+        uint16_t gpio_pin;
+        GPIO_PinDirection pin_direction;
+        uint8_t init_output;
+        PAD_PullType pull;
+        GPIO_TypeDef *instance;
+        GPIO_ExtiType exti;
+    } GPIO_InitType;
+
+    /*!
+     * @brief Timing and identity of the modelled radio
+     */
+    typedef struct lr11xx_sim_config_s
+    {
+        uint32_t spi_bitrate_hz;        //!< Sets the time taken by each SPI transfer
+        uint32_t command_processing_us; //!< BUSY time after any command
+        uint32_t boot_us;               //!< BUSY time after a reset or a reboot
+        uint32_t calibration_us;        //!< BUSY time of a calibration
+        uint32_t flash_erase_us;        //!< BUSY time of a flash erase
+        uint32_t flash_write_us;        //!< BUSY time of one flash write command
+        uint32_t wifi_empty_channel_us; //!< Time spent on a channel without any access point, per scan
+        uint32_t wifi_demodulation_us;  //!< Time spent demodulating one beacon
+        uint8_t rssi_jitter_db;         //!< Maximum deviation of the reported RSSI from the access point RSSI
+        uint32_t seed;                  //!< Seed of the RSSI and detection pseudo-random generator
+        uint8_t hw_version;
+        uint16_t fw_version;            //!< Transceiver firmware version before any update
+        uint16_t fw_version_after_update;
+        uint16_t bootloader_version;
+    } lr11xx_sim_config_t;
+
+    /*!
+     * @brief Access point of the synthetic Wi-Fi environment
+     */
+    typedef struct lr11xx_sim_access_point_s
+    {
+        uint8_t mac_address[6];
+        uint8_t channel;           //!< 1 to 14
+        uint8_t signal_type;       //!< lr11xx_wifi_signal_type_result_t
+        int8_t rssi_dbm;           //!< Mean RSSI
+        uint8_t detection_percent; //!< Probability for the access point to be seen by a scan
+        uint16_t beacon_period_tu;
+        char ssid[32];
+        char country_code[2];      //!< Found by the country code search, {0, 0} if the beacons do not carry it
+    } lr11xx_sim_access_point_t;
+
+    /*!
+     * @brief Model counters
+     */
+    typedef struct lr11xx_sim_stats_s
+    {
+        uint32_t nb_commands;
+        uint32_t nb_unmodelled_commands; //!< Accepted and answered with zeros
+        uint32_t nb_crc_errors;          //!< Commands rejected because of a wrong CRC
+        uint32_t nb_scans;
+    } lr11xx_sim_stats_t;
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC VARIABLES --------------------------------------------------------
+     */
+
+    extern GPIO_TypeDef lr11xx_sim_gpio_port;
+
+    /*
+     * -----------------------------------------------------------------------------
+     * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+     */
+
+    /*!
+     * @brief Power the modelled radio on, in transceiver mode, at virtual time 0
+     *
+     * @param [in] config Timing and identity of the radio, NULL for the defaults of lr11xx_sim_get_default_config
+     */
+    void lr11xx_sim_init(const lr11xx_sim_config_t *config);
+
+    /*!
+     * @brief Get the default configuration: 8 MHz SPI, LR1110 transceiver firmware 0x0308
+     *
+     * @param [out] config Configuration to fill
+     */
+    void lr11xx_sim_get_default_config(lr11xx_sim_config_t *config);
+
+    /*!
+     * @brief Add an access point to the synthetic Wi-Fi environment
+     *
+     * @param [in] access_point Access point to copy
+     *
+     * @returns false if the environment is full
+     */
+    bool lr11xx_sim_add_access_point(const lr11xx_sim_access_point_t *access_point);
+
+    /*!
+     * @brief Remove all access points of the synthetic Wi-Fi environment
+     */
+    void lr11xx_sim_clear_access_points(void);
+
+    /*!
+     * @brief Read the virtual clock
+     *
+     * @returns Microseconds since lr11xx_sim_init
+     */
+    uint64_t lr11xx_sim_get_time_us(void);
+
+    /*!
+     * @brief Move the virtual clock forward, e.g. to model application processing
+     *
+     * @param [in] duration_us Time to add
+     */
+    void lr11xx_sim_advance_time_us(const uint32_t duration_us);
+
+    /*!
+     * @brief Read the model counters
+     *
+     * @param [out] stats Counters since lr11xx_sim_init
+     */
+    void lr11xx_sim_get_stats(lr11xx_sim_stats_t *stats);
+
+    /*
+     * HTNB32L SDK primitives implemented by the simulator
+     */
+    void HT_GPIO_Init(GPIO_InitType *gpio);
+    void HT_GPIO_WritePin(uint16_t pin, GPIO_TypeDef *instance, uint16_t value);
+    uint16_t HT_GPIO_PinRead(GPIO_TypeDef *instance, uint16_t pin);
+    void HT_SPI_TransmitReceive(uint8_t *tx_buffer, uint8_t *rx_buffer, uint16_t length);
+    void delay_us(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LR11XX_SIM_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -49,6 +49,7 @@ extern "C"
 // #include "lr11xx_types.h"
 #include "LR1110_Driver/lr11xx_system_types.h"
 #include "LR1110_Driver/lr11xx_types.h"
+#include "LR1110_Driver/lr11xx_hal.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -308,6 +309,23 @@ extern "C"
      */
     lr11xx_status_t lr11xx_system_get_and_clear_irq_status(const void *context, lr11xx_system_irq_mask_t *irq);
 
+    /**
+     * @brief Asynchronous version of @ref lr11xx_system_get_and_clear_irq_status
+     *
+     * The request is executed by the HAL worker task, see @ref lr11xx_hal_async_submit.
+     *
+     * @param [in] context Chip implementation context.
+     * @param [out] irq Pointer to a variable for holding the system interrupt status, valid when the callback is called.
+     * Can be NULL.
+     * @param [in] callback Completion callback. Can be NULL.
+     * @param [in] user_data User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_status_t lr11xx_system_get_and_clear_irq_status_async(const void *context, lr11xx_system_irq_mask_t *irq,
+                                                                 lr11xx_hal_async_callback_t callback,
+                                                                 void *user_data);
+
     /*!
      * @brief Defines which clock is used as Low Frequency (LF) clock
      *
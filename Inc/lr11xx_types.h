@@ -64,6 +64,7 @@ typedef enum lr11xx_status_e
 {
     LR11XX_STATUS_OK = 0,
     LR11XX_STATUS_ERROR = 3,
+    LR11XX_STATUS_TIMEOUT = 4,
 } lr11xx_status_t;
 
 /*
@@ -53,6 +53,7 @@ extern "C"
 #include "LR1110_Driver/lr11xx_wifi_types.h"
 #include "LR1110_Driver/lr11xx_types.h"
 #include "LR1110_Driver/lr11xx_system_types.h"
+#include "LR1110_Driver/lr11xx_hal.h"
 
     /*
      * -----------------------------------------------------------------------------
@@ -410,6 +411,95 @@ extern "C"
                                                            const uint8_t nb_results,
                                                            lr11xx_wifi_extended_full_result_t *results);
 
+    /*!
+     * @brief Read all the Wi-Fi passive scan results available, in the requested format
+     *
+     * The number of available results is read from the LR11XX, then the results are fetched by chunks of the largest
+     * size the driver supports instead of one SPI transaction per result.
+     *
+     * @param [in] context Chip implementation context
+     * @param [in] result_format Format of the results, selects the structure type of the results array
+     * @param [out] results Array of lr11xx_wifi_basic_complete_result_t, lr11xx_wifi_basic_mac_type_channel_result_t or
+     * lr11xx_wifi_extended_full_result_t depending on result_format, holding at least max_results elements
+     * @param [in] max_results Capacity of the results array
+     * @param [out] nb_results Number of results written to the results array
+     *
+     * @returns Operation status
+     *
+     * @see lr11xx_wifi_get_nb_results, lr11xx_wifi_get_nb_results_max_per_chunk
+     */
+    lr11xx_status_t lr11xx_wifi_fetch_all_results(const void *context, const lr11xx_wifi_result_format_t result_format,
+                                                  void *results, const uint8_t max_results, uint8_t *nb_results);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_wifi_get_nb_results
+     *
+     * The request is executed by the HAL worker task, see @ref lr11xx_hal_async_submit.
+     *
+     * @param [in] context Chip implementation context
+     * @param [out] nb_results The number of results available in the LR11XX, valid when the callback is called
+     * @param [in] callback Completion callback. Can be NULL.
+     * @param [in] user_data User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_status_t lr11xx_wifi_get_nb_results_async(const void *context, uint8_t *nb_results,
+                                                     lr11xx_hal_async_callback_t callback, void *user_data);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_wifi_read_basic_complete_results
+     *
+     * @param [in] context Chip implementation context
+     * @param [in] start_result_index Result index from which starting to fetch the results
+     * @param [in] nb_results Number of results to fetch
+     * @param [out] results Array of at least nb_results elements, valid when the callback is called
+     * @param [in] callback Completion callback. Can be NULL.
+     * @param [in] user_data User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_status_t lr11xx_wifi_read_basic_complete_results_async(const void *context,
+                                                                  const uint8_t start_result_index,
+                                                                  const uint8_t nb_results,
+                                                                  lr11xx_wifi_basic_complete_result_t *results,
+                                                                  lr11xx_hal_async_callback_t callback,
+                                                                  void *user_data);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_wifi_read_basic_mac_type_channel_results
+     *
+     * @param [in] context Chip implementation context
+     * @param [in] start_result_index Result index from which starting to fetch the results
+     * @param [in] nb_results Number of results to fetch
+     * @param [out] results Array of at least nb_results elements, valid when the callback is called
+     * @param [in] callback Completion callback. Can be NULL.
+     * @param [in] user_data User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_status_t lr11xx_wifi_read_basic_mac_type_channel_results_async(
+        const void *context, const uint8_t start_result_index, const uint8_t nb_results,
+        lr11xx_wifi_basic_mac_type_channel_result_t *results, lr11xx_hal_async_callback_t callback, void *user_data);
+
+    /*!
+     * @brief Asynchronous version of @ref lr11xx_wifi_read_extended_full_results
+     *
+     * @param [in] context Chip implementation context
+     * @param [in] start_result_index Result index from which starting to fetch the results
+     * @param [in] nb_results Number of results to fetch
+     * @param [out] results Array of at least nb_results elements, valid when the callback is called
+     * @param [in] callback Completion callback. Can be NULL.
+     * @param [in] user_data User pointer given back to the callback
+     *
+     * @returns Submission status
+     */
+    lr11xx_status_t lr11xx_wifi_read_extended_full_results_async(const void *context,
+                                                                 const uint8_t start_result_index,
+                                                                 const uint8_t nb_results,
+                                                                 lr11xx_wifi_extended_full_result_t *results,
+                                                                 lr11xx_hal_async_callback_t callback,
+                                                                 void *user_data);
+
     /*!
      * @brief Reset the internal counters of cumulative timing
      *
@@ -617,6 +707,8 @@ extern "C"
     /**
      * @brief Compute the power consumption in uAh based on the cumulative timing.
      *
+     * Rounded to the nearest uAh, see @ref lr11xx_energy_get_wifi_charge_nah for the model.
+     *
      * @param [in] regulator The regulator used during last Wi-Fi passive scan
      * @param [in] timing  Cumulative timing structure to use for computation
      *
@@ -624,6 +716,19 @@ extern "C"
      */
     uint64_t lr11xx_wifi_get_consumption(lr11xx_system_reg_mode_t regulator, lr11xx_wifi_cumulative_timings_t timing);
 
+    /**
+     * @brief Compute the charge in nAh used by the Wi-Fi scans based on the cumulative timing.
+     *
+     * Same model as @ref lr11xx_wifi_get_consumption with a resolution fine enough for a single short scan.
+     *
+     * @param [in] regulator The regulator used during last Wi-Fi passive scan
+     * @param [in] timing  Cumulative timing structure to use for computation
+     *
+     * @returns Charge in nAh
+     */
+    uint32_t lr11xx_wifi_get_consumption_nah(lr11xx_system_reg_mode_t regulator,
+                                             const lr11xx_wifi_cumulative_timings_t *timing);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,8 @@
  limitations under the License.
 
 */
+#include <stdlib.h>
+#include <string.h>
 #include "LR1110_Driver/HE_LR1110_Api.h"
 #include "LR1110_Driver/lr11xx_hal.h"
 #include "LR1110_Driver/lr11xx_wifi.h"
@@ -22,6 +24,11 @@
 #include "LR1110_Driver/lr11xx_crypto_engine.h"
 #include "LR1110_Driver/lr11xx_system.h"
 #include "LR1110_Driver/wifi.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Regulador configurado por LR1110_Configure, usado também na estimativa da carga dos scans
+#define LR1110_REG_MODE LR11XX_SYSTEM_REG_MODE_LDO
 
 lr11xx_system_rfswitch_cfg_t smtc_shield_lr11xx_common_rf_switch_cfg = {
     .enable = LR11XX_SYSTEM_RFSW0_HIGH | LR11XX_SYSTEM_RFSW1_HIGH,
@@ -34,99 +41,2120 @@ lr11xx_system_rfswitch_cfg_t smtc_shield_lr11xx_common_rf_switch_cfg = {
     .wifi = 0,
 };
 
-uint8_t wifi_information_package[74];
+static uint32_t number_of_scan = 0;
+
+// Redes encontradas pela última leitura do LR1110 padrão da placa, as leituras dos outros rádios não o alteram
+uint8_t nb_results = 0;
+
+// Configuração comum a todos os rádios, definida antes das leituras e só lida por elas
+
+// Número de redes mais fortes informadas por HE_NetworkReading, ver HE_SetNetworksToReport
+static uint8_t networks_to_report = NETWORKS_NUMBER;
+
+// Pipeline padrão: descarta MACs administrados localmente e o OUI 00:00:5E reservado pela IANA
+static const uint8_t default_denied_ouis[][3] = {{0x00, 0x00, 0x5e}};
+static const LR1110_filter_stage_t default_filter_stages[] = {
+    {.type = LR1110_FILTER_LOCALLY_ADMINISTERED},
+    {.type = LR1110_FILTER_OUI_DENY, .oui = {.ouis = default_denied_ouis, .nb_ouis = 1}},
+};
+static const LR1110_filter_pipeline_t default_filter_pipeline = {
+    .stages = default_filter_stages,
+    .nb_stages = sizeof(default_filter_stages) / sizeof(default_filter_stages[0]),
+};
+
+// Pipeline de filtros aplicado por HE_NetworkReading, ver HE_SetFilterPipeline
+static const LR1110_filter_pipeline_t *filter_pipeline = &default_filter_pipeline;
+
+// Estado que HE_NetworkReadingOnRadio mantém entre as leituras de um rádio, indexado pelo contexto
+typedef struct
+{
+    bool is_used;
+    const void *context;                         //!< Contexto do rádio, NULL para o LR1110 padrão da placa
+    LR1110_ap_cache_t *ap_cache;                 //!< NULL se desativado, ver HE_SetApCache
+    LR1110_channel_planner_t *channel_planner;   //!< NULL para varrer todos os canais, ver HE_SetChannelPlanner
+    LR1110_energy_scheduler_t *energy_scheduler; //!< NULL para o perfil padrão, ver HE_SetEnergyScheduler
+    LR1110_timeout_tuner_t *timeout_tuner;       //!< NULL para o scan por número de varreduras, ver HE_SetTimeoutTuner
+} LR1110_radio_state_t;
+
+static LR1110_radio_state_t radio_states[LR1110_MAX_RADIOS];
+
+// Estado dos rádios sem entrada na tabela: nada associado
+static const LR1110_radio_state_t empty_radio_state = {0};
+
+// Perfis do agendador de energia, do mais completo ao mais econômico
+static const LR1110_scan_profile_t scan_profiles[LR1110_ENERGY_NB_PROFILES] = {
+    {LR11XX_WIFI_SCAN_MODE_BEACON_AND_PKT, LR1110_WIFI_ALL_CHANNELS_MASK, LR11XX_WIFI_MAX_RESULTS},
+    {LR11XX_WIFI_SCAN_MODE_BEACON, LR1110_WIFI_ALL_CHANNELS_MASK, LR11XX_WIFI_MAX_RESULTS},
+    {LR11XX_WIFI_SCAN_MODE_BEACON, LR1110_WIFI_ALL_CHANNELS_MASK, 8},
+    {LR11XX_WIFI_SCAN_MODE_BEACON, LR1110_WIFI_NON_OVERLAPPING_CHANNELS_MASK, 4},
+};
+
+// Último código de país detectado ou restaurado, {0, 0} se desconhecido, e os canais permitidos nele. O país é do
+// dispositivo, comum a todos os rádios, e os dois mudam juntos em HE_SetCountryCode
+static uint8_t country_code[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE] = {0, 0};
+static uint16_t regulatory_channel_mask = LR1110_WIFI_ALL_CHANNELS_MASK;
+static LR1110_country_code_save_t country_code_save = NULL;
+
+// Países onde só os canais 1 a 11 são permitidos
+static const uint8_t channels_1_to_11_countries[][LR11XX_WIFI_STR_COUNTRY_CODE_SIZE] = {
+    {'U', 'S'}, {'C', 'A'}, {'T', 'W'}, {'P', 'R'}, {'G', 'U'}, {'A', 'S'}, {'V', 'I'}, {'M', 'P'}, {'U', 'M'},
+};
+
+void LR1110_Fill_Empty_Networks(LR1110ResponseNetworksToDevice_t *receive_data);
+static uint8_t LR1110_Select_Strongest(const lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                                       const uint8_t nb_scan_results, uint8_t *selected, const uint8_t max_selected);
+static LR1110_radio_state_t *LR1110_Radio_State(const void *context, const bool create);
+static LR1110_filter_candidate_t LR1110_Filter_Candidate(const lr11xx_wifi_basic_mac_type_channel_result_t *result);
+static uint8_t LR1110_Scan_Channels(const void *context, const LR1110_scan_profile_t *profile,
+                                    const LR1110_timeout_tuner_t *tuner, const uint16_t channel_mask,
+                                    const uint8_t nb_results, lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                                    uint8_t *nb_scan_results);
+bool LR1110_Read_Version_Status(const void *context);
+bool LR1110_Configure(const void *context);
+bool can_execute_next_scan(void);
+void call_scan(const void *context);
+void start_scan(void);
+
+LR1110ResponseNetworksToDevice_t HE_NetworkReading(void)
+{
+    return HE_NetworkReadingOnRadio(NULL);
+}
+
+/**
+ * Executa a leitura das redes Wi-Fi com o LR1110 indicado.
+ *
+ * Cada rádio guarda o seu estado entre as leituras (cache de redes, planejador de canais, agendador de energia e
+ * ajuste de timeouts, ver HE_SetApCache) e pode ser lido por uma task diferente da dos outros rádios. As leituras de um
+ * mesmo rádio, e as mudanças do seu estado, devem ser feitas por uma task de cada vez. O país e a configuração das
+ * redes informadas (HE_SetNetworksToReport, HE_SetFilterPipeline) são comuns a todos os rádios.
+ *
+ * @param context Contexto do rádio (lr11xx_hal_context_t), NULL para o LR1110 padrão da placa.
+ */
+LR1110ResponseNetworksToDevice_t HE_NetworkReadingOnRadio(const void *context)
+{
+    const LR1110_radio_state_t *radio = LR1110_Radio_State(context, false);
+
+    if (radio == NULL)
+    {
+        radio = &empty_radio_state;
+    }
+
+    LR1110ResponseNetworksToDevice_t receive_data = LR1110RESPONSENETWORKSTODEVICE_T_INITIALIZER;
+
+    LR1110ResponseNetworksToDevice_t receive_data_error = LR1110RESPONSENETWORKSTODEVICE_T_ERROR;
+
+    lr11xx_hal_reset(context);
+
+    // delay_us(500000); // não remover
+    // delay_us(100000); // não remover
+
+    // delay_us(100000); // não remover
+
+    if (LR1110_Read_Version_Status(context) == FALSE)
+    {
+        PRINT_LOGS('E', "ERROR_LR1110: Check SPI Communication!\n");
+        receive_data_error.lr1110_error = LR1110_SPI_COMMUNICATION_ERROR;
+        return receive_data_error;
+    }
+
+    // delay_us(1000000); // não remover
+    // delay_us(100000); // não remover
+
+    if (LR1110_Configure(context) == FALSE)
+    {
+        printf("ERROR_LR1110: Check crystal oscillator!\n");
+        receive_data_error.lr1110_error = LR1110_CONFIGURATION_ERROR;
+        return receive_data_error;
+    }
+
+    lr11xx_wifi_basic_mac_type_channel_result_t results[LR11XX_WIFI_MAX_RESULTS];
+    uint8_t nb_scan_results = 0;
+    const LR1110_scan_profile_t *profile = &scan_profiles[LR1110_ENERGY_DEFAULT_PROFILE];
+
+    if (radio->energy_scheduler != NULL)
+    {
+        profile = HE_EnergySchedulerProfile(radio->energy_scheduler);
+    }
+
+    if ((radio->energy_scheduler != NULL) || (radio->timeout_tuner != NULL))
+    {
+        lr11xx_wifi_reset_cumulative_timing(context);
+    }
+
+    // Canais do perfil que podem ter redes no país atual, lido uma vez caso outro rádio o mude durante a leitura
+    const uint16_t regulatory_mask = HE_GetRegulatoryChannelMask();
+    const uint16_t allowed_mask = ((profile->channel_mask & regulatory_mask) != 0)
+                                      ? (profile->channel_mask & regulatory_mask)
+                                      : profile->channel_mask;
+    uint16_t channel_mask = allowed_mask;
+
+    if ((radio->channel_planner != NULL) && ((HE_ChannelPlannerMask(radio->channel_planner) & allowed_mask) != 0))
+    {
+        channel_mask = HE_ChannelPlannerMask(radio->channel_planner) & allowed_mask;
+    }
+
+    uint8_t scan_status =
+        LR1110_Scan_Channels(context, profile, radio->timeout_tuner, channel_mask, 0, results, &nb_scan_results);
+
+    if ((scan_status == LR1110_SUCCESS) && (radio->channel_planner != NULL) &&
+        (nb_scan_results < radio->channel_planner->min_networks) && (channel_mask != allowed_mask))
+    {
+        // Poucas redes nos canais planejados: amplia o scan para os canais restantes
+        scan_status = LR1110_Scan_Channels(context, profile, radio->timeout_tuner, allowed_mask & ~channel_mask,
+                                           nb_scan_results, results, &nb_scan_results);
+        channel_mask = allowed_mask;
+    }
+    if (context == NULL)
+    {
+        nb_results = nb_scan_results;
+    }
+
+    if ((radio->energy_scheduler != NULL) || (radio->timeout_tuner != NULL))
+    {
+        // Contabilizado mesmo se o scan falhou, a energia e o tempo foram gastos
+        lr11xx_wifi_cumulative_timings_t timings = {0};
+
+        if (lr11xx_wifi_read_cumulative_timing(context, &timings) == LR11XX_STATUS_OK)
+        {
+            if (radio->energy_scheduler != NULL)
+            {
+                HE_EnergySchedulerRecordScan(radio->energy_scheduler, &timings,
+                                             xTaskGetTickCount() * portTICK_PERIOD_MS);
+            }
+
+            if (radio->timeout_tuner != NULL)
+            {
+                uint8_t nb_channels = 0;
+
+                for (uint16_t mask = channel_mask; mask != 0; mask &= mask - 1)
+                {
+                    nb_channels++;
+                }
+                HE_TimeoutTunerUpdate(radio->timeout_tuner, &timings, nb_channels, nb_scan_results);
+            }
+        }
+    }
+
+    if (scan_status != LR1110_SUCCESS)
+    {
+        printf("ERROR_LR1110: Wi-Fi scan did not complete!\n");
+        receive_data_error.lr1110_error = scan_status;
+        return receive_data_error;
+    }
+
+    if (radio->channel_planner != NULL)
+    {
+        HE_ChannelPlannerUpdate(radio->channel_planner, channel_mask, results, nb_scan_results);
+    }
+
+    if (radio->ap_cache != NULL)
+    {
+        // Atualizado mesmo sem redes encontradas, para que as redes que sumiram sejam informadas
+        HE_ApCacheUpdate(radio->ap_cache, results, nb_scan_results, xTaskGetTickCount() * portTICK_PERIOD_MS, NULL, 0);
+    }
+
+    printf("Number of Wi-Fi networks found before filtering: %d\n", nb_scan_results);
+    if (nb_scan_results == 0)
+    {
+        printf("ERROR_LR1110: No Wi-Fi found!\n");
+        receive_data_error.lr1110_error = LR1110_NO_WIFI_FOUND;
+        return receive_data_error;
+    }
+
+    // Mantém as redes mais fortes entre todos os resultados, da mais forte para a mais fraca
+    uint8_t selected[NETWORKS_NUMBER];
+    const uint8_t j = LR1110_Select_Strongest(results, nb_scan_results, selected, networks_to_report);
+
+    for (int i = 0; i < j; i++)
+    {
+        const lr11xx_wifi_basic_mac_type_channel_result_t *result = &results[selected[i]];
+
+        receive_data.networks[i].rssi = result->rssi;
+        receive_data.networks[i].channel = result->channel_info_byte;
+        for (int k = 0; k <= MAC_SIZE - 1; k++)
+        {
+            receive_data.networks[i].mac[k] = result->mac_address[k];
+        }
+    }
+
+    LR1110_Fill_Empty_Networks(&receive_data);
+
+    receive_data.network_count = j;
+
+    // Retorna as informações de redes WiFi recebidas
+    receive_data.lr1110_error = LR1110_SUCCESS;
+    return receive_data;
+}
+
+/**
+ * Procura o estado de um rádio na tabela, pelo contexto.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa.
+ * @param create Ocupa uma entrada livre se o rádio ainda não está na tabela.
+ * @return Estado do rádio, NULL se ele não está na tabela e não foi criado (create false ou tabela cheia).
+ */
+static LR1110_radio_state_t *LR1110_Radio_State(const void *context, const bool create)
+{
+    LR1110_radio_state_t *state = NULL;
+    LR1110_radio_state_t *free_state = NULL;
+
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < LR1110_MAX_RADIOS; i++)
+    {
+        if ((radio_states[i].is_used == true) && (radio_states[i].context == context))
+        {
+            state = &radio_states[i];
+            break;
+        }
+
+        if ((radio_states[i].is_used == false) && (free_state == NULL))
+        {
+            free_state = &radio_states[i];
+        }
+    }
+
+    if ((state == NULL) && (create == true) && (free_state != NULL))
+    {
+        free_state->is_used = true;
+        free_state->context = context;
+        state = free_state;
+    }
+    taskEXIT_CRITICAL();
+
+    return state;
+}
+
+/**
+ * Define quantas redes, as mais fortes, HE_NetworkReading informa.
+ *
+ * @param count Número de redes, limitado entre 1 e NETWORKS_NUMBER.
+ */
+void HE_SetNetworksToReport(const uint8_t count)
+{
+    if (count == 0)
+    {
+        networks_to_report = 1;
+    }
+    else if (count > NETWORKS_NUMBER)
+    {
+        networks_to_report = NETWORKS_NUMBER;
+    }
+    else
+    {
+        networks_to_report = count;
+    }
+}
+
+uint8_t HE_GetNetworksToReport(void)
+{
+    return networks_to_report;
+}
+
+/**
+ * Define o pipeline de filtros aplicado às redes por HE_NetworkReading, antes da seleção das mais fortes.
+ *
+ * O pipeline e seus estágios não são copiados e devem permanecer válidos enquanto estiverem em uso.
+ *
+ * @param pipeline Pipeline de filtros, NULL para o pipeline padrão (MACs administrados localmente e OUI 00:00:5E).
+ */
+void HE_SetFilterPipeline(const LR1110_filter_pipeline_t *pipeline)
+{
+    filter_pipeline = (pipeline != NULL) ? pipeline : &default_filter_pipeline;
+}
+
+const LR1110_filter_pipeline_t *HE_GetFilterPipeline(void)
+{
+    return filter_pipeline;
+}
+
+static bool LR1110_Filter_Oui_Listed(const LR1110_filter_stage_t *stage, const uint8_t *mac)
+{
+    for (uint8_t i = 0; i < stage->oui.nb_ouis; i++)
+    {
+        if ((mac[0] == stage->oui.ouis[i][0]) && (mac[1] == stage->oui.ouis[i][1]) &&
+            (mac[2] == stage->oui.ouis[i][2]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool LR1110_Filter_Stage_Accepts(const LR1110_filter_stage_t *stage, const LR1110_filter_candidate_t *candidate)
+{
+    lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+    bool rssi_validity = false;
+    lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_UNKNOWN;
+    lr11xx_wifi_frame_type_t frame_type;
+    lr11xx_wifi_frame_sub_type_t frame_sub_type;
+    bool to_ds = false;
+    bool from_ds = false;
+
+    switch (stage->type)
+    {
+    case LR1110_FILTER_LOCALLY_ADMINISTERED:
+        return (candidate->mac[0] & 0x02) == 0;
+    case LR1110_FILTER_OUI_DENY:
+        return LR1110_Filter_Oui_Listed(stage, candidate->mac) == false;
+    case LR1110_FILTER_OUI_ALLOW:
+        return LR1110_Filter_Oui_Listed(stage, candidate->mac) == true;
+    case LR1110_FILTER_MIN_RSSI:
+        return candidate->rssi >= stage->min_rssi_dbm;
+    case LR1110_FILTER_MAC_ORIGIN:
+        lr11xx_wifi_parse_channel_info(candidate->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+        return (stage->mask & LR1110_FILTER_MASK(mac_origin)) != 0;
+    case LR1110_FILTER_FRAME_TYPE:
+        // Formatos sem o tipo de quadro (MAC/tipo/canal) não são filtrados por este estágio
+        if (candidate->has_frame_type == false)
+        {
+            return true;
+        }
+        lr11xx_wifi_parse_frame_type_info(candidate->frame_type_info_byte, &frame_type, &frame_sub_type, &to_ds,
+                                          &from_ds);
+        return (stage->mask & LR1110_FILTER_MASK(frame_type)) != 0;
+    case LR1110_FILTER_MOBILE_AP:
+        lr11xx_wifi_parse_channel_info(candidate->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+        return mac_origin != LR11XX_WIFI_ORIGIN_BEACON_MOBILE_AP;
+    case LR1110_FILTER_RSSI_VALID:
+        lr11xx_wifi_parse_channel_info(candidate->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+        return rssi_validity == true;
+    }
+
+    return false;
+}
+
+/**
+ * Executa os estágios do pipeline sobre uma rede, na ordem, parando no primeiro que a rejeita.
+ *
+ * @param pipeline Pipeline de filtros, NULL para o pipeline atual (ver HE_SetFilterPipeline).
+ * @param candidate Rede a verificar.
+ * @return true se a rede passa por todos os estágios.
+ */
+bool HE_FilterAccepts(const LR1110_filter_pipeline_t *pipeline, const LR1110_filter_candidate_t *candidate)
+{
+    if (pipeline == NULL)
+    {
+        pipeline = filter_pipeline;
+    }
+
+    for (uint8_t i = 0; i < pipeline->nb_stages; i++)
+    {
+        if (LR1110_Filter_Stage_Accepts(&pipeline->stages[i], candidate) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static LR1110_filter_candidate_t LR1110_Filter_Candidate(const lr11xx_wifi_basic_mac_type_channel_result_t *result)
+{
+    const LR1110_filter_candidate_t candidate = {
+        .mac = result->mac_address,
+        .rssi = result->rssi,
+        .channel_info_byte = result->channel_info_byte,
+        .has_frame_type = false,
+        .frame_type_info_byte = 0,
+    };
+
+    return candidate;
+}
+
+/**
+ * Aplica o pipeline aos resultados no formato MAC/tipo/canal em uma única passada, compactando o vetor.
+ *
+ * @param pipeline Pipeline de filtros, NULL para o pipeline atual.
+ * @param results Resultados do scan, as redes aceitas ficam no início do vetor na ordem original.
+ * @param nb_results Número de resultados.
+ * @return Número de redes aceitas.
+ */
+uint8_t HE_FilterMacTypeChannelResults(const LR1110_filter_pipeline_t *pipeline,
+                                       lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results)
+{
+    uint8_t nb_accepted = 0;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const LR1110_filter_candidate_t candidate = LR1110_Filter_Candidate(&results[i]);
+
+        if (HE_FilterAccepts(pipeline, &candidate) == true)
+        {
+            results[nb_accepted++] = results[i];
+        }
+    }
+
+    return nb_accepted;
+}
+
+/**
+ * Aplica o pipeline aos resultados no formato básico completo em uma única passada, compactando o vetor.
+ *
+ * @param pipeline Pipeline de filtros, NULL para o pipeline atual.
+ * @param results Resultados do scan, as redes aceitas ficam no início do vetor na ordem original.
+ * @param nb_results Número de resultados.
+ * @return Número de redes aceitas.
+ */
+uint8_t HE_FilterBasicCompleteResults(const LR1110_filter_pipeline_t *pipeline,
+                                      lr11xx_wifi_basic_complete_result_t *results, const uint8_t nb_results)
+{
+    uint8_t nb_accepted = 0;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const LR1110_filter_candidate_t candidate = {
+            .mac = results[i].mac_address,
+            .rssi = results[i].rssi,
+            .channel_info_byte = results[i].channel_info_byte,
+            .has_frame_type = true,
+            .frame_type_info_byte = results[i].frame_type_info_byte,
+        };
+
+        if (HE_FilterAccepts(pipeline, &candidate) == true)
+        {
+            results[nb_accepted++] = results[i];
+        }
+    }
+
+    return nb_accepted;
+}
+
+/**
+ * Indica se a rede a é mais forte que a rede b: maior RSSI e, no empate, RSSI válido (medido em um quadro do próprio
+ * AP, bit 6 do channel_info_byte em 0) antes de inválido.
+ */
+static bool LR1110_Is_Stronger(const lr11xx_wifi_basic_mac_type_channel_result_t *a,
+                               const lr11xx_wifi_basic_mac_type_channel_result_t *b)
+{
+    if (a->rssi != b->rssi)
+    {
+        return a->rssi > b->rssi;
+    }
+
+    return ((a->channel_info_byte & 0x40) == 0) && ((b->channel_info_byte & 0x40) != 0);
+}
+
+/**
+ * Restaura o heap de mínimo de selected a partir da posição index: a raiz é a rede selecionada mais fraca.
+ */
+static void LR1110_Heap_Sift_Down(const lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *selected,
+                                  const uint8_t size, uint8_t index)
+{
+    while (true)
+    {
+        const uint8_t left = 2 * index + 1;
+        const uint8_t right = left + 1;
+        uint8_t weakest = index;
+
+        if ((left < size) && LR1110_Is_Stronger(&results[selected[weakest]], &results[selected[left]]))
+        {
+            weakest = left;
+        }
+        if ((right < size) && LR1110_Is_Stronger(&results[selected[weakest]], &results[selected[right]]))
+        {
+            weakest = right;
+        }
+        if (weakest == index)
+        {
+            return;
+        }
+
+        const uint8_t tmp = selected[index];
+        selected[index] = selected[weakest];
+        selected[weakest] = tmp;
+        index = weakest;
+    }
+}
+
+/**
+ * Seleciona as max_selected redes mais fortes aceitas pelo pipeline de filtros com um heap de mínimo limitado, em
+ * uma única passada sobre os resultados, e as ordena da mais forte para a mais fraca.
+ *
+ * @param results Resultados do scan.
+ * @param nb_scan_results Número de resultados.
+ * @param selected Recebe os índices em results das redes selecionadas.
+ * @param max_selected Número máximo de redes selecionadas.
+ * @return Número de redes selecionadas.
+ */
+static uint8_t LR1110_Select_Strongest(const lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                                       const uint8_t nb_scan_results, uint8_t *selected, const uint8_t max_selected)
+{
+    uint8_t size = 0;
+
+    for (uint8_t i = 0; i < nb_scan_results; i++)
+    {
+        const LR1110_filter_candidate_t candidate = LR1110_Filter_Candidate(&results[i]);
+
+        if (HE_FilterAccepts(filter_pipeline, &candidate) == false)
+        {
+            continue;
+        }
+
+        if (size < max_selected)
+        {
+            // Insere no fim e sobe enquanto for mais fraca que o pai
+            uint8_t index = size++;
+            selected[index] = i;
+            while ((index > 0) && LR1110_Is_Stronger(&results[selected[(index - 1) / 2]], &results[selected[index]]))
+            {
+                const uint8_t parent = (index - 1) / 2;
+                const uint8_t tmp = selected[index];
+                selected[index] = selected[parent];
+                selected[parent] = tmp;
+                index = parent;
+            }
+        }
+        else if ((size > 0) && LR1110_Is_Stronger(&results[i], &results[selected[0]]))
+        {
+            // Substitui a selecionada mais fraca
+            selected[0] = i;
+            LR1110_Heap_Sift_Down(results, selected, size, 0);
+        }
+    }
+
+    // Heapsort: a cada passo a mais fraca vai para o fim, o vetor termina da mais forte para a mais fraca
+    for (uint8_t end = size; end > 1; end--)
+    {
+        const uint8_t tmp = selected[0];
+        selected[0] = selected[end - 1];
+        selected[end - 1] = tmp;
+        LR1110_Heap_Sift_Down(results, selected, end - 1, 0);
+    }
+
+    return size;
+}
+
+/**
+ * Inicia um scan Wi-Fi em todos os canais permitidos no país atual (ver HE_GetRegulatoryChannelMask) e suspende a
+ * task até a interrupção de fim de scan (IRQ WIFI_SCAN_DONE, configurada em LR1110_Configure), liberando a CPU
+ * durante toda a janela do scan. Em seguida lê os resultados.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa.
+ * @param deadline_ms Prazo máximo do scan, ver LR1110_WIFI_SCAN_DEADLINE_MS.
+ * @param results Vetor com LR11XX_WIFI_MAX_RESULTS posições que recebe as redes encontradas.
+ * @param nb_scan_results Número de redes encontradas.
+ * @return LR1110_SUCCESS, LR1110_SCAN_TIMEOUT_ERROR se o prazo expirar ou LR1110_SPI_COMMUNICATION_ERROR.
+ */
+uint8_t HE_WifiScanAndWait(const void *context, const uint32_t deadline_ms,
+                           lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results)
+{
+    return HE_WifiScanChannelsAndWait(context, &scan_profiles[LR1110_ENERGY_DEFAULT_PROFILE],
+                                      HE_GetRegulatoryChannelMask(), LR11XX_WIFI_MAX_RESULTS, deadline_ms, results,
+                                      nb_scan_results);
+}
+
+// Descarta uma interrupção anterior para não acordar antes do fim do próximo scan
+static bool LR1110_Clear_Scan_Irq(const void *context)
+{
+    if (lr11xx_system_clear_irq_status(context, LR11XX_SYSTEM_IRQ_ALL_MASK) != LR11XX_STATUS_OK)
+    {
+        return false;
+    }
+    lr11xx_hal_clear_irq(context);
+
+    return true;
+}
+
+// Suspende a task até o fim do scan iniciado e lê até max_results resultados
+static uint8_t LR1110_Wait_Scan_Results(const void *context, const uint8_t max_results, const uint32_t deadline_ms,
+                                        lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                                        uint8_t *nb_scan_results)
+{
+    lr11xx_system_irq_mask_t irq_status = 0;
+
+    if (lr11xx_hal_wait_irq(context, deadline_ms) != LR11XX_HAL_STATUS_OK)
+    {
+        return LR1110_SCAN_TIMEOUT_ERROR;
+    }
+
+    if ((lr11xx_system_get_and_clear_irq_status(context, &irq_status) != LR11XX_STATUS_OK) ||
+        ((irq_status & LR11XX_SYSTEM_IRQ_WIFI_SCAN_DONE) == 0))
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (lr11xx_wifi_get_nb_results(context, nb_scan_results) != LR11XX_STATUS_OK)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (*nb_scan_results > max_results)
+    {
+        *nb_scan_results = max_results;
+    }
+
+    if ((*nb_scan_results > 0) &&
+        (lr11xx_wifi_read_basic_mac_type_channel_results(context, 0, *nb_scan_results, results) != LR11XX_STATUS_OK))
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    return LR1110_SUCCESS;
+}
+
+/**
+ * Como HE_WifiScanAndWait, com o modo e o número de scans por canal do perfil, limitado aos canais de channel_mask
+ * e a max_results redes.
+ *
+ * @param profile Perfil do scan, channel_mask do perfil é ignorado.
+ * @param channel_mask Canais a varrer, bit 0 para o canal 1.
+ * @param max_results Número máximo de redes, no máximo LR11XX_WIFI_MAX_RESULTS, tamanho do vetor results.
+ */
+uint8_t HE_WifiScanChannelsAndWait(const void *context, const LR1110_scan_profile_t *profile,
+                                   const uint16_t channel_mask, const uint8_t max_results, const uint32_t deadline_ms,
+                                   lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results)
+{
+    *nb_scan_results = 0;
+
+    if (LR1110_Clear_Scan_Irq(context) == false)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (lr11xx_wifi_scan(context, LR11XX_WIFI_TYPE_SCAN_B_G_N,
+                         channel_mask, profile->scan_mode,
+                         max_results, profile->nb_scan_per_channel,
+                         LR1110_WIFI_SCAN_TIMEOUT_MS, false) != LR11XX_STATUS_OK)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    return LR1110_Wait_Scan_Results(context, max_results, deadline_ms, results, nb_scan_results);
+}
+
+/**
+ * Como HE_WifiScanChannelsAndWait, com um scan limitado no tempo (lr11xx_wifi_scan_time_limit) em vez de um número de
+ * scans por canal. O prazo é a duração máxima documentada do scan, ver LR1110_WIFI_SCAN_TIME_LIMIT_MAX_MS.
+ *
+ * @param scan_mode Modo do scan.
+ * @param timeout_per_channel_ms Tempo gasto em cada canal, diferente de 0.
+ * @param timeout_per_scan_ms Tempo máximo de detecção de preâmbulo antes de passar ao próximo canal, 0 para esgotar
+ * timeout_per_channel_ms.
+ */
+uint8_t HE_WifiScanTimeLimitAndWait(const void *context, const lr11xx_wifi_mode_t scan_mode,
+                                    const uint16_t channel_mask, const uint8_t max_results,
+                                    const uint16_t timeout_per_channel_ms, const uint16_t timeout_per_scan_ms,
+                                    lr11xx_wifi_basic_mac_type_channel_result_t *results, uint8_t *nb_scan_results)
+{
+    uint8_t nb_channels = 0;
+
+    *nb_scan_results = 0;
+
+    for (uint16_t mask = channel_mask; mask != 0; mask &= mask - 1)
+    {
+        nb_channels++;
+    }
+
+    if (LR1110_Clear_Scan_Irq(context) == false)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (lr11xx_wifi_scan_time_limit(context, LR11XX_WIFI_TYPE_SCAN_B_G_N, channel_mask, scan_mode, max_results,
+                                    timeout_per_channel_ms, timeout_per_scan_ms) != LR11XX_STATUS_OK)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    return LR1110_Wait_Scan_Results(context, max_results,
+                                    LR1110_WIFI_SCAN_TIME_LIMIT_MAX_MS(nb_channels, timeout_per_channel_ms) +
+                                        LR1110_WIFI_SCAN_DEADLINE_MARGIN_MS,
+                                    results, nb_scan_results);
+}
+
+/**
+ * Varre os canais de channel_mask com o prazo correspondente ao número de canais, acrescentando as redes encontradas
+ * depois das nb_results primeiras do vetor results. Com tuner, faz um scan limitado no tempo com os timeouts dele.
+ */
+static uint8_t LR1110_Scan_Channels(const void *context, const LR1110_scan_profile_t *profile,
+                                    const LR1110_timeout_tuner_t *tuner, const uint16_t channel_mask,
+                                    const uint8_t nb_results, lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                                    uint8_t *nb_scan_results)
+{
+    uint8_t nb_channels = 0;
+    uint8_t nb_new_results = 0;
+
+    for (uint16_t mask = channel_mask; mask != 0; mask &= mask - 1)
+    {
+        nb_channels++;
+    }
+
+    uint8_t status = LR1110_SUCCESS;
+
+    if (tuner != NULL)
+    {
+        // Os timeouts ajustados substituem o número de scans por canal do perfil
+        status = HE_WifiScanTimeLimitAndWait(context, profile->scan_mode, channel_mask,
+                                             LR11XX_WIFI_MAX_RESULTS - nb_results,
+                                             HE_TimeoutTunerPerChannel(tuner, nb_channels),
+                                             HE_TimeoutTunerPerScan(tuner, nb_channels), &results[nb_results],
+                                             &nb_new_results);
+    }
+    else
+    {
+        status = HE_WifiScanChannelsAndWait(
+            context, profile, channel_mask, LR11XX_WIFI_MAX_RESULTS - nb_results,
+            LR1110_WIFI_SCAN_DEADLINE_MS(nb_channels, profile->nb_scan_per_channel, LR1110_WIFI_SCAN_TIMEOUT_MS),
+            &results[nb_results], &nb_new_results);
+    }
+
+    *nb_scan_results = nb_results + nb_new_results;
+
+    return status;
+}
+
+/**
+ * Inicializa um planejador de canais sem histórico: os primeiros scans varrem todos os canais.
+ *
+ * @param planner Planejador a inicializar.
+ * @param min_networks Número de redes abaixo do qual um scan planejado é ampliado para os canais restantes.
+ * @param coverage_percent Fração, em %, da ocupação total que os canais planejados devem cobrir.
+ */
+void HE_ChannelPlannerInit(LR1110_channel_planner_t *planner, const uint8_t min_networks,
+                           const uint8_t coverage_percent)
+{
+    memset(planner, 0, sizeof(LR1110_channel_planner_t));
+    planner->min_networks = (min_networks > LR11XX_WIFI_MAX_RESULTS) ? LR11XX_WIFI_MAX_RESULTS : min_networks;
+    planner->coverage_percent = (coverage_percent > 100) ? 100 : coverage_percent;
+}
+
+/**
+ * Canais do próximo scan: os mais ocupados até cobrir coverage_percent da ocupação total aprendida, ou todos os
+ * canais durante o aprendizado inicial, a cada LR1110_CHANNEL_PLAN_FULL_SCAN_PERIOD scans e enquanto nenhuma rede
+ * foi vista.
+ *
+ * @return Máscara de canais, bit 0 para o canal 1.
+ */
+uint16_t HE_ChannelPlannerMask(const LR1110_channel_planner_t *planner)
+{
+    uint32_t total = 0;
+    uint32_t covered = 0;
+    uint16_t channel_mask = 0;
+
+    if ((planner->nb_scans < LR1110_CHANNEL_PLAN_WARMUP_SCANS) ||
+        ((planner->nb_scans % LR1110_CHANNEL_PLAN_FULL_SCAN_PERIOD) == 0))
+    {
+        return LR1110_WIFI_ALL_CHANNELS_MASK;
+    }
+
+    for (uint8_t i = 0; i < LR1110_WIFI_NB_CHANNELS; i++)
+    {
+        total += planner->occupancy_q4[i];
+    }
+
+    while ((covered * 100) < (total * planner->coverage_percent))
+    {
+        uint8_t best = LR1110_WIFI_NB_CHANNELS;
+
+        for (uint8_t i = 0; i < LR1110_WIFI_NB_CHANNELS; i++)
+        {
+            if (((channel_mask & (1u << i)) == 0) && (planner->occupancy_q4[i] > 0) &&
+                ((best == LR1110_WIFI_NB_CHANNELS) || (planner->occupancy_q4[i] > planner->occupancy_q4[best])))
+            {
+                best = i;
+            }
+        }
+
+        if (best == LR1110_WIFI_NB_CHANNELS)
+        {
+            break;
+        }
+
+        channel_mask |= (uint16_t)(1u << best);
+        covered += planner->occupancy_q4[best];
+    }
+
+    return (channel_mask != 0) ? channel_mask : LR1110_WIFI_ALL_CHANNELS_MASK;
+}
+
+/**
+ * Atualiza a ocupação dos canais varridos com o número de redes encontradas em cada um. Os canais fora de
+ * channel_mask mantêm a ocupação anterior.
+ *
+ * @param planner Planejador inicializado por HE_ChannelPlannerInit.
+ * @param channel_mask Canais efetivamente varridos.
+ * @param results Resultados do scan.
+ * @param nb_results Número de resultados.
+ */
+void HE_ChannelPlannerUpdate(LR1110_channel_planner_t *planner, const uint16_t channel_mask,
+                             const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results)
+{
+    uint8_t counts[LR1110_WIFI_NB_CHANNELS] = {0};
+    lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+    bool rssi_validity = false;
+    lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_UNKNOWN;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        lr11xx_wifi_parse_channel_info(results[i].channel_info_byte, &channel, &rssi_validity, &mac_origin);
+        if ((channel >= LR11XX_WIFI_CHANNEL_1) && (channel <= LR1110_WIFI_NB_CHANNELS))
+        {
+            counts[channel - LR11XX_WIFI_CHANNEL_1]++;
+        }
+    }
+
+    for (uint8_t i = 0; i < LR1110_WIFI_NB_CHANNELS; i++)
+    {
+        const uint16_t sample_q4 = (uint16_t)(counts[i] * 16);
+
+        if ((channel_mask & (1u << i)) == 0)
+        {
+            continue;
+        }
+
+        // A queda é arredondada para cima para que um canal que esvaziou chegue a zero
+        if (sample_q4 >= planner->occupancy_q4[i])
+        {
+            planner->occupancy_q4[i] += (sample_q4 - planner->occupancy_q4[i]) >> LR1110_CHANNEL_PLAN_EWMA_SHIFT;
+        }
+        else
+        {
+            const uint16_t drop_q4 = planner->occupancy_q4[i] - sample_q4;
+
+            planner->occupancy_q4[i] -=
+                (drop_q4 + (1 << LR1110_CHANNEL_PLAN_EWMA_SHIFT) - 1) >> LR1110_CHANNEL_PLAN_EWMA_SHIFT;
+        }
+    }
+
+    planner->nb_scans++;
+}
+
+/**
+ * Define o planejador de canais usado por HE_NetworkReadingOnRadio com o rádio indicado, que passa a varrer primeiro
+ * só os canais produtivos. A ocupação dos canais é aprendida por rádio, cada um com o seu planejador.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa (HE_NetworkReading).
+ * @param planner Planejador inicializado por HE_ChannelPlannerInit, NULL para varrer sempre todos os canais. Não pode
+ * ser compartilhado entre rádios.
+ * @return false se LR1110_MAX_RADIOS rádios já têm um estado associado, caso em que o planejador não é usado.
+ */
+bool HE_SetChannelPlanner(const void *context, LR1110_channel_planner_t *planner)
+{
+    LR1110_radio_state_t *radio = LR1110_Radio_State(context, planner != NULL);
+
+    if (radio == NULL)
+    {
+        return planner == NULL;
+    }
+
+    radio->channel_planner = planner;
+
+    return true;
+}
+
+// Peso de uma rede na similaridade, maior para as redes mais fortes
+static uint16_t LR1110_Similarity_Weight(const int8_t rssi)
+{
+    const int16_t weight = rssi - LR1110_SIMILARITY_RSSI_FLOOR_DBM;
+
+    return (weight > 0) ? (uint16_t)weight : 1;
+}
+
+/**
+ * Similaridade entre o fingerprint informado e um novo scan: Jaccard ponderado pelo RSSI sobre os conjuntos de MACs,
+ * soma dos pesos mínimos dividida pela soma dos pesos máximos de cada MAC da união. Um MAC presente em só um dos
+ * lados entra com peso 0 no outro.
+ *
+ * Do novo scan são usadas as redes que HE_NetworkReading informaria: as mais fortes aceitas pelo pipeline de
+ * filtros, no mesmo número que o fingerprint de referência.
+ *
+ * @param reference Redes informadas anteriormente, por exemplo o retorno de HE_NetworkReading.
+ * @param results Resultados do novo scan, como lidos por lr11xx_wifi_read_basic_mac_type_channel_results.
+ * @param nb_results Número de resultados.
+ * @return Similaridade de 0 (nenhum MAC em comum) a 100 (mesmos MACs com o mesmo RSSI).
+ */
+uint8_t HE_WifiSimilarity(const LR1110ResponseNetworksToDevice_t *reference,
+                          const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results)
+{
+    uint8_t selected[NETWORKS_NUMBER];
+    uint32_t sum_min = 0;
+    uint32_t sum_max = 0;
+    bool is_matched[NETWORKS_NUMBER] = {false};
+    const uint8_t nb_reference = (reference->network_count > NETWORKS_NUMBER) ? NETWORKS_NUMBER
+                                                                              : reference->network_count;
+    const uint8_t nb_selected =
+        LR1110_Select_Strongest(results, nb_results, selected, (nb_reference > 0) ? nb_reference : NETWORKS_NUMBER);
+
+    for (uint8_t i = 0; i < nb_reference; i++)
+    {
+        const LR1110_wifi_t *network = &reference->networks[i];
+        const uint16_t reference_weight = LR1110_Similarity_Weight((int8_t)network->rssi);
+        uint16_t weight = 0;
+
+        for (uint8_t k = 0; k < nb_selected; k++)
+        {
+            if ((is_matched[k] == false) && (memcmp(results[selected[k]].mac_address, network->mac, MAC_SIZE) == 0))
+            {
+                is_matched[k] = true;
+                weight = LR1110_Similarity_Weight(results[selected[k]].rssi);
+                break;
+            }
+        }
+
+        sum_min += (weight < reference_weight) ? weight : reference_weight;
+        sum_max += (weight > reference_weight) ? weight : reference_weight;
+    }
+
+    for (uint8_t k = 0; k < nb_selected; k++)
+    {
+        if (is_matched[k] == false)
+        {
+            sum_max += LR1110_Similarity_Weight(results[selected[k]].rssi);
+        }
+    }
+
+    if (sum_max == 0)
+    {
+        // Nenhuma rede dos dois lados
+        return 100;
+    }
+
+    return (uint8_t)((sum_min * 100 + sum_max / 2) / sum_max);
+}
+
+/**
+ * Inicializa uma comparação sem fingerprint de referência: o dispositivo é considerado em movimento até a primeira
+ * chamada de HE_SimilarityGateSetReference.
+ *
+ * @param gate Comparação a inicializar.
+ * @param threshold_percent Similaridade abaixo da qual o dispositivo é considerado em movimento.
+ */
+void HE_SimilarityGateInit(LR1110_similarity_gate_t *gate, const uint8_t threshold_percent)
+{
+    memset(gate, 0, sizeof(LR1110_similarity_gate_t));
+    gate->threshold_percent = threshold_percent;
+}
+
+/**
+ * Guarda as redes efetivamente enviadas como referência das próximas comparações.
+ *
+ * @param gate Comparação inicializada por HE_SimilarityGateInit.
+ * @param reported Redes enviadas, por exemplo o retorno de HE_NetworkReading.
+ */
+void HE_SimilarityGateSetReference(LR1110_similarity_gate_t *gate, const LR1110ResponseNetworksToDevice_t *reported)
+{
+    gate->reference = *reported;
+    gate->has_reference = true;
+}
+
+/**
+ * Indica se um novo scan difere do fingerprint de referência o suficiente para justificar um novo envio.
+ *
+ * @param gate Comparação inicializada por HE_SimilarityGateInit, last_similarity_percent recebe a similaridade.
+ * @param results Resultados do novo scan.
+ * @param nb_results Número de resultados.
+ * @return true se não há referência ou se a similaridade ficou abaixo de threshold_percent.
+ */
+bool HE_SimilarityGateHasMoved(LR1110_similarity_gate_t *gate,
+                               const lr11xx_wifi_basic_mac_type_channel_result_t *results, const uint8_t nb_results)
+{
+    if (gate->has_reference == false)
+    {
+        gate->last_similarity_percent = 0;
+        return true;
+    }
+
+    gate->last_similarity_percent = HE_WifiSimilarity(&gate->reference, results, nb_results);
+
+    return gate->last_similarity_percent < gate->threshold_percent;
+}
+
+/**
+ * Scan curto de verificação: varre só os canais das redes de referência e termina após
+ * LR1110_SIMILARITY_PROBE_MAX_RESULTS redes, e compara o resultado com a referência. O scan completo de
+ * HE_NetworkReading só precisa ser feito quando has_moved for true.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa.
+ * @param gate Comparação inicializada por HE_SimilarityGateInit.
+ * @param has_moved Resultado de HE_SimilarityGateHasMoved, true também se não há referência.
+ * @return LR1110_SUCCESS, LR1110_CONFIGURATION_ERROR ou o erro de HE_WifiScanChannelsAndWait.
+ */
+uint8_t HE_SimilarityGateProbe(const void *context, LR1110_similarity_gate_t *gate, bool *has_moved)
+{
+    lr11xx_wifi_basic_mac_type_channel_result_t results[LR1110_SIMILARITY_PROBE_MAX_RESULTS];
+    uint8_t nb_scan_results = 0;
+    uint16_t channel_mask = 0;
+    uint8_t nb_channels = 0;
+    lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+    bool rssi_validity = false;
+    lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_UNKNOWN;
+
+    *has_moved = true;
+
+    if (gate->has_reference == false)
+    {
+        return LR1110_SUCCESS;
+    }
+
+    for (uint8_t i = 0; (i < gate->reference.network_count) && (i < NETWORKS_NUMBER); i++)
+    {
+        lr11xx_wifi_parse_channel_info(gate->reference.networks[i].channel, &channel, &rssi_validity, &mac_origin);
+        if ((channel >= LR11XX_WIFI_CHANNEL_1) && (channel <= LR1110_WIFI_NB_CHANNELS) &&
+            ((channel_mask & (1u << (channel - LR11XX_WIFI_CHANNEL_1))) == 0))
+        {
+            channel_mask |= (uint16_t)(1u << (channel - LR11XX_WIFI_CHANNEL_1));
+            nb_channels++;
+        }
+    }
+
+    if (channel_mask == 0)
+    {
+        // Referência sem canais, por exemplo um fingerprint decodificado sem eles
+        channel_mask = LR1110_WIFI_ALL_CHANNELS_MASK;
+        nb_channels = LR1110_WIFI_NB_CHANNELS;
+    }
+
+    lr11xx_hal_reset(context);
+
+    if (LR1110_Configure(context) == FALSE)
+    {
+        return LR1110_CONFIGURATION_ERROR;
+    }
+
+    const LR1110_scan_profile_t *profile = &scan_profiles[LR1110_ENERGY_DEFAULT_PROFILE];
+    const uint8_t scan_status = HE_WifiScanChannelsAndWait(
+        context, profile, channel_mask, LR1110_SIMILARITY_PROBE_MAX_RESULTS,
+        LR1110_WIFI_SCAN_DEADLINE_MS(nb_channels, profile->nb_scan_per_channel, LR1110_WIFI_SCAN_TIMEOUT_MS), results,
+        &nb_scan_results);
+
+    if (scan_status != LR1110_SUCCESS)
+    {
+        return scan_status;
+    }
+
+    *has_moved = HE_SimilarityGateHasMoved(gate, results, nb_scan_results);
+
+    return LR1110_SUCCESS;
+}
+
+/**
+ * Inicializa um agendador de energia sem histórico, no perfil padrão e no intervalo mínimo.
+ *
+ * @param scheduler Agendador a inicializar.
+ * @param daily_budget_uah Carga que os scans Wi-Fi podem gastar em 24 horas, em uAh.
+ * @param min_interval_ms Menor intervalo entre scans, usado quando o orçamento sobra.
+ * @param max_interval_ms Maior intervalo entre scans, acima dele o agendador passa a um perfil mais econômico.
+ */
+void HE_EnergySchedulerInit(LR1110_energy_scheduler_t *scheduler, const uint32_t daily_budget_uah,
+                            const uint32_t min_interval_ms, const uint32_t max_interval_ms)
+{
+    memset(scheduler, 0, sizeof(LR1110_energy_scheduler_t));
+    scheduler->daily_budget_uah = daily_budget_uah;
+    scheduler->min_interval_ms = min_interval_ms;
+    scheduler->max_interval_ms = (max_interval_ms > min_interval_ms) ? max_interval_ms : min_interval_ms;
+    scheduler->profile = LR1110_ENERGY_DEFAULT_PROFILE;
+    scheduler->interval_ms = min_interval_ms;
+}
+
+/**
+ * Carga de um scan, em nAh, a partir dos tempos acumulados do LR1110 e do regulador configurado.
+ */
+uint32_t HE_EnergySchedulerScanCharge(const lr11xx_wifi_cumulative_timings_t *timings)
+{
+    return lr11xx_wifi_get_consumption_nah(LR1110_REG_MODE, timings);
+}
+
+// Avança a janela de uma hora atual até now_ms, zerando as horas que saíram das últimas 24
+static void LR1110_Energy_Advance(LR1110_energy_scheduler_t *scheduler, const uint32_t now_ms)
+{
+    if (scheduler->has_started == false)
+    {
+        scheduler->has_started = true;
+        scheduler->bucket_start_ms = now_ms;
+        return;
+    }
+
+    const uint32_t nb_elapsed = (now_ms - scheduler->bucket_start_ms) / LR1110_ENERGY_BUCKET_MS;
+
+    if (nb_elapsed >= LR1110_ENERGY_NB_BUCKETS)
+    {
+        memset(scheduler->spent_nah, 0, sizeof(scheduler->spent_nah));
+        scheduler->bucket_start_ms = now_ms;
+        return;
+    }
+
+    for (uint32_t i = 0; i < nb_elapsed; i++)
+    {
+        scheduler->bucket = (scheduler->bucket + 1) % LR1110_ENERGY_NB_BUCKETS;
+        scheduler->spent_nah[scheduler->bucket] = 0;
+    }
+    scheduler->bucket_start_ms += nb_elapsed * LR1110_ENERGY_BUCKET_MS;
+}
+
+static uint32_t LR1110_Energy_Spent_Nah(const LR1110_energy_scheduler_t *scheduler)
+{
+    uint32_t spent_nah = 0;
+
+    for (uint8_t i = 0; i < LR1110_ENERGY_NB_BUCKETS; i++)
+    {
+        spent_nah += scheduler->spent_nah[i];
+    }
+
+    return spent_nah;
+}
+
+/**
+ * Intervalo que gasta exatamente o orçamento diário com scans de charge_nah, alongado na proporção do excesso
+ * quando as últimas 24 horas já passaram do orçamento.
+ */
+static uint32_t LR1110_Energy_Interval(const LR1110_energy_scheduler_t *scheduler, const uint32_t charge_nah,
+                                       const uint32_t spent_nah)
+{
+    const uint64_t budget_nah = (uint64_t)scheduler->daily_budget_uah * 1000;
+
+    if (budget_nah == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    uint64_t interval_ms = ((uint64_t)charge_nah * LR1110_ENERGY_DAY_MS) / budget_nah;
+
+    if (spent_nah > budget_nah)
+    {
+        interval_ms = (interval_ms * spent_nah) / budget_nah;
+    }
+
+    return (interval_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)interval_ms;
+}
+
+/**
+ * Contabiliza a carga de um scan no orçamento e escolhe o perfil e o intervalo do próximo scan: passa a um perfil
+ * mais econômico quando o atual exigiria um intervalo acima de max_interval_ms, e volta a um mais completo quando
+ * este caberia com folga na metade de max_interval_ms. A carga de um perfil ainda não usado é estimada como o dobro
+ * da do perfil seguinte.
+ *
+ * @param scheduler Agendador inicializado por HE_EnergySchedulerInit.
+ * @param timings Tempos acumulados do scan, lidos com lr11xx_wifi_read_cumulative_timing.
+ * @param now_ms Instante do scan, em milissegundos.
+ */
+void HE_EnergySchedulerRecordScan(LR1110_energy_scheduler_t *scheduler, const lr11xx_wifi_cumulative_timings_t *timings,
+                                  const uint32_t now_ms)
+{
+    const uint32_t charge_nah = HE_EnergySchedulerScanCharge(timings);
+    uint32_t *profile_charge_nah = &scheduler->scan_charge_nah[scheduler->profile];
+
+    LR1110_Energy_Advance(scheduler, now_ms);
+    scheduler->spent_nah[scheduler->bucket] += charge_nah;
+    scheduler->last_scan_nah = charge_nah;
+
+    if (*profile_charge_nah == 0)
+    {
+        *profile_charge_nah = charge_nah;
+    }
+    else if (charge_nah >= *profile_charge_nah)
+    {
+        *profile_charge_nah += (charge_nah - *profile_charge_nah) >> LR1110_ENERGY_EWMA_SHIFT;
+    }
+    else
+    {
+        *profile_charge_nah -= (*profile_charge_nah - charge_nah) >> LR1110_ENERGY_EWMA_SHIFT;
+    }
+
+    const uint32_t spent_nah = LR1110_Energy_Spent_Nah(scheduler);
+    uint32_t interval_ms = LR1110_Energy_Interval(scheduler, *profile_charge_nah, spent_nah);
+
+    if ((interval_ms > scheduler->max_interval_ms) && (scheduler->profile < (LR1110_ENERGY_NB_PROFILES - 1)))
+    {
+        scheduler->profile++;
+        if (scheduler->scan_charge_nah[scheduler->profile] != 0)
+        {
+            interval_ms = LR1110_Energy_Interval(scheduler, scheduler->scan_charge_nah[scheduler->profile], spent_nah);
+        }
+    }
+    else if (scheduler->profile > 0)
+    {
+        const uint32_t richer_charge_nah = (scheduler->scan_charge_nah[scheduler->profile - 1] != 0)
+                                               ? scheduler->scan_charge_nah[scheduler->profile - 1]
+                                               : (2 * *profile_charge_nah);
+        const uint32_t richer_interval_ms = LR1110_Energy_Interval(scheduler, richer_charge_nah, spent_nah);
+
+        if (richer_interval_ms <= (scheduler->max_interval_ms / 2))
+        {
+            scheduler->profile--;
+            interval_ms = richer_interval_ms;
+        }
+    }
+
+    if (interval_ms < scheduler->min_interval_ms)
+    {
+        interval_ms = scheduler->min_interval_ms;
+    }
+    else if (interval_ms > scheduler->max_interval_ms)
+    {
+        interval_ms = scheduler->max_interval_ms;
+    }
+    scheduler->interval_ms = interval_ms;
+}
+
+/**
+ * Carga gasta pelos scans nas últimas 24 horas, em uAh.
+ */
+uint32_t HE_EnergySchedulerSpentUah(const LR1110_energy_scheduler_t *scheduler)
+{
+    return LR1110_Energy_Spent_Nah(scheduler) / 1000;
+}
+
+/**
+ * Perfil (modo, canais e scans por canal) que o próximo scan deve usar para respeitar o orçamento.
+ */
+const LR1110_scan_profile_t *HE_EnergySchedulerProfile(const LR1110_energy_scheduler_t *scheduler)
+{
+    return &scan_profiles[scheduler->profile];
+}
+
+/**
+ * Intervalo, em milissegundos, que a aplicação deve esperar antes do próximo scan.
+ */
+uint32_t HE_EnergySchedulerInterval(const LR1110_energy_scheduler_t *scheduler)
+{
+    return scheduler->interval_ms;
+}
+
+/**
+ * Define o agendador de energia usado por HE_NetworkReadingOnRadio com o rádio indicado: cada leitura usa o perfil
+ * escolhido por ele e tem a sua carga contabilizada no orçamento desse rádio. O intervalo entre leituras continua a
+ * cargo da aplicação, ver HE_EnergySchedulerInterval.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa (HE_NetworkReading).
+ * @param scheduler Agendador inicializado por HE_EnergySchedulerInit, NULL para o scan padrão sem contabilização.
+ * Não pode ser compartilhado entre rádios.
+ * @return false se LR1110_MAX_RADIOS rádios já têm um estado associado, caso em que o agendador não é usado.
+ */
+bool HE_SetEnergyScheduler(const void *context, LR1110_energy_scheduler_t *scheduler)
+{
+    LR1110_radio_state_t *radio = LR1110_Radio_State(context, scheduler != NULL);
+
+    if (radio == NULL)
+    {
+        return scheduler == NULL;
+    }
+
+    radio->energy_scheduler = scheduler;
+
+    return true;
+}
+
+// Maior timeout por canal cuja duração máxima documentada do scan em nb_channels canais não passa de max_scan_ms
+static uint16_t LR1110_Timeout_Ceiling(const LR1110_timeout_tuner_t *tuner, const uint8_t nb_channels)
+{
+    const uint32_t nb = (nb_channels > 0) ? nb_channels : 1;
+    uint32_t ceiling_ms = 1;
+
+    if (tuner->max_scan_ms > LR1110_WIFI_SCAN_TIME_LIMIT_OFFSET_MS)
+    {
+        ceiling_ms = ((tuner->max_scan_ms - LR1110_WIFI_SCAN_TIME_LIMIT_OFFSET_MS) * 100) / (2 * nb * 101);
+    }
+
+    // 0 é proibido por lr11xx_wifi_scan_time_limit: com um teto curto demais o scan mais curto possível é usado
+    if (ceiling_ms == 0)
+    {
+        ceiling_ms = 1;
+    }
+
+    return (ceiling_ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)ceiling_ms;
+}
+
+/**
+ * Inicializa o ajuste dos timeouts de scan com um timeout por canal que atinge target_latency_ms em todos os canais.
+ *
+ * @param tuner Ajuste a inicializar.
+ * @param target_latency_ms Duração desejada de um scan.
+ * @param target_networks Número de redes desejado por scan, no máximo LR11XX_WIFI_MAX_RESULTS.
+ * @param max_scan_ms Teto da duração de um scan, nunca ultrapassado, ver HE_TimeoutTunerPerChannel. Deve passar de
+ * LR1110_WIFI_SCAN_TIME_LIMIT_OFFSET_MS.
+ */
+void HE_TimeoutTunerInit(LR1110_timeout_tuner_t *tuner, const uint32_t target_latency_ms,
+                         const uint8_t target_networks, const uint32_t max_scan_ms)
+{
+    uint32_t per_channel_ms = target_latency_ms / (2 * LR1110_WIFI_NB_CHANNELS);
+
+    memset(tuner, 0, sizeof(LR1110_timeout_tuner_t));
+    tuner->target_latency_ms = target_latency_ms;
+    tuner->target_networks = (target_networks > LR11XX_WIFI_MAX_RESULTS) ? LR11XX_WIFI_MAX_RESULTS : target_networks;
+    tuner->max_scan_ms = max_scan_ms;
+
+    if (per_channel_ms < LR1110_TIMEOUT_TUNER_MIN_PER_CHANNEL_MS)
+    {
+        per_channel_ms = LR1110_TIMEOUT_TUNER_MIN_PER_CHANNEL_MS;
+    }
+    tuner->per_channel_ms = (per_channel_ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)per_channel_ms;
+    tuner->per_scan_ms = (tuner->per_channel_ms < LR1110_TIMEOUT_TUNER_BEACON_INTERVAL_MS)
+                             ? tuner->per_channel_ms
+                             : LR1110_TIMEOUT_TUNER_BEACON_INTERVAL_MS;
+}
+
+/**
+ * Timeout por canal do próximo scan em nb_channels canais. É limitado pelo teto: a duração máxima documentada do scan,
+ * LR1110_WIFI_SCAN_TIME_LIMIT_MAX_MS(nb_channels, timeout), não passa de max_scan_ms.
+ *
+ * @return Timeout por canal em ms, nunca 0.
+ */
+uint16_t HE_TimeoutTunerPerChannel(const LR1110_timeout_tuner_t *tuner, const uint8_t nb_channels)
+{
+    const uint16_t ceiling_ms = LR1110_Timeout_Ceiling(tuner, nb_channels);
+
+    return (tuner->per_channel_ms < ceiling_ms) ? tuner->per_channel_ms : ceiling_ms;
+}
+
+/**
+ * Timeout de detecção de preâmbulo do próximo scan em nb_channels canais, no máximo o timeout por canal.
+ *
+ * @return Timeout de detecção de preâmbulo em ms.
+ */
+uint16_t HE_TimeoutTunerPerScan(const LR1110_timeout_tuner_t *tuner, const uint8_t nb_channels)
+{
+    const uint16_t per_channel_ms = HE_TimeoutTunerPerChannel(tuner, nb_channels);
+
+    return (tuner->per_scan_ms < per_channel_ms) ? tuner->per_scan_ms : per_channel_ms;
+}
+
+/**
+ * Ajusta os timeouts com o tempo de rádio e o número de redes do último scan:
+ * - acima da latência desejada, o timeout por canal é reduzido na proporção do excesso;
+ * - dentro da latência e com menos redes que o desejado, os timeouts aumentam 25% para escutar mais;
+ * - dentro da latência e com redes suficientes, os timeouts diminuem 12,5% em busca do scan mais curto que ainda
+ *   encontra as redes.
+ *
+ * @param tuner Ajuste inicializado por HE_TimeoutTunerInit.
+ * @param timings Tempos acumulados do scan, lidos por lr11xx_wifi_read_cumulative_timing.
+ * @param nb_channels Número de canais varridos.
+ * @param nb_results Número de redes encontradas.
+ */
+void HE_TimeoutTunerUpdate(LR1110_timeout_tuner_t *tuner, const lr11xx_wifi_cumulative_timings_t *timings,
+                           const uint8_t nb_channels, const uint8_t nb_results)
+{
+    uint32_t per_channel_ms = HE_TimeoutTunerPerChannel(tuner, nb_channels);
+    uint32_t per_scan_ms = HE_TimeoutTunerPerScan(tuner, nb_channels);
+
+    tuner->last_scan_ms = (timings->rx_detection_us + timings->rx_correlation_us + timings->rx_capture_us +
+                           timings->demodulation_us) /
+                          1000;
+
+    if (tuner->last_scan_ms > tuner->target_latency_ms)
+    {
+        per_channel_ms = (uint32_t)(((uint64_t)per_channel_ms * tuner->target_latency_ms) / tuner->last_scan_ms);
+    }
+    else if (nb_results < tuner->target_networks)
+    {
+        per_channel_ms += (per_channel_ms / 4) + 1;
+        per_scan_ms += (per_scan_ms / 4) + 1;
+        if (per_scan_ms > LR1110_TIMEOUT_TUNER_BEACON_INTERVAL_MS)
+        {
+            per_scan_ms = LR1110_TIMEOUT_TUNER_BEACON_INTERVAL_MS;
+        }
+    }
+    else
+    {
+        per_channel_ms -= per_channel_ms / 8;
+        per_scan_ms -= per_scan_ms / 8;
+    }
+
+    // O piso vale só para o ajuste, o teto sempre prevalece
+    if (per_channel_ms < LR1110_TIMEOUT_TUNER_MIN_PER_CHANNEL_MS)
+    {
+        per_channel_ms = LR1110_TIMEOUT_TUNER_MIN_PER_CHANNEL_MS;
+    }
+    if (per_channel_ms > LR1110_Timeout_Ceiling(tuner, nb_channels))
+    {
+        per_channel_ms = LR1110_Timeout_Ceiling(tuner, nb_channels);
+    }
+    if (per_scan_ms < LR1110_TIMEOUT_TUNER_MIN_PER_SCAN_MS)
+    {
+        per_scan_ms = LR1110_TIMEOUT_TUNER_MIN_PER_SCAN_MS;
+    }
+    if (per_scan_ms > per_channel_ms)
+    {
+        per_scan_ms = per_channel_ms;
+    }
+
+    tuner->per_channel_ms = (uint16_t)per_channel_ms;
+    tuner->per_scan_ms = (uint16_t)per_scan_ms;
+}
+
+/**
+ * Define o ajuste dos timeouts usado por HE_NetworkReadingOnRadio com o rádio indicado, que passa a fazer scans
+ * limitados no tempo (lr11xx_wifi_scan_time_limit) com o modo e os canais do perfil atual. Os timeouts são ajustados
+ * pelas redes e pela latência de cada rádio.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa (HE_NetworkReading).
+ * @param tuner Ajuste inicializado por HE_TimeoutTunerInit, NULL para o scan por número de varreduras do perfil. Não
+ * pode ser compartilhado entre rádios.
+ * @return false se LR1110_MAX_RADIOS rádios já têm um estado associado, caso em que o ajuste não é usado.
+ */
+bool HE_SetTimeoutTuner(const void *context, LR1110_timeout_tuner_t *tuner)
+{
+    LR1110_radio_state_t *radio = LR1110_Radio_State(context, tuner != NULL);
+
+    if (radio == NULL)
+    {
+        return tuner == NULL;
+    }
+
+    radio->timeout_tuner = tuner;
+
+    return true;
+}
+
+// Código de país com duas letras maiúsculas, os beacons sem o elemento de país trazem outros valores
+static bool LR1110_Is_Country_Code(const uint8_t *code)
+{
+    return (code[0] >= 'A') && (code[0] <= 'Z') && (code[1] >= 'A') && (code[1] <= 'Z');
+}
+
+/**
+ * Canais Wi-Fi permitidos em um país: 1 a 11 nos EUA, Canadá, Taiwan e territórios americanos, 1 a 14 no Japão e
+ * 1 a 13 nos demais.
+ *
+ * @param country_code Código ISO 3166 de duas letras, como informado pelos beacons.
+ * @return Máscara de canais, bit 0 para o canal 1, todos os canais para um código desconhecido.
+ */
+uint16_t HE_CountryCodeChannelMask(const uint8_t *country_code)
+{
+    if ((LR1110_Is_Country_Code(country_code) == false) || ((country_code[0] == 'J') && (country_code[1] == 'P')))
+    {
+        return LR1110_WIFI_ALL_CHANNELS_MASK;
+    }
+
+    for (uint8_t i = 0; i < (sizeof(channels_1_to_11_countries) / sizeof(channels_1_to_11_countries[0])); i++)
+    {
+        if ((country_code[0] == channels_1_to_11_countries[i][0]) &&
+            (country_code[1] == channels_1_to_11_countries[i][1]))
+        {
+            return LR1110_WIFI_CHANNELS_1_TO_11_MASK;
+        }
+    }
+
+    return LR1110_WIFI_CHANNELS_1_TO_13_MASK;
+}
+
+/**
+ * Define o código de país atual, por exemplo o gravado em memória não volátil por LR1110_country_code_save_t, e
+ * restringe os scans seguintes aos canais permitidos nele.
+ *
+ * @param code Código ISO 3166 de duas letras, NULL ou inválido para voltar a varrer todos os canais.
+ */
+void HE_SetCountryCode(const uint8_t *code)
+{
+    const bool is_valid = (code != NULL) && (LR1110_Is_Country_Code(code) == true);
+    const uint16_t channel_mask = (is_valid == true) ? HE_CountryCodeChannelMask(code) : LR1110_WIFI_ALL_CHANNELS_MASK;
+
+    taskENTER_CRITICAL();
+    if (is_valid == true)
+    {
+        memcpy(country_code, code, sizeof(country_code));
+    }
+    else
+    {
+        memset(country_code, 0, sizeof(country_code));
+    }
+    regulatory_channel_mask = channel_mask;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Código de país atual.
+ *
+ * @param code Recebe as duas letras do código, {0, 0} se desconhecido.
+ * @return true se o código é conhecido.
+ */
+bool HE_GetCountryCode(uint8_t *code)
+{
+    taskENTER_CRITICAL();
+    memcpy(code, country_code, sizeof(country_code));
+    taskEXIT_CRITICAL();
+
+    return code[0] != 0;
+}
+
+uint16_t HE_GetRegulatoryChannelMask(void)
+{
+    return regulatory_channel_mask;
+}
+
+/**
+ * Define a função chamada quando HE_WifiSearchCountryCode detecta um código de país diferente do atual.
+ *
+ * @param save Função de gravação, NULL para não gravar.
+ */
+void HE_SetCountryCodeSaveCallback(LR1110_country_code_save_t save)
+{
+    country_code_save = save;
+}
+
+/**
+ * Busca o código de país nos beacons de todos os canais, adota o código mais frequente entre as redes encontradas e
+ * restringe os scans seguintes aos canais permitidos nele. A busca só precisa ser refeita quando o dispositivo pode
+ * ter mudado de país.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa, já configurado por LR1110_Configure.
+ * @param code Recebe o código adotado, pode ser NULL.
+ * @return LR1110_SUCCESS, LR1110_NO_WIFI_FOUND se nenhum beacon trouxe o código, LR1110_SCAN_TIMEOUT_ERROR ou
+ * LR1110_SPI_COMMUNICATION_ERROR.
+ */
+uint8_t HE_WifiSearchCountryCode(const void *context, uint8_t *code)
+{
+    lr11xx_wifi_country_code_t results[LR11XX_WIFI_MAX_COUNTRY_CODE];
+    lr11xx_system_irq_mask_t irq_status = 0;
+    uint8_t nb_country_code_results = 0;
+    uint8_t best = 0;
+    uint8_t best_count = 0;
+
+    if (lr11xx_system_clear_irq_status(context, LR11XX_SYSTEM_IRQ_ALL_MASK) != LR11XX_STATUS_OK)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+    lr11xx_hal_clear_irq(context);
+
+    if (lr11xx_wifi_search_country_code(context, LR1110_WIFI_ALL_CHANNELS_MASK, LR11XX_WIFI_MAX_COUNTRY_CODE,
+                                        LR1110_COUNTRY_CODE_SCAN_PER_CHANNEL, LR1110_COUNTRY_CODE_SCAN_TIMEOUT_MS,
+                                        false) != LR11XX_STATUS_OK)
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (lr11xx_hal_wait_irq(context, LR1110_WIFI_SCAN_DEADLINE_MS(LR1110_WIFI_NB_CHANNELS,
+                                                                  LR1110_COUNTRY_CODE_SCAN_PER_CHANNEL,
+                                                                  LR1110_COUNTRY_CODE_SCAN_TIMEOUT_MS)) !=
+        LR11XX_HAL_STATUS_OK)
+    {
+        return LR1110_SCAN_TIMEOUT_ERROR;
+    }
+
+    if ((lr11xx_system_get_and_clear_irq_status(context, &irq_status) != LR11XX_STATUS_OK) ||
+        ((irq_status & LR11XX_SYSTEM_IRQ_WIFI_SCAN_DONE) == 0) ||
+        (lr11xx_wifi_get_nb_country_code_results(context, &nb_country_code_results) != LR11XX_STATUS_OK))
+    {
+        return LR1110_SPI_COMMUNICATION_ERROR;
+    }
+
+    if (nb_country_code_results > LR11XX_WIFI_MAX_COUNTRY_CODE)
+    {
+        nb_country_code_results = LR11XX_WIFI_MAX_COUNTRY_CODE;
+    }
+
+    // Leitura em blocos de LR1110_COUNTRY_CODE_RESULTS_PER_READ para limitar o tamanho de cada transação SPI
+    for (uint8_t start = 0; start < nb_country_code_results; start += LR1110_COUNTRY_CODE_RESULTS_PER_READ)
+    {
+        uint8_t nb_read = nb_country_code_results - start;
+
+        if (nb_read > LR1110_COUNTRY_CODE_RESULTS_PER_READ)
+        {
+            nb_read = LR1110_COUNTRY_CODE_RESULTS_PER_READ;
+        }
 
-static uint32_t number_of_scan = 0;
+        if (lr11xx_wifi_read_country_code_results(context, start, nb_read, &results[start]) != LR11XX_STATUS_OK)
+        {
+            return LR1110_SPI_COMMUNICATION_ERROR;
+        }
+    }
 
-uint8_t nb_results = 0;
+    // Voto de maioria: um AP mal configurado não muda o país
+    for (uint8_t i = 0; i < nb_country_code_results; i++)
+    {
+        uint8_t count = 0;
 
-void LR1110_Fill_Empty_Networks(LR1110ResponseNetworksToDevice_t *receive_data);
-bool LR1110_Read_Version_Status(void);
-bool LR1110_Configure(void);
-bool can_execute_next_scan(void);
-void call_scan(const void *context);
-void start_scan(void);
+        if (LR1110_Is_Country_Code(results[i].country_code) == false)
+        {
+            continue;
+        }
 
-LR1110ResponseNetworksToDevice_t HE_NetworkReading(void)
-{
-    LR1110ResponseNetworksToDevice_t receive_data = LR1110RESPONSENETWORKSTODEVICE_T_INITIALIZER;
+        for (uint8_t k = 0; k < nb_country_code_results; k++)
+        {
+            if (memcmp(results[k].country_code, results[i].country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0)
+            {
+                count++;
+            }
+        }
 
-    LR1110ResponseNetworksToDevice_t receive_data_error = LR1110RESPONSENETWORKSTODEVICE_T_ERROR;
+        if (count > best_count)
+        {
+            best = i;
+            best_count = count;
+        }
+    }
 
-    lr11xx_hal_reset(NULL);
+    if (best_count == 0)
+    {
+        return LR1110_NO_WIFI_FOUND;
+    }
 
-    // delay_us(500000); // não remover
-    // delay_us(100000); // não remover
+    uint8_t current_code[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE];
 
-    // delay_us(100000); // não remover
+    HE_GetCountryCode(current_code);
+    if (memcmp(current_code, results[best].country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) != 0)
+    {
+        HE_SetCountryCode(results[best].country_code);
+        if (country_code_save != NULL)
+        {
+            country_code_save(results[best].country_code);
+        }
+    }
 
-    if (LR1110_Read_Version_Status() == FALSE)
+    if (code != NULL)
     {
-        PRINT_LOGS('E', "ERROR_LR1110: Check SPI Communication!\n");
-        receive_data_error.lr1110_error = LR1110_SPI_COMMUNICATION_ERROR;
-        return receive_data_error;
+        memcpy(code, results[best].country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
     }
 
-    // delay_us(1000000); // não remover
-    // delay_us(100000); // não remover
+    return LR1110_SUCCESS;
+}
+
+/**
+ * Tamanho em bytes de um fingerprint com nb_networks redes no modo de canal indicado.
+ */
+static uint8_t LR1110_Fingerprint_Size(const uint8_t nb_networks, const uint8_t channel_mode)
+{
+    uint8_t nb_nibbles = nb_networks;
 
-    if (LR1110_Configure() == FALSE)
+    if (channel_mode == LR1110_FINGERPRINT_CHANNEL_COMMON)
     {
-        printf("ERROR_LR1110: Check crystal oscillator!\n");
-        receive_data_error.lr1110_error = LR1110_CONFIGURATION_ERROR;
-        return receive_data_error;
+        nb_nibbles += 1;
+    }
+    else if (channel_mode == LR1110_FINGERPRINT_CHANNEL_PER_AP)
+    {
+        nb_nibbles += nb_networks;
     }
-    lr11xx_wifi_scan(NULL, LR11XX_WIFI_TYPE_SCAN_B_G_N,
-                     0x3FFF, LR11XX_WIFI_SCAN_MODE_BEACON,
-                     LR11XX_WIFI_MAX_RESULTS, LR11XX_WIFI_MAX_RESULTS,
-                     10, false);
 
-    lr11xx_wifi_get_nb_results(NULL, &nb_results);
+    return LR1110_FINGERPRINT_HEADER_SIZE + nb_networks * MAC_SIZE + (nb_nibbles + 1) / 2;
+}
 
-    lr11xx_wifi_basic_mac_type_channel_result_t results[LR11XX_WIFI_MAX_RESULTS];
-    printf("Number of Wi-Fi networks found before filtering: %d\n", nb_results);
-    if (nb_results == 0)
+/**
+ * Escreve um nibble na posição nibble_index da área de nibbles, o nibble alto de cada byte primeiro.
+ */
+static void LR1110_Fingerprint_Put_Nibble(uint8_t *nibbles, const uint8_t nibble_index, const uint8_t value)
+{
+    if ((nibble_index & 1) == 0)
     {
-        printf("ERROR_LR1110: No Wi-Fi found!\n");
-        receive_data_error.lr1110_error = LR1110_NO_WIFI_FOUND;
-        return receive_data_error;
+        nibbles[nibble_index / 2] = (uint8_t)(value << 4);
+    }
+    else
+    {
+        nibbles[nibble_index / 2] |= value & 0x0F;
+    }
+}
+
+static uint8_t LR1110_Fingerprint_Get_Nibble(const uint8_t *nibbles, const uint8_t nibble_index)
+{
+    return ((nibble_index & 1) == 0) ? (nibbles[nibble_index / 2] >> 4) : (nibbles[nibble_index / 2] & 0x0F);
+}
+
+/**
+ * Codifica as redes lidas por HE_NetworkReading em um fingerprint compacto para o payload de uplink LoRaWAN.
+ *
+ * Formato (LR1110_FINGERPRINT_VERSION 1):
+ *  - 1 byte de cabeçalho: versão (bits 7:6), modo de canal (bits 5:4), número de redes (bits 3:0);
+ *  - o MAC de cada rede, 6 bytes;
+ *  - nibbles, o alto de cada byte primeiro: o canal comum (modo COMMON), depois para cada rede o RSSI quantizado
+ *    seguido do seu canal (modo PER_AP). O último byte é completado com zero.
+ * O canal é omitido quando todas as redes estão no mesmo canal (enviado uma vez) ou quando with_channels é false.
+ * Com 6 redes: 40 bytes sem canal, 41 com canal comum e 43 com canal por rede, contra 48 bytes na estrutura.
+ *
+ * @param networks Redes a codificar, na ordem de prioridade: as primeiras são mantidas se o payload for pequeno.
+ * @param with_channels false para omitir os canais, que não são usados pelos solvers de geolocalização.
+ * @param payload Buffer de saída.
+ * @param payload_size Tamanho do buffer, por exemplo o payload máximo do data rate de uplink atual.
+ * @return Número de bytes escritos, 0 se nem o cabeçalho couber.
+ */
+uint8_t HE_WifiFingerprintEncode(const LR1110ResponseNetworksToDevice_t *networks, const bool with_channels,
+                                 uint8_t *payload, const uint8_t payload_size)
+{
+    uint8_t nb_networks = networks->network_count;
+
+    if (nb_networks > NETWORKS_NUMBER)
+    {
+        nb_networks = NETWORKS_NUMBER;
+    }
+    if (nb_networks > LR1110_FINGERPRINT_MAX_NETWORKS)
+    {
+        nb_networks = LR1110_FINGERPRINT_MAX_NETWORKS;
     }
-    lr11xx_wifi_read_basic_mac_type_channel_results(NULL, 0, nb_results, results);
 
-    int i = 0;
-    int j = 0;
-    while ((j < nb_results) && i < nb_results)
+    // Reduz o número de redes até o fingerprint caber no payload
+    uint8_t channel_mode = LR1110_FINGERPRINT_CHANNEL_NONE;
+    while (true)
     {
-        if (!(results[i].mac_address[0] & 0x02))
+        channel_mode = LR1110_FINGERPRINT_CHANNEL_NONE;
+        if ((with_channels == true) && (nb_networks > 0))
         {
-            if ((results[i].mac_address[0] != 0x00) || (results[i].mac_address[1] != 0x00) || (results[i].mac_address[2] != 0x5e))
+            channel_mode = LR1110_FINGERPRINT_CHANNEL_COMMON;
+            for (uint8_t i = 1; i < nb_networks; i++)
             {
-                receive_data.networks[j].rssi = results[i].rssi;
-                receive_data.networks[j].channel = results[i].channel_info_byte;
-                for (int k = 0; k <= MAC_SIZE - 1; k++)
+                if ((networks->networks[i].channel & 0x0F) != (networks->networks[0].channel & 0x0F))
                 {
-                    receive_data.networks[j].mac[k] = results[i].mac_address[k];
+                    channel_mode = LR1110_FINGERPRINT_CHANNEL_PER_AP;
+                    break;
                 }
-                j++;
             }
         }
-        i++;
+
+        if (LR1110_Fingerprint_Size(nb_networks, channel_mode) <= payload_size)
+        {
+            break;
+        }
+        if (nb_networks == 0)
+        {
+            return 0;
+        }
+        nb_networks--;
     }
 
-    LR1110_Fill_Empty_Networks(&receive_data);
+    payload[0] = (uint8_t)((LR1110_FINGERPRINT_VERSION << 6) | (channel_mode << 4) | nb_networks);
 
-    if (j <= 6)
+    for (uint8_t i = 0; i < nb_networks; i++)
     {
-        receive_data.network_count = j;
+        memcpy(&payload[LR1110_FINGERPRINT_HEADER_SIZE + i * MAC_SIZE], networks->networks[i].mac, MAC_SIZE);
     }
-    else
+
+    uint8_t *nibbles = &payload[LR1110_FINGERPRINT_HEADER_SIZE + nb_networks * MAC_SIZE];
+    uint8_t nibble_index = 0;
+
+    if (channel_mode == LR1110_FINGERPRINT_CHANNEL_COMMON)
     {
-        receive_data.network_count = 6;
+        LR1110_Fingerprint_Put_Nibble(nibbles, nibble_index++, networks->networks[0].channel & 0x0F);
     }
 
-    // Retorna as informações de redes WiFi recebidas
-    receive_data.lr1110_error = LR1110_SUCCESS;
-    return receive_data;
+    for (uint8_t i = 0; i < nb_networks; i++)
+    {
+        // O campo rssi guarda o valor em dBm (int8_t) lido do LR1110
+        int16_t level = ((int16_t)(int8_t)networks->networks[i].rssi - LR1110_FINGERPRINT_RSSI_MIN_DBM +
+                         LR1110_FINGERPRINT_RSSI_STEP_DB / 2) /
+                        LR1110_FINGERPRINT_RSSI_STEP_DB;
+
+        if (level < 0)
+        {
+            level = 0;
+        }
+        else if (level > 15)
+        {
+            level = 15;
+        }
+
+        LR1110_Fingerprint_Put_Nibble(nibbles, nibble_index++, (uint8_t)level);
+        if (channel_mode == LR1110_FINGERPRINT_CHANNEL_PER_AP)
+        {
+            LR1110_Fingerprint_Put_Nibble(nibbles, nibble_index++, networks->networks[i].channel & 0x0F);
+        }
+    }
+
+    // Completa o último byte quando o número de nibbles é ímpar
+    if ((nibble_index & 1) == 1)
+    {
+        LR1110_Fingerprint_Put_Nibble(nibbles, nibble_index, 0);
+    }
+
+    return LR1110_Fingerprint_Size(nb_networks, channel_mode);
+}
+
+/**
+ * Decodifica um fingerprint gerado por HE_WifiFingerprintEncode, por exemplo para validá-lo no host.
+ *
+ * O RSSI volta como o centro do degrau de quantização e o canal como o número do canal (bits 3:0 do
+ * channel_info_byte), sem a origem do MAC. Canais omitidos voltam como 0.
+ *
+ * @param payload Fingerprint recebido.
+ * @param payload_size Tamanho do fingerprint.
+ * @param networks Estrutura preenchida com as redes decodificadas.
+ * @return LR1110_SUCCESS ou LR1110_FINGERPRINT_FORMAT_ERROR se o fingerprint for inválido.
+ */
+uint8_t HE_WifiFingerprintDecode(const uint8_t *payload, const uint8_t payload_size,
+                                 LR1110ResponseNetworksToDevice_t *networks)
+{
+    const LR1110ResponseNetworksToDevice_t empty = LR1110RESPONSENETWORKSTODEVICE_T_INITIALIZER;
+
+    *networks = empty;
+
+    if (payload_size < LR1110_FINGERPRINT_HEADER_SIZE)
+    {
+        return LR1110_FINGERPRINT_FORMAT_ERROR;
+    }
+
+    const uint8_t version = payload[0] >> 6;
+    const uint8_t channel_mode = (payload[0] >> 4) & 0x03;
+    const uint8_t nb_networks = payload[0] & 0x0F;
+
+    if ((version != LR1110_FINGERPRINT_VERSION) || (channel_mode > LR1110_FINGERPRINT_CHANNEL_PER_AP) ||
+        (nb_networks > NETWORKS_NUMBER) || (LR1110_Fingerprint_Size(nb_networks, channel_mode) != payload_size))
+    {
+        return LR1110_FINGERPRINT_FORMAT_ERROR;
+    }
+
+    const uint8_t *nibbles = &payload[LR1110_FINGERPRINT_HEADER_SIZE + nb_networks * MAC_SIZE];
+    uint8_t nibble_index = 0;
+    uint8_t common_channel = 0;
+
+    if (channel_mode == LR1110_FINGERPRINT_CHANNEL_COMMON)
+    {
+        common_channel = LR1110_Fingerprint_Get_Nibble(nibbles, nibble_index++);
+    }
+
+    for (uint8_t i = 0; i < nb_networks; i++)
+    {
+        LR1110_wifi_t *network = &networks->networks[i];
+
+        memcpy(network->mac, &payload[LR1110_FINGERPRINT_HEADER_SIZE + i * MAC_SIZE], MAC_SIZE);
+        network->rssi = (uint8_t)(int8_t)(LR1110_FINGERPRINT_RSSI_MIN_DBM +
+                                          LR1110_Fingerprint_Get_Nibble(nibbles, nibble_index++) *
+                                              LR1110_FINGERPRINT_RSSI_STEP_DB);
+        network->channel = common_channel;
+        if (channel_mode == LR1110_FINGERPRINT_CHANNEL_PER_AP)
+        {
+            network->channel = LR1110_Fingerprint_Get_Nibble(nibbles, nibble_index++);
+        }
+    }
+
+    networks->network_count = nb_networks;
+    networks->lr1110_error = LR1110_SUCCESS;
+
+    return LR1110_SUCCESS;
+}
+
+/**
+ * Inicializa um cache de redes vazio.
+ *
+ * @param cache Cache a inicializar.
+ * @param max_age_ms Tempo sem ser vista após o qual uma rede é removida e informada como perdida.
+ * @param rssi_delta_db Diferença do RSSI médio para o último informado a partir da qual a rede é informada como
+ * movida.
+ */
+void HE_ApCacheInit(LR1110_ap_cache_t *cache, const uint32_t max_age_ms, const uint8_t rssi_delta_db)
+{
+    memset(cache, 0, sizeof(LR1110_ap_cache_t));
+    cache->max_age_ms = max_age_ms;
+    cache->rssi_delta_db = rssi_delta_db;
+}
+
+static uint8_t LR1110_Ap_Cache_Hash(const uint8_t *mac)
+{
+    // FNV-1a sobre os 6 bytes, o OUI sozinho se repete demais entre redes próximas
+    uint32_t hash = 2166136261u;
+
+    for (uint8_t i = 0; i < MAC_SIZE; i++)
+    {
+        hash = (hash ^ mac[i]) * 16777619u;
+    }
+
+    return (uint8_t)(hash & (LR1110_AP_CACHE_CAPACITY - 1));
+}
+
+/**
+ * Procura o MAC com sondagem linear. A ocupação limitada a LR1110_AP_CACHE_MAX_ENTRIES garante uma posição livre.
+ *
+ * @return Posição do MAC se is_found, senão a posição livre onde inseri-lo.
+ */
+static uint8_t LR1110_Ap_Cache_Probe(const LR1110_ap_cache_t *cache, const uint8_t *mac, bool *is_found)
+{
+    uint8_t slot = LR1110_Ap_Cache_Hash(mac);
+
+    while (cache->entries[slot].is_used == true)
+    {
+        if (memcmp(cache->entries[slot].mac, mac, MAC_SIZE) == 0)
+        {
+            *is_found = true;
+            return slot;
+        }
+        slot = (slot + 1) & (LR1110_AP_CACHE_CAPACITY - 1);
+    }
+
+    *is_found = false;
+    return slot;
+}
+
+// Remoção com deslocamento para trás, sem marcadores de posição removida que alongariam as sondagens
+static void LR1110_Ap_Cache_Remove(LR1110_ap_cache_t *cache, uint8_t slot)
+{
+    uint8_t next = slot;
+
+    cache->entries[slot].is_used = false;
+    cache->nb_entries--;
+
+    while (true)
+    {
+        next = (next + 1) & (LR1110_AP_CACHE_CAPACITY - 1);
+        if (cache->entries[next].is_used == false)
+        {
+            return;
+        }
+
+        const uint8_t home = LR1110_Ap_Cache_Hash(cache->entries[next].mac);
+        const bool can_move = (next > slot) ? ((home <= slot) || (home > next)) : ((home <= slot) && (home > next));
+
+        if (can_move == true)
+        {
+            cache->entries[slot] = cache->entries[next];
+            cache->entries[next].is_used = false;
+            slot = next;
+        }
+    }
+}
+
+// RSSI médio arredondado para o dBm mais próximo
+static int8_t LR1110_Ap_Cache_Rssi(const LR1110_ap_cache_entry_t *entry)
+{
+    return (int8_t)((entry->rssi_q4 >= 0) ? ((entry->rssi_q4 + 8) / 16) : ((entry->rssi_q4 - 8) / 16));
+}
+
+static void LR1110_Ap_Cache_Report(LR1110_ap_change_t *changes, const uint8_t max_changes, uint8_t *nb_changes,
+                                   const LR1110_ap_cache_entry_t *entry, const LR1110_ap_change_type_t type)
+{
+    if ((changes != NULL) && (*nb_changes < max_changes))
+    {
+        LR1110_ap_change_t *change = &changes[*nb_changes];
+
+        memcpy(change->mac, entry->mac, MAC_SIZE);
+        change->type = type;
+        change->rssi = LR1110_Ap_Cache_Rssi(entry);
+        change->channel_info_byte = entry->channel_info_byte;
+    }
+    (*nb_changes)++;
+}
+
+/**
+ * Atualiza o cache com os resultados de um scan e informa o que mudou desde a atualização anterior: redes novas,
+ * redes não vistas há mais de max_age_ms e redes cujo RSSI médio se afastou do último informado.
+ *
+ * As redes rejeitadas pelo pipeline de filtros atual são ignoradas. Com o cache cheio, a rede vista há mais tempo é
+ * removida e informada como perdida.
+ *
+ * @param cache Cache inicializado por HE_ApCacheInit.
+ * @param results Resultados do scan.
+ * @param nb_results Número de resultados.
+ * @param now_ms Instante do scan, em milissegundos, de um relógio que pode dar a volta em 32 bits.
+ * @param changes Vetor preenchido com as mudanças, pode ser NULL.
+ * @param max_changes Tamanho do vetor changes, as mudanças além dele são apenas contadas.
+ * @return Número de mudanças, 0 se nada mudou e o envio pode ser evitado.
+ */
+uint8_t HE_ApCacheUpdate(LR1110_ap_cache_t *cache, const lr11xx_wifi_basic_mac_type_channel_result_t *results,
+                         const uint8_t nb_results, const uint32_t now_ms, LR1110_ap_change_t *changes,
+                         const uint8_t max_changes)
+{
+    uint8_t nb_changes = 0;
+    bool is_found = false;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const LR1110_filter_candidate_t candidate = LR1110_Filter_Candidate(&results[i]);
+
+        if (HE_FilterAccepts(filter_pipeline, &candidate) == false)
+        {
+            continue;
+        }
+
+        uint8_t slot = LR1110_Ap_Cache_Probe(cache, results[i].mac_address, &is_found);
+        LR1110_ap_cache_entry_t *entry = &cache->entries[slot];
+
+        if (is_found == true)
+        {
+            entry->rssi_q4 += (int16_t)((results[i].rssi * 16 - entry->rssi_q4) / (1 << LR1110_AP_CACHE_EWMA_SHIFT));
+            entry->channel_info_byte = results[i].channel_info_byte;
+            entry->last_seen_ms = now_ms;
+            if (entry->hits < UINT16_MAX)
+            {
+                entry->hits++;
+            }
+
+            const int8_t rssi = LR1110_Ap_Cache_Rssi(entry);
+
+            if (abs(rssi - entry->reported_rssi) >= cache->rssi_delta_db)
+            {
+                entry->reported_rssi = rssi;
+                LR1110_Ap_Cache_Report(changes, max_changes, &nb_changes, entry, LR1110_AP_CHANGE_MOVED);
+            }
+            continue;
+        }
+
+        if (cache->nb_entries >= LR1110_AP_CACHE_MAX_ENTRIES)
+        {
+            uint8_t oldest = 0;
+
+            for (uint8_t k = 0; k < LR1110_AP_CACHE_CAPACITY; k++)
+            {
+                if ((cache->entries[k].is_used == true) &&
+                    ((cache->entries[oldest].is_used == false) ||
+                     ((int32_t)(cache->entries[k].last_seen_ms - cache->entries[oldest].last_seen_ms) < 0)))
+                {
+                    oldest = k;
+                }
+            }
+            LR1110_Ap_Cache_Report(changes, max_changes, &nb_changes, &cache->entries[oldest], LR1110_AP_CHANGE_LOST);
+            LR1110_Ap_Cache_Remove(cache, oldest);
+            slot = LR1110_Ap_Cache_Probe(cache, results[i].mac_address, &is_found);
+            entry = &cache->entries[slot];
+        }
+
+        memcpy(entry->mac, results[i].mac_address, MAC_SIZE);
+        entry->is_used = true;
+        entry->channel_info_byte = results[i].channel_info_byte;
+        entry->rssi_q4 = (int16_t)(results[i].rssi * 16);
+        entry->reported_rssi = results[i].rssi;
+        entry->hits = 1;
+        entry->last_seen_ms = now_ms;
+        cache->nb_entries++;
+        LR1110_Ap_Cache_Report(changes, max_changes, &nb_changes, entry, LR1110_AP_CHANGE_NEW);
+    }
+
+    for (uint8_t slot = 0; slot < LR1110_AP_CACHE_CAPACITY; slot++)
+    {
+        // A remoção pode trazer outra rede para esta posição, que também precisa ser verificada
+        while ((cache->entries[slot].is_used == true) &&
+               ((now_ms - cache->entries[slot].last_seen_ms) > cache->max_age_ms))
+        {
+            LR1110_Ap_Cache_Report(changes, max_changes, &nb_changes, &cache->entries[slot], LR1110_AP_CHANGE_LOST);
+            LR1110_Ap_Cache_Remove(cache, slot);
+        }
+    }
+
+    cache->nb_last_changes = nb_changes;
+
+    return nb_changes;
+}
+
+/**
+ * Procura uma rede no cache.
+ *
+ * @return Entrada da rede ou NULL se ela não está no cache.
+ */
+const LR1110_ap_cache_entry_t *HE_ApCacheFind(const LR1110_ap_cache_t *cache, const uint8_t *mac)
+{
+    bool is_found = false;
+    const uint8_t slot = LR1110_Ap_Cache_Probe(cache, mac, &is_found);
+
+    return (is_found == true) ? &cache->entries[slot] : NULL;
+}
+
+/**
+ * Define o cache atualizado a cada HE_NetworkReadingOnRadio do rádio indicado, para que o dispositivo deixe de enviar
+ * as redes quando nada mudou (ver HE_ApCacheHasChanged). Cada rádio tem o seu cache, as redes vistas por um não
+ * mudam o histórico do outro.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa (HE_NetworkReading).
+ * @param cache Cache inicializado por HE_ApCacheInit, NULL para desativar. Não pode ser compartilhado entre rádios.
+ * @return false se LR1110_MAX_RADIOS rádios já têm um estado associado, caso em que o cache não é usado.
+ */
+bool HE_SetApCache(const void *context, LR1110_ap_cache_t *cache)
+{
+    LR1110_radio_state_t *radio = LR1110_Radio_State(context, cache != NULL);
+
+    if (radio == NULL)
+    {
+        return cache == NULL;
+    }
+
+    radio->ap_cache = cache;
+
+    return true;
+}
+
+/**
+ * Indica se a última leitura do rádio mudou o conjunto de redes do cache definido por HE_SetApCache.
+ *
+ * @param context Contexto do rádio, NULL para o LR1110 padrão da placa.
+ * @return true se houve mudança ou se o rádio não tem cache definido.
+ */
+bool HE_ApCacheHasChanged(const void *context)
+{
+    const LR1110_radio_state_t *radio = LR1110_Radio_State(context, false);
+
+    return (radio == NULL) || (radio->ap_cache == NULL) || (radio->ap_cache->nb_last_changes != 0);
 }
 
 /**
@@ -154,7 +2182,7 @@ void LR1110_Fill_Empty_Networks(LR1110ResponseNetworksToDevice_t *receive_data)
     }
 }
 
-bool LR1110_Read_Version_Status(void)
+bool LR1110_Read_Version_Status(const void *context)
 {
     lr11xx_bootloader_version_t version;
 
@@ -164,7 +2192,7 @@ bool LR1110_Read_Version_Status(void)
 
     // lr11xx_status_t status;
 
-    lr11xx_bootloader_get_version(NULL, &version);
+    lr11xx_bootloader_get_version(context, &version);
 
     // printf("LR1110_FW_Version: %.04X \n", version.fw);
 
@@ -179,39 +2207,51 @@ bool LR1110_Read_Version_Status(void)
     return TRUE;
 }
 
-bool LR1110_Configure(void)
+bool LR1110_Configure(const void *context)
 {
     // lr11xx_system_set_reg_mode(NULL, LR11XX_SYSTEM_REG_MODE_DCDC);
     // lr11xx_system_set_dio_as_rf_switch(NULL, &smtc_shield_lr11xx_common_rf_switch_cfg);
     // lr11xx_system_set_tcxo_mode(NULL, LR11XX_SYSTEM_TCXO_CTRL_3_3V, 300);
     // lr11xx_system_cfg_lfclk(NULL, LR11XX_SYSTEM_LFCLK_XTAL, true);
-    lr11xx_system_set_reg_mode(NULL, LR11XX_SYSTEM_REG_MODE_LDO);
-    lr11xx_system_set_dio_as_rf_switch(NULL, &smtc_shield_lr11xx_common_rf_switch_cfg);
-    lr11xx_system_set_tcxo_mode(NULL, LR11XX_SYSTEM_TCXO_CTRL_3_3V, 300);
-    lr11xx_system_cfg_lfclk(NULL, LR11XX_SYSTEM_LFCLK_RC, true);
+
+    // The configuration writes are queued and sent back-to-back, get_errors flushes the queue before reading
+    lr11xx_hal_batch_begin(context);
+
+    lr11xx_system_set_reg_mode(context, LR1110_REG_MODE);
+    lr11xx_system_set_dio_as_rf_switch(context, &smtc_shield_lr11xx_common_rf_switch_cfg);
+    lr11xx_system_set_tcxo_mode(context, LR11XX_SYSTEM_TCXO_CTRL_3_3V, 300);
+    lr11xx_system_cfg_lfclk(context, LR11XX_SYSTEM_LFCLK_RC, true);
 
     // printf("clear\n");
 
-    lr11xx_system_clear_errors(NULL);
+    lr11xx_system_clear_errors(context);
 
     // printf("calib\n");
-    lr11xx_system_calibrate(NULL, 0x3F);
+    lr11xx_system_calibrate(context, 0x3F);
 
     // printf("erros\n");
-    uint16_t errors;
-    lr11xx_system_get_errors(NULL, &errors);
+    uint16_t errors = 0;
+    lr11xx_system_get_errors(context, &errors);
     // printf("erros: %x\n", errors);
-    if (errors != 0)
+    if ((lr11xx_hal_batch_submit(context) != LR11XX_HAL_STATUS_OK) || (errors != 0))
     {
         printf("ERROR_LR1110: Configure Error - 0x%02X\n", errors);
         return FALSE;
     }
 
-    lr11xx_system_clear_errors(NULL);
-    lr11xx_system_clear_irq_status(NULL, LR11XX_SYSTEM_IRQ_ALL_MASK);
+    lr11xx_hal_batch_begin(context);
 
-    lr11xx_system_set_dio_irq_params(NULL, LR11XX_SYSTEM_IRQ_WIFI_SCAN_DONE, 0);
-    lr11xx_system_clear_irq_status(NULL, LR11XX_SYSTEM_IRQ_ALL_MASK);
+    lr11xx_system_clear_errors(context);
+    lr11xx_system_clear_irq_status(context, LR11XX_SYSTEM_IRQ_ALL_MASK);
+
+    lr11xx_system_set_dio_irq_params(context, LR11XX_SYSTEM_IRQ_WIFI_SCAN_DONE, 0);
+    lr11xx_system_clear_irq_status(context, LR11XX_SYSTEM_IRQ_ALL_MASK);
+
+    if (lr11xx_hal_batch_submit(context) != LR11XX_HAL_STATUS_OK)
+    {
+        printf("ERROR_LR1110: Configure Error - SPI\n");
+        return FALSE;
+    }
 
     const bool is_compatible = lr11xx_wifi_are_scan_mode_result_format_compatible(LR11XX_WIFI_SCAN_MODE_BEACON, LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE);
 
@@ -307,7 +2347,7 @@ void teste_lr1110(void)
 
         printf("scanning...\n");
         lr11xx_wifi_scan(NULL, LR11XX_WIFI_TYPE_SCAN_B_G_N,
-                         0x3FFF, LR11XX_WIFI_SCAN_MODE_BEACON,
+                         LR1110_WIFI_ALL_CHANNELS_MASK, LR11XX_WIFI_SCAN_MODE_BEACON,
                          LR11XX_WIFI_MAX_RESULTS, LR11XX_WIFI_MAX_RESULTS,
                          10, false);
 
@@ -327,14 +2367,13 @@ void teste_lr1110(void)
             int j = 0;
             while ((j < nb_results) && i < nb_results)
             {
-                if (!(results[i].mac_address[0] & 0x02))
+                const LR1110_filter_candidate_t candidate = LR1110_Filter_Candidate(&results[i]);
+
+                if (HE_FilterAccepts(filter_pipeline, &candidate) == true)
                 {
-                    if ((results[i].mac_address[0] != 0x00) || (results[i].mac_address[1] != 0x00) || (results[i].mac_address[2] != 0x5e))
-                    {
-                        printf("%x:%x:%x:%x:%x:%x      rssi: %d%    Channel: %d\n", results[i].mac_address[0], results[i].mac_address[1], results[i].mac_address[2],
-                               results[i].mac_address[3], results[i].mac_address[4], results[i].mac_address[5], results[i].rssi, results[i].channel_info_byte);
-                        j++;
-                    }
+                    printf("%x:%x:%x:%x:%x:%x      rssi: %d%    Channel: %d\n", results[i].mac_address[0], results[i].mac_address[1], results[i].mac_address[2],
+                           results[i].mac_address[3], results[i].mac_address[4], results[i].mac_address[5], results[i].rssi, results[i].channel_info_byte);
+                    j++;
                 }
                 i++;
             }
@@ -188,19 +188,8 @@ lr11xx_status_t lr11xx_bootloader_write_flash_encrypted(const void *context, con
         (uint8_t)(offset >> 0),
     };
 
-    uint8_t cdata[256] = {0};
-    for (uint8_t index = 0; index < length; index++)
-    {
-        uint8_t *cdata_local = &cdata[index * sizeof(uint32_t)];
-
-        cdata_local[0] = (uint8_t)(data[index] >> 24);
-        cdata_local[1] = (uint8_t)(data[index] >> 16);
-        cdata_local[2] = (uint8_t)(data[index] >> 8);
-        cdata_local[3] = (uint8_t)(data[index] >> 0);
-    }
-
-    return (lr11xx_status_t)lr11xx_hal_write(context, cbuffer, LR11XX_BL_WRITE_FLASH_ENCRYPTED_CMD_LENGTH, cdata,
-                                             length * sizeof(uint32_t));
+    return (lr11xx_status_t)lr11xx_hal_write_be32(context, cbuffer, LR11XX_BL_WRITE_FLASH_ENCRYPTED_CMD_LENGTH, data,
+                                                  length);
 }
 
 lr11xx_status_t lr11xx_bootloader_write_flash_encrypted_full(const void *context, const uint32_t offset,
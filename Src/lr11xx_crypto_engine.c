@@ -499,19 +499,8 @@ lr11xx_status_t lr11xx_crypto_check_encrypted_firmware_image(const void *context
         (uint8_t)(offset_in_byte >> 0),
     };
 
-    uint8_t cdata[256] = {0};
-    for (uint8_t index = 0; index < length_in_word; index++)
-    {
-        uint8_t *cdata_local = &cdata[index * sizeof(uint32_t)];
-
-        cdata_local[0] = (uint8_t)(data[index] >> 24);
-        cdata_local[1] = (uint8_t)(data[index] >> 16);
-        cdata_local[2] = (uint8_t)(data[index] >> 8);
-        cdata_local[3] = (uint8_t)(data[index] >> 0);
-    }
-
-    return (lr11xx_status_t)lr11xx_hal_write(context, cbuffer, LR11XX_CRYPTO_CHECK_ENCRYPTED_FW_IMAGE_CMD_LENGTH,
-                                             cdata, length_in_word * sizeof(uint32_t));
+    return (lr11xx_status_t)lr11xx_hal_write_be32(context, cbuffer, LR11XX_CRYPTO_CHECK_ENCRYPTED_FW_IMAGE_CMD_LENGTH,
+                                                  data, length_in_word);
 }
 
 lr11xx_status_t lr11xx_crypto_check_encrypted_firmware_image_full(const void *context, const uint32_t offset_in_byte,
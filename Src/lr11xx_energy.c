@@ -0,0 +1,210 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      lr11xx_energy.c
+ *
+ * @brief     Charge estimation of the LR11XX activities
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include "LR1110_Driver/lr11xx_energy.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*!
+ * @brief nAh drawn per microsecond at a current of ua, in unsigned Q0.32
+ *
+ * uA * us / 3600000 gives nAh: the division is folded into the coefficient at compile time.
+ */
+#define LR11XX_ENERGY_NAH_PER_US_Q32(ua) ((uint32_t)((((uint64_t)(ua) << 32) + 1800000) / 3600000))
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*!
+ * @brief Battery current of each activity with the DC-DC regulator
+ *
+ * @note these numbers are given for information, it should be modified according to the used hardware.
+ */
+#define LR11XX_ENERGY_DCDC_WIFI_CORRELATION_UA (12000)
+#define LR11XX_ENERGY_DCDC_WIFI_CAPTURE_UA (12000)
+#define LR11XX_ENERGY_DCDC_WIFI_DEMODULATION_UA (4000)
+#define LR11XX_ENERGY_DCDC_GNSS_CAPTURE_UA (5000)
+#define LR11XX_ENERGY_DCDC_GNSS_PROCESSING_UA (3000)
+#define LR11XX_ENERGY_DCDC_LORA_RX_UA (5400)
+#define LR11XX_ENERGY_DCDC_LORA_TX_LP_14_DBM_UA (24000)
+#define LR11XX_ENERGY_DCDC_LORA_TX_HP_22_DBM_UA (118000)
+#define LR11XX_ENERGY_DCDC_CRYPTO_UA (2500)
+
+/*!
+ * @brief Battery current of each activity with the LDO regulator
+ *
+ * The LDO draws about twice the DC-DC battery current. The high-power PA is supplied from VBAT and does not depend
+ * on the regulator.
+ */
+#define LR11XX_ENERGY_LDO_FACTOR (2)
+#define LR11XX_ENERGY_LDO_LORA_TX_HP_22_DBM_UA LR11XX_ENERGY_DCDC_LORA_TX_HP_22_DBM_UA
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static const uint32_t lr11xx_energy_current_ua[2][LR11XX_ENERGY_NB_ACTIVITIES] = {
+    [LR11XX_SYSTEM_REG_MODE_LDO] =
+        {
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_CORRELATION_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_CAPTURE_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_DEMODULATION_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_GNSS_CAPTURE_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_GNSS_PROCESSING_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_LORA_RX_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_LORA_TX_LP_14_DBM_UA,
+            LR11XX_ENERGY_LDO_LORA_TX_HP_22_DBM_UA,
+            LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_CRYPTO_UA,
+        },
+    [LR11XX_SYSTEM_REG_MODE_DCDC] =
+        {
+            LR11XX_ENERGY_DCDC_WIFI_CORRELATION_UA,
+            LR11XX_ENERGY_DCDC_WIFI_CAPTURE_UA,
+            LR11XX_ENERGY_DCDC_WIFI_DEMODULATION_UA,
+            LR11XX_ENERGY_DCDC_GNSS_CAPTURE_UA,
+            LR11XX_ENERGY_DCDC_GNSS_PROCESSING_UA,
+            LR11XX_ENERGY_DCDC_LORA_RX_UA,
+            LR11XX_ENERGY_DCDC_LORA_TX_LP_14_DBM_UA,
+            LR11XX_ENERGY_DCDC_LORA_TX_HP_22_DBM_UA,
+            LR11XX_ENERGY_DCDC_CRYPTO_UA,
+        },
+};
+
+/*!
+ * @brief Reciprocal coefficients of lr11xx_energy_current_ua, see LR11XX_ENERGY_NAH_PER_US_Q32
+ */
+static const uint32_t lr11xx_energy_nah_per_us_q32[2][LR11XX_ENERGY_NB_ACTIVITIES] = {
+    [LR11XX_SYSTEM_REG_MODE_LDO] =
+        {
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_CORRELATION_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_CAPTURE_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_WIFI_DEMODULATION_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_GNSS_CAPTURE_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_GNSS_PROCESSING_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_LORA_RX_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_LORA_TX_LP_14_DBM_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_LORA_TX_HP_22_DBM_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_LDO_FACTOR * LR11XX_ENERGY_DCDC_CRYPTO_UA),
+        },
+    [LR11XX_SYSTEM_REG_MODE_DCDC] =
+        {
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_WIFI_CORRELATION_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_WIFI_CAPTURE_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_WIFI_DEMODULATION_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_GNSS_CAPTURE_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_GNSS_PROCESSING_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_LORA_RX_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_LORA_TX_LP_14_DBM_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_LORA_TX_HP_22_DBM_UA),
+            LR11XX_ENERGY_NAH_PER_US_Q32(LR11XX_ENERGY_DCDC_CRYPTO_UA),
+        },
+};
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * @brief Get the coefficient row of a regulator, the DC-DC one for an unknown regulator
+ */
+static const uint32_t *lr11xx_energy_get_coefficients(const lr11xx_system_reg_mode_t regulator);
+
+/*!
+ * @brief Round a charge in nAh given in Q32.32 to the nearest nAh
+ */
+static uint32_t lr11xx_energy_round_q32(const uint64_t charge_nah_q32);
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+uint32_t lr11xx_energy_get_current_ua(const lr11xx_system_reg_mode_t regulator,
+                                      const lr11xx_energy_activity_t activity)
+{
+    if (activity >= LR11XX_ENERGY_NB_ACTIVITIES)
+    {
+        return 0;
+    }
+
+    return lr11xx_energy_current_ua[(regulator == LR11XX_SYSTEM_REG_MODE_LDO) ? LR11XX_SYSTEM_REG_MODE_LDO
+                                                                              : LR11XX_SYSTEM_REG_MODE_DCDC][activity];
+}
+
+uint32_t lr11xx_energy_get_charge_nah(const lr11xx_system_reg_mode_t regulator,
+                                      const lr11xx_energy_activity_t activity, const uint32_t duration_us)
+{
+    if (activity >= LR11XX_ENERGY_NB_ACTIVITIES)
+    {
+        return 0;
+    }
+
+    return lr11xx_energy_round_q32((uint64_t)duration_us * lr11xx_energy_get_coefficients(regulator)[activity]);
+}
+
+uint32_t lr11xx_energy_get_wifi_charge_nah(const lr11xx_system_reg_mode_t regulator,
+                                           const lr11xx_wifi_cumulative_timings_t *timing)
+{
+    const uint32_t *coefficients = lr11xx_energy_get_coefficients(regulator);
+
+    // Accumulated in Q32.32 and rounded once
+    return lr11xx_energy_round_q32(
+        ((uint64_t)timing->rx_correlation_us * coefficients[LR11XX_ENERGY_WIFI_CORRELATION]) +
+        ((uint64_t)timing->rx_capture_us * coefficients[LR11XX_ENERGY_WIFI_CAPTURE]) +
+        ((uint64_t)timing->demodulation_us * coefficients[LR11XX_ENERGY_WIFI_DEMODULATION]));
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static const uint32_t *lr11xx_energy_get_coefficients(const lr11xx_system_reg_mode_t regulator)
+{
+    return lr11xx_energy_nah_per_us_q32[(regulator == LR11XX_SYSTEM_REG_MODE_LDO) ? LR11XX_SYSTEM_REG_MODE_LDO
+                                                                                  : LR11XX_SYSTEM_REG_MODE_DCDC];
+}
+
+static uint32_t lr11xx_energy_round_q32(const uint64_t charge_nah_q32)
+{
+    return (uint32_t)((charge_nah_q32 + 0x80000000UL) >> 32);
+}
+
+/* --- EOF ------------------------------------------------------------------ */
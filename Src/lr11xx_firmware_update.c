@@ -37,8 +37,14 @@
  * --- DEPENDENCIES ------------------------------------------------------------
  */
 #include <stdio.h>
+#if defined(LR11XX_SIM)
+#include "LR1110_Driver/lr11xx_sim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#else
 #include "main.h"
 #include "HT_Fsm.h"
+#endif
 #include "LR1110_Driver/lr11xx_bootloader.h"
 #include "LR1110_Driver/lr11xx_system.h"
 #include "LR1110_Driver/lr11xx_firmware_update.h"
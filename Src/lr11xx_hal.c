@@ -1,105 +1,2239 @@
 
 #include "LR1110_Driver/lr11xx_hal.h"
+#include "LR1110_Driver/lr11xx_hal_context.h"
+#if defined(LR11XX_SIM)
+#include "LR1110_Driver/lr11xx_sim.h"
+#else
 #include "HT_gpio_qcx212.h"
 #include "HT_spi_qcx212.h"
-#include "stdio.h"
 #include "HT_GPIO_Api.h"
+#endif
+#include "stdio.h"
+#include "string.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/*!
+ * @brief Move each SPI phase (command, data, response) as one multi-byte transfer
+ *
+ * Set to 0 to fall back to the historical one-call-per-byte path.
+ */
+#ifndef LR11XX_HAL_SPI_BULK_TRANSFER
+#define LR11XX_HAL_SPI_BULK_TRANSFER (1)
+#endif
+
+/*!
+ * @brief Low-level full-duplex SPI transfer used by the HAL
+ *
+ * Boards with a DMA-capable SPI driver can map this to their DMA routine; it must block until the transfer is over.
+ */
+#ifndef LR11XX_HAL_SPI_TRANSFER
+#define LR11XX_HAL_SPI_TRANSFER(tx_buffer, rx_buffer, length) HT_SPI_TransmitReceive(tx_buffer, rx_buffer, length)
+#endif
+
+/*!
+ * @brief Size of the buffer that swallows MISO bytes while writing, i.e. the largest single write transfer
+ */
+#define LR11XX_HAL_SPI_DISCARD_BUFFER_SIZE (256)
+
+/*!
+ * @brief Number of words byte-swapped on the stack per SPI transfer by @ref lr11xx_hal_write_be32
+ */
+#ifndef LR11XX_HAL_SPI_BE32_CHUNK_WORDS
+#define LR11XX_HAL_SPI_BE32_CHUNK_WORDS (8)
+#endif
+
+/*!
+ * @brief Host word to big-endian word, a single REV instruction on Cortex-M
+ */
+#if defined(__GNUC__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define LR11XX_HAL_HTOBE32(word) __builtin_bswap32(word)
+#elif defined(__GNUC__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define LR11XX_HAL_HTOBE32(word) (word)
+#endif
+
+/*!
+ * @brief Sleep on a BUSY falling edge interrupt instead of polling the BUSY pin
+ *
+ * Requires the board to route the BUSY EXTI to @ref lr11xx_hal_busy_irq_handler.
+ */
+#ifndef LR11XX_HAL_BUSY_EXTI
+#define LR11XX_HAL_BUSY_EXTI (0)
+#endif
+
+/*!
+ * @brief Sleep on the IRQ DIO interrupt in lr11xx_hal_wait_irq instead of checking BUSY every tick
+ *
+ * Requires the board to route the IRQ DIO EXTI to @ref lr11xx_hal_dio_irq_handler.
+ */
+#ifndef LR11XX_HAL_DIO_EXTI
+#define LR11XX_HAL_DIO_EXTI (0)
+#endif
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES <= LR11XX_HAL_NOTIFY_INDEX)
+#error "configTASK_NOTIFICATION_ARRAY_ENTRIES must be greater than LR11XX_HAL_NOTIFY_INDEX"
+#endif
+
+/*!
+ * @brief Stack size, in words, and priority of the worker task executing asynchronous requests
+ */
+#ifndef LR11XX_HAL_ASYNC_TASK_STACK_SIZE
+#define LR11XX_HAL_ASYNC_TASK_STACK_SIZE (512)
+#endif
+
+#ifndef LR11XX_HAL_ASYNC_TASK_PRIORITY
+#define LR11XX_HAL_ASYNC_TASK_PRIORITY (tskIDLE_PRIORITY + 2)
+#endif
+
+/*!
+ * @brief Also check the command status after each write when CRC over SPI is enabled
+ *
+ * A corrupted write is only reported by the radio in the stat1 byte of the next transaction, so checking it costs an
+ * extra direct read per write. Do not enable it if set-sleep commands are sent while CRC over SPI is enabled: the
+ * direct read would wake the radio up.
+ */
+#ifndef LR11XX_HAL_CRC_CHECK_WRITES
+#define LR11XX_HAL_CRC_CHECK_WRITES (0)
+#endif
+
+/*!
+ * @brief Microsecond timestamp used by the instrumentation and the capture
+ *
+ * Tick resolution by default: map it to a free-running microsecond timer of the board to get meaningful transfer
+ * time histograms.
+ */
+#ifndef LR11XX_HAL_INSTR_TIMESTAMP_US
+#define LR11XX_HAL_INSTR_TIMESTAMP_US() ((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS * 1000))
+#endif
+
+/*!
+ * @brief Command status field of stat1 reporting a command received with a wrong CRC or length
+ */
+#define LR11XX_HAL_STAT1_CMD_PERR (0x01)
+#define LR11XX_HAL_STAT1_CMD_STATUS(stat1) (((stat1) >> 1) & 0x07)
+
+const uint8_t lr11xx_hal_crc_table[256] = {
+	0x00, 0x3C, 0x78, 0x44, 0x3B, 0x07, 0x43, 0x7F, 0x76, 0x4A, 0x0E, 0x32, 0x4D, 0x71, 0x35, 0x09,
+	0x27, 0x1B, 0x5F, 0x63, 0x1C, 0x20, 0x64, 0x58, 0x51, 0x6D, 0x29, 0x15, 0x6A, 0x56, 0x12, 0x2E,
+	0x4E, 0x72, 0x36, 0x0A, 0x75, 0x49, 0x0D, 0x31, 0x38, 0x04, 0x40, 0x7C, 0x03, 0x3F, 0x7B, 0x47,
+	0x69, 0x55, 0x11, 0x2D, 0x52, 0x6E, 0x2A, 0x16, 0x1F, 0x23, 0x67, 0x5B, 0x24, 0x18, 0x5C, 0x60,
+	0x57, 0x6B, 0x2F, 0x13, 0x6C, 0x50, 0x14, 0x28, 0x21, 0x1D, 0x59, 0x65, 0x1A, 0x26, 0x62, 0x5E,
+	0x70, 0x4C, 0x08, 0x34, 0x4B, 0x77, 0x33, 0x0F, 0x06, 0x3A, 0x7E, 0x42, 0x3D, 0x01, 0x45, 0x79,
+	0x19, 0x25, 0x61, 0x5D, 0x22, 0x1E, 0x5A, 0x66, 0x6F, 0x53, 0x17, 0x2B, 0x54, 0x68, 0x2C, 0x10,
+	0x3E, 0x02, 0x46, 0x7A, 0x05, 0x39, 0x7D, 0x41, 0x48, 0x74, 0x30, 0x0C, 0x73, 0x4F, 0x0B, 0x37,
+	0x65, 0x59, 0x1D, 0x21, 0x5E, 0x62, 0x26, 0x1A, 0x13, 0x2F, 0x6B, 0x57, 0x28, 0x14, 0x50, 0x6C,
+	0x42, 0x7E, 0x3A, 0x06, 0x79, 0x45, 0x01, 0x3D, 0x34, 0x08, 0x4C, 0x70, 0x0F, 0x33, 0x77, 0x4B,
+	0x2B, 0x17, 0x53, 0x6F, 0x10, 0x2C, 0x68, 0x54, 0x5D, 0x61, 0x25, 0x19, 0x66, 0x5A, 0x1E, 0x22,
+	0x0C, 0x30, 0x74, 0x48, 0x37, 0x0B, 0x4F, 0x73, 0x7A, 0x46, 0x02, 0x3E, 0x41, 0x7D, 0x39, 0x05,
+	0x32, 0x0E, 0x4A, 0x76, 0x09, 0x35, 0x71, 0x4D, 0x44, 0x78, 0x3C, 0x00, 0x7F, 0x43, 0x07, 0x3B,
+	0x15, 0x29, 0x6D, 0x51, 0x2E, 0x12, 0x56, 0x6A, 0x63, 0x5F, 0x1B, 0x27, 0x58, 0x64, 0x20, 0x1C,
+	0x7C, 0x40, 0x04, 0x38, 0x47, 0x7B, 0x3F, 0x03, 0x0A, 0x36, 0x72, 0x4E, 0x31, 0x0D, 0x49, 0x75,
+	0x5B, 0x67, 0x23, 0x1F, 0x60, 0x5C, 0x18, 0x24, 0x2D, 0x11, 0x55, 0x69, 0x16, 0x2A, 0x6E, 0x52,
+};
+
+/*!
+ * @brief Swallows MISO bytes while writing
+ *
+ * Shared by all radios: its content is never read, so concurrent transfers on separate buses may overwrite it freely.
+ */
+static uint8_t lr11xx_hal_spi_discard_buffer[LR11XX_HAL_SPI_DISCARD_BUFFER_SIZE];
+
+static void lr11xx_hal_default_spi_transfer(uint8_t *tx_buffer, uint8_t *rx_buffer, uint16_t length)
+{
+	LR11XX_HAL_SPI_TRANSFER(tx_buffer, rx_buffer, length);
+}
+
+/*!
+ * @brief SPI bus shared by one or more radios, identified by its transfer function
+ */
+typedef struct lr11xx_hal_bus_s
+{
+	lr11xx_hal_spi_transfer_t spi_transfer; //!< NULL for a free entry
+	lr11xx_hal_lock_t lock;                 //!< Held while the NSS line of one of its radios is low
+} lr11xx_hal_bus_t;
+
+/*!
+ * @brief SPI buses the radios are connected to, the default SPI bus first
+ */
+static lr11xx_hal_bus_t lr11xx_hal_buses[LR11XX_HAL_MAX_SPI_BUSES] = {
+	{.spi_transfer = lr11xx_hal_default_spi_transfer},
+};
+
+/*!
+ * @brief Radio used when the driver is called with a NULL context
+ */
+static lr11xx_hal_context_t lr11xx_hal_default_context = {
+	.spi_transfer = lr11xx_hal_default_spi_transfer,
+	.nss = {GPIO_NSS_LR1110_INSTANCE, GPIO_NSS_LR1110_PIN},
+	.busy = {GPIO_BUSY_LR1110_INSTANCE, GPIO_BUSY_LR1110_PIN},
+	.nreset = {GPIO_NRESET_LR1110_INSTANCE, GPIO_NRESET_LR1110_PIN},
+	.state = {
+		.busy_timeout_ms = LR11XX_HAL_BUSY_TIMEOUT_MS,
+		.bus_lock = &lr11xx_hal_buses[0].lock,
+	},
+};
+
+static QueueHandle_t lr11xx_hal_async_queue = NULL;
+
+/*!
+ * @brief Resolve the context given to the driver into a radio
+ *
+ * The driver API passes the context as const, while the HAL owns the run-time state stored in it.
+ */
+static lr11xx_hal_context_t *lr11xx_hal_get_context(const void *context)
+{
+	return (context != NULL) ? (lr11xx_hal_context_t *)context : &lr11xx_hal_default_context;
+}
+
+static void lr11xx_hal_lock_take(lr11xx_hal_lock_t *lock, lr11xx_hal_lock_stats_t *stats, const uint16_t length);
+static void lr11xx_hal_lock_give(lr11xx_hal_lock_t *lock);
+
+/*!
+ * @brief Select or release a radio on its SPI bus
+ *
+ * Selecting takes the bus lock, so that radios sharing a bus with separate NSS lines never interleave transfers.
+ */
+static void lr11xx_hal_nss_write(const lr11xx_hal_context_t *radio, const uint8_t value)
+{
+	if (value == PIN_OFF)
+	{
+		lr11xx_hal_lock_take(radio->state.bus_lock, NULL, 0);
+	}
+
+	HT_GPIO_WritePin(radio->nss.pin, radio->nss.instance, value);
+
+	if (value == PIN_ON)
+	{
+		lr11xx_hal_lock_give(radio->state.bus_lock);
+	}
+}
+
+static bool lr11xx_hal_is_busy(const lr11xx_hal_context_t *radio)
+{
+	return (HT_GPIO_PinRead(radio->busy.instance, radio->busy.pin) == 1) ? true : false;
+}
+
+/*!
+ * @brief Wait for the radio to release a BUSY line found high
+ *
+ * With LR11XX_HAL_BUSY_EXTI the calling task blocks on its LR11XX_HAL_NOTIFY_INDEX task notification, given by the
+ * BUSY falling edge interrupt, otherwise the pin is polled. In both cases the wait is bounded by the BUSY timeout of the radio.
+ */
+static lr11xx_hal_status_t lr11xx_hal_wait_busy_release(lr11xx_hal_context_t *radio)
+{
+	const TickType_t timeout_ticks = pdMS_TO_TICKS(radio->state.busy_timeout_ms);
+	const TickType_t start = xTaskGetTickCount();
+
+#if (LR11XX_HAL_BUSY_EXTI == 1)
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		radio->state.busy_waiting_task = xTaskGetCurrentTaskHandle();
+
+		// Drop a notification left over by an edge that came after a previous timeout
+		(void)ulTaskNotifyTakeIndexed(LR11XX_HAL_NOTIFY_INDEX, pdTRUE, 0);
+
+		while (lr11xx_hal_is_busy(radio) == true)
+		{
+			const TickType_t elapsed = xTaskGetTickCount() - start;
+
+			if (elapsed >= timeout_ticks)
+			{
+				break;
+			}
+
+			(void)ulTaskNotifyTakeIndexed(LR11XX_HAL_NOTIFY_INDEX, pdTRUE, timeout_ticks - elapsed);
+		}
+
+		radio->state.busy_waiting_task = NULL;
+
+		return (lr11xx_hal_is_busy(radio) == true) ? LR11XX_HAL_STATUS_TIMEOUT : LR11XX_HAL_STATUS_OK;
+	}
+#endif
+
+	while (lr11xx_hal_is_busy(radio) == true)
+	{
+		if ((xTaskGetTickCount() - start) >= timeout_ticks)
+		{
+			return LR11XX_HAL_STATUS_TIMEOUT;
+		}
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+/*!
+ * @brief Wait for the radio to release the BUSY line
+ */
+static lr11xx_hal_status_t lr11xx_hal_wait_on_busy(lr11xx_hal_context_t *radio)
+{
+	if (lr11xx_hal_is_busy(radio) == false)
+	{
+		return LR11XX_HAL_STATUS_OK;
+	}
+
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	const uint32_t start_us = LR11XX_HAL_INSTR_TIMESTAMP_US();
+#endif
+
+	const lr11xx_hal_status_t status = lr11xx_hal_wait_busy_release(radio);
+
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	radio->state.instr.busy_wait_us += LR11XX_HAL_INSTR_TIMESTAMP_US() - start_us;
+#endif
+
+	if (status != LR11XX_HAL_STATUS_OK)
+	{
+		radio->state.stats.nb_busy_timeouts++;
+	}
+
+	return status;
+}
+
+/*!
+ * @brief Timestamps taken when a transaction starts, see LR11XX_HAL_INSTRUMENTATION and LR11XX_HAL_CAPTURE
+ */
+typedef struct lr11xx_hal_instr_sample_s
+{
+	uint32_t start_us;
+	uint32_t busy_wait_us;
+} lr11xx_hal_instr_sample_t;
+
+static void lr11xx_hal_instr_start(const lr11xx_hal_context_t *radio, lr11xx_hal_instr_sample_t *sample)
+{
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	sample->busy_wait_us = radio->state.instr.busy_wait_us;
+#endif
+#if (LR11XX_HAL_INSTRUMENTATION == 1) || (LR11XX_HAL_CAPTURE == 1)
+	sample->start_us = LR11XX_HAL_INSTR_TIMESTAMP_US();
+#endif
+	(void)radio;
+	(void)sample;
+}
+
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+/*!
+ * @brief Find the counters of an opcode, allocating them on first use
+ *
+ * @returns NULL if the opcode is new and the table is full
+ */
+static lr11xx_hal_opcode_stats_t *lr11xx_hal_instr_find(lr11xx_hal_instr_t *instr, const uint16_t opcode)
+{
+	for (uint8_t i = 0; i < instr->nb_opcodes; i++)
+	{
+		if (instr->opcodes[i].opcode == opcode)
+		{
+			return &instr->opcodes[i];
+		}
+	}
+
+	if (instr->nb_opcodes == LR11XX_HAL_INSTR_MAX_OPCODES)
+	{
+		return NULL;
+	}
+
+	lr11xx_hal_opcode_stats_t *entry = &instr->opcodes[instr->nb_opcodes++];
+
+	memset(entry, 0, sizeof(*entry));
+	entry->opcode = opcode;
+
+	return entry;
+}
+
+static uint8_t lr11xx_hal_instr_histogram_bin(uint32_t duration_us)
+{
+	uint8_t bin = 0;
+
+	while ((duration_us != 0) && (bin < (LR11XX_HAL_INSTR_HISTOGRAM_BINS - 1)))
+	{
+		duration_us >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+#endif
+
+/*!
+ * @brief Account a finished transaction to its opcode
+ */
+static void lr11xx_hal_instr_record(lr11xx_hal_context_t *radio, const lr11xx_hal_instr_sample_t *sample,
+									const uint8_t *command, const uint16_t command_length, const uint16_t nb_bytes_tx,
+									const uint16_t nb_bytes_rx)
+{
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	lr11xx_hal_instr_t *instr = &radio->state.instr;
+	const uint32_t elapsed_us = LR11XX_HAL_INSTR_TIMESTAMP_US() - sample->start_us;
+	const uint32_t busy_wait_us = instr->busy_wait_us - sample->busy_wait_us;
+	uint16_t opcode = LR11XX_HAL_INSTR_OPCODE_DIRECT_READ;
+
+	if (command_length >= 2)
+	{
+		opcode = ((uint16_t)command[0] << 8) | command[1];
+	}
+	else if (command_length == 1)
+	{
+		opcode = command[0];
+	}
+
+	lr11xx_hal_opcode_stats_t *entry = lr11xx_hal_instr_find(instr, opcode);
+	if (entry == NULL)
+	{
+		instr->nb_untracked++;
+		return;
+	}
+
+	entry->nb_calls++;
+	entry->nb_bytes_tx += nb_bytes_tx;
+	entry->nb_bytes_rx += nb_bytes_rx;
+	entry->busy_wait_us += busy_wait_us;
+	entry->transfer_us_histogram[lr11xx_hal_instr_histogram_bin(elapsed_us - busy_wait_us)]++;
+#else
+	(void)radio;
+	(void)sample;
+	(void)command;
+	(void)command_length;
+	(void)nb_bytes_tx;
+	(void)nb_bytes_rx;
+#endif
+}
+
+/*!
+ * @brief Byte of the data of a write as sent on the bus
+ *
+ * When is_be32 is set, data points to host-order words sent big-endian, see @ref lr11xx_hal_write_be32.
+ */
+static inline uint8_t lr11xx_hal_data_byte(const uint8_t *data, const bool is_be32, const uint16_t index)
+{
+	if (is_be32 == true)
+	{
+		return (uint8_t)(((const uint32_t *)data)[index / 4] >> (24 - 8 * (index % 4)));
+	}
+
+	return data[index];
+}
+
+/*!
+ * @brief Continue a CRC over words sent big-endian
+ */
+static uint8_t lr11xx_hal_compute_crc_be32(uint8_t crc, const uint32_t *words, const uint16_t nb_words)
+{
+	for (uint16_t i = 0; i < nb_words; i++)
+	{
+		crc = lr11xx_hal_crc_table[crc ^ (uint8_t)(words[i] >> 24)];
+		crc = lr11xx_hal_crc_table[crc ^ (uint8_t)(words[i] >> 16)];
+		crc = lr11xx_hal_crc_table[crc ^ (uint8_t)(words[i] >> 8)];
+		crc = lr11xx_hal_crc_table[crc ^ (uint8_t)(words[i] >> 0)];
+	}
+
+	return crc;
+}
+
+#if (LR11XX_HAL_CAPTURE == 1)
+/*!
+ * @brief Copy bytes into the capture ring buffer at a given offset
+ */
+static void lr11xx_hal_capture_write_at(lr11xx_hal_capture_t *capture, const uint32_t offset, const uint8_t *bytes,
+										const uint32_t length)
+{
+	const uint32_t first = ((capture->size - offset) < length) ? (capture->size - offset) : length;
+
+	memcpy(&capture->buffer[offset], bytes, first);
+	memcpy(capture->buffer, &bytes[first], length - first);
+}
+
+/*!
+ * @brief Copy bytes into the capture ring buffer at its head
+ */
+static void lr11xx_hal_capture_put(lr11xx_hal_capture_t *capture, const uint8_t *bytes, const uint32_t length)
+{
+	lr11xx_hal_capture_write_at(capture, capture->head, bytes, length);
+
+	capture->head = (capture->head + length) % capture->size;
+	capture->used += length;
+}
+
+/*!
+ * @brief Length of the oldest record of the capture ring buffer
+ */
+static uint16_t lr11xx_hal_capture_peek_length(const lr11xx_hal_capture_t *capture)
+{
+	return (uint16_t)capture->buffer[capture->tail] |
+		   ((uint16_t)capture->buffer[(capture->tail + 1) % capture->size] << 8);
+}
+
+static void lr11xx_hal_capture_put_u32(uint8_t *buffer, const uint32_t value)
+{
+	buffer[0] = (uint8_t)(value >> 0);
+	buffer[1] = (uint8_t)(value >> 8);
+	buffer[2] = (uint8_t)(value >> 16);
+	buffer[3] = (uint8_t)(value >> 24);
+}
+
+/*!
+ * @brief Start a record: make room for it, dropping the oldest records if needed, then write its header and command
+ *
+ * The data follows with @ref lr11xx_hal_capture_put_data; status and duration are set by
+ * @ref lr11xx_hal_capture_close. Nothing is recorded if the radio is not capturing or the record does not fit.
+ */
+static void lr11xx_hal_capture_open(lr11xx_hal_context_t *radio, const lr11xx_hal_instr_sample_t *sample,
+									const lr11xx_hal_capture_record_type_t type, const uint8_t *command,
+									const uint16_t command_length, const uint16_t data_length)
+{
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+
+	capture->is_record_open = false;
+
+	if ((capture->buffer == NULL) || (capture->replay != NULL))
+	{
+		return;
+	}
+
+	const uint32_t length = LR11XX_HAL_CAPTURE_HEADER_SIZE + (uint32_t)command_length + data_length;
+
+	// Only a batched write can carry a command longer than 255 bytes: its data simply starts within the command bytes
+	if ((length > 0xFFFF) || (length > capture->size) ||
+		((command_length > 0xFF) && (type != LR11XX_HAL_CAPTURE_RECORD_WRITE)))
+	{
+		capture->stats.nb_too_large++;
+		return;
+	}
+
+	while ((capture->size - capture->used) < length)
+	{
+		const uint16_t oldest_length = lr11xx_hal_capture_peek_length(capture);
+
+		capture->tail = (capture->tail + oldest_length) % capture->size;
+		capture->used -= oldest_length;
+		capture->stats.nb_overwritten++;
+	}
+
+	uint8_t header[LR11XX_HAL_CAPTURE_HEADER_SIZE] = {0};
+
+	header[0] = (uint8_t)(length >> 0);
+	header[1] = (uint8_t)(length >> 8);
+	header[2] = (uint8_t)type;
+	header[3] = (command_length > 0xFF) ? 0xFF : (uint8_t)command_length;
+	lr11xx_hal_capture_put_u32(&header[4], sample->start_us);
+
+	capture->record_start = capture->head;
+	lr11xx_hal_capture_put(capture, header, sizeof(header));
+	lr11xx_hal_capture_put(capture, command, command_length);
+
+	capture->record_data_head = capture->head;
+	capture->record_data_used = capture->used;
+	capture->record_data_length = data_length;
+	capture->record_data_left = data_length;
+	capture->is_record_open = true;
+}
+
+/*!
+ * @brief Append data bytes to the record being written
+ */
+static void lr11xx_hal_capture_put_data(lr11xx_hal_capture_t *capture, const uint8_t *bytes, const uint16_t length)
+{
+	if ((capture->is_record_open == false) || (length > capture->record_data_left))
+	{
+		return;
+	}
+
+	lr11xx_hal_capture_put(capture, bytes, length);
+	capture->record_data_left -= length;
+}
+
+/*!
+ * @brief Drop the data written so far to the record being written, before a transaction is sent again
+ */
+static void lr11xx_hal_capture_rewind(lr11xx_hal_capture_t *capture)
+{
+	if (capture->is_record_open == false)
+	{
+		return;
+	}
+
+	capture->head = capture->record_data_head;
+	capture->used = capture->record_data_used;
+	capture->record_data_left = capture->record_data_length;
+}
+
+/*!
+ * @brief Finish the record being written with the status and duration of its transaction
+ *
+ * A transaction aborted before the end of its response is padded with zeros, the header length stays right.
+ */
+static void lr11xx_hal_capture_close(lr11xx_hal_capture_t *capture, const lr11xx_hal_instr_sample_t *sample,
+									 const lr11xx_hal_capture_record_type_t type, const lr11xx_hal_status_t status)
+{
+	if (capture->is_record_open == false)
+	{
+		return;
+	}
+
+	const uint8_t zero[1] = {0};
+
+	while (capture->record_data_left > 0)
+	{
+		lr11xx_hal_capture_put_data(capture, zero, 1);
+	}
+
+	uint8_t field[4];
+
+	field[0] = (uint8_t)type | (uint8_t)(status << 4);
+	lr11xx_hal_capture_write_at(capture, (capture->record_start + 2) % capture->size, field, 1);
+	lr11xx_hal_capture_put_u32(field, LR11XX_HAL_INSTR_TIMESTAMP_US() - sample->start_us);
+	lr11xx_hal_capture_write_at(capture, (capture->record_start + 8) % capture->size, field, sizeof(field));
+
+	capture->is_record_open = false;
+	capture->stats.nb_records++;
+}
+#endif
+
+/*!
+ * @brief Append a finished transaction to the capture ring buffer, dropping the oldest records if needed
+ *
+ * For a write, data holds the bytes sent, see @ref lr11xx_hal_data_byte; for a read or a direct read, the bytes
+ * received.
+ */
+static void lr11xx_hal_capture_record(lr11xx_hal_context_t *radio, const lr11xx_hal_instr_sample_t *sample,
+									  const lr11xx_hal_capture_record_type_t type, const lr11xx_hal_status_t status,
+									  const uint8_t *command, const uint16_t command_length, const uint8_t *data,
+									  const bool is_be32, const uint16_t data_length)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+
+	lr11xx_hal_capture_open(radio, sample, type, command, command_length, data_length);
+
+	if (is_be32 == true)
+	{
+		for (uint16_t i = 0; i < data_length; i++)
+		{
+			const uint8_t byte = lr11xx_hal_data_byte(data, true, i);
+
+			lr11xx_hal_capture_put_data(capture, &byte, 1);
+		}
+	}
+	else
+	{
+		lr11xx_hal_capture_put_data(capture, data, data_length);
+	}
+
+	lr11xx_hal_capture_close(capture, sample, type, status);
+#else
+	(void)radio;
+	(void)sample;
+	(void)type;
+	(void)status;
+	(void)command;
+	(void)command_length;
+	(void)data;
+	(void)is_be32;
+	(void)data_length;
+#endif
+}
+
+/*!
+ * @brief Answer a transaction from the replayed capture, if any
+ *
+ * For a write, data_length counts the bytes of tx_data, see @ref lr11xx_hal_data_byte; for a read or a direct read,
+ * the bytes expected in rx_data. rx_data may be NULL to only match the record, see @ref lr11xx_hal_replay_records.
+ *
+ * @returns false if the radio is not replaying a capture and the transaction must go to the SPI bus
+ */
+static bool lr11xx_hal_replay_transaction(lr11xx_hal_context_t *radio, const lr11xx_hal_capture_record_type_t type,
+										  const uint8_t *command, const uint16_t command_length,
+										  const uint8_t *tx_data, const bool is_be32, uint8_t *rx_data,
+										  const uint16_t data_length, lr11xx_hal_status_t *status)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+
+	if (capture->replay == NULL)
+	{
+		return false;
+	}
+
+	const uint8_t *record = &capture->replay[capture->replay_offset];
+	const uint32_t remaining = capture->replay_length - capture->replay_offset;
+	const uint16_t record_length =
+		(remaining >= LR11XX_HAL_CAPTURE_HEADER_SIZE) ? ((uint16_t)record[0] | ((uint16_t)record[1] << 8)) : 0;
+
+	*status = LR11XX_HAL_STATUS_ERROR;
+
+	if ((record_length < LR11XX_HAL_CAPTURE_HEADER_SIZE) || (record_length > remaining) ||
+		((record[2] & 0x0F) != (uint8_t)type))
+	{
+		capture->stats.nb_replay_mismatches++;
+		return true;
+	}
+
+	const uint8_t *payload = &record[LR11XX_HAL_CAPTURE_HEADER_SIZE];
+	const uint16_t payload_length = record_length - LR11XX_HAL_CAPTURE_HEADER_SIZE;
+	const uint16_t recorded_command_length = record[3];
+	bool is_match = false;
+
+	switch (type)
+	{
+	case LR11XX_HAL_CAPTURE_RECORD_WRITE:
+		// Compare the bytes sent regardless of how they were split between command and data
+		is_match = (payload_length == (command_length + data_length)) &&
+				   (memcmp(payload, command, command_length) == 0);
+		for (uint16_t i = 0; (is_match == true) && (i < data_length); i++)
+		{
+			is_match = (payload[command_length + i] == lr11xx_hal_data_byte(tx_data, is_be32, i));
+		}
+		break;
+	case LR11XX_HAL_CAPTURE_RECORD_READ:
+	case LR11XX_HAL_CAPTURE_RECORD_DIRECT_READ:
+		is_match = (recorded_command_length == command_length) &&
+				   (payload_length == (command_length + data_length)) &&
+				   ((command_length == 0) || (memcmp(payload, command, command_length) == 0));
+		if ((is_match == true) && (rx_data != NULL))
+		{
+			memcpy(rx_data, &payload[command_length], data_length);
+		}
+		break;
+	default:
+		is_match = true;
+		break;
+	}
+
+	if (is_match == false)
+	{
+		capture->stats.nb_replay_mismatches++;
+		return true;
+	}
+
+	capture->replay_offset += record_length;
+	capture->stats.nb_replayed++;
+	*status = (lr11xx_hal_status_t)(record[2] >> 4);
+
+	return true;
+#else
+	(void)radio;
+	(void)type;
+	(void)command;
+	(void)command_length;
+	(void)tx_data;
+	(void)is_be32;
+	(void)rx_data;
+	(void)data_length;
+	(void)status;
+
+	return false;
+#endif
+}
+
+/*!
+ * @brief Answer a lr11xx_hal_read_records transaction from the replayed capture, if any
+ *
+ * The records are handed to the callback straight from the replayed capture.
+ *
+ * @returns false if the radio is not replaying a capture and the transaction must go to the SPI bus
+ */
+static bool lr11xx_hal_replay_records(lr11xx_hal_context_t *radio, const uint8_t *command,
+									  const uint16_t command_length, const uint16_t record_length,
+									  const uint16_t nb_records, lr11xx_hal_record_callback_t callback,
+									  void *user_data, lr11xx_hal_status_t *status)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+	const uint32_t replay_offset = capture->replay_offset;
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_READ, command, command_length, NULL, false,
+									  NULL, record_length * nb_records, status) == false)
+	{
+		return false;
+	}
+
+	// The replay offset only moves forward when the record matched the transaction
+	if (capture->replay_offset != replay_offset)
+	{
+		const uint8_t *data = &capture->replay[replay_offset + LR11XX_HAL_CAPTURE_HEADER_SIZE + command_length];
+
+		for (uint16_t i = 0; i < nb_records; i++)
+		{
+			callback(user_data, i, &data[i * record_length]);
+		}
+	}
+
+	return true;
+#else
+	(void)radio;
+	(void)command;
+	(void)command_length;
+	(void)record_length;
+	(void)nb_records;
+	(void)callback;
+	(void)user_data;
+	(void)status;
+
+	return false;
+#endif
+}
+
+/*!
+ * @brief Clock out a buffer on MOSI, the bytes received on MISO are discarded
+ */
+static void lr11xx_hal_spi_write_buffer(const lr11xx_hal_context_t *radio, const uint8_t *buffer,
+										const uint16_t length)
+{
+#if (LR11XX_HAL_SPI_BULK_TRANSFER == 1)
+	uint16_t offset = 0;
+
+	while (offset < length)
+	{
+		uint16_t chunk = length - offset;
+
+		if (chunk > LR11XX_HAL_SPI_DISCARD_BUFFER_SIZE)
+		{
+			chunk = LR11XX_HAL_SPI_DISCARD_BUFFER_SIZE;
+		}
+
+		radio->spi_transfer((uint8_t *)&buffer[offset], lr11xx_hal_spi_discard_buffer, chunk);
+		offset += chunk;
+	}
+#else
+	for (int i = 0; i < length; i++)
+	{
+		radio->spi_transfer((uint8_t *)&buffer[i], lr11xx_hal_spi_discard_buffer, 1);
+	}
+#endif
+}
+
+/*!
+ * @brief Clock out host-order words big-endian on MOSI, without staging the whole buffer
+ */
+static void lr11xx_hal_spi_write_be32(const lr11xx_hal_context_t *radio, const uint32_t *words,
+									  const uint16_t nb_words)
+{
+	uint32_t chunk[LR11XX_HAL_SPI_BE32_CHUNK_WORDS];
+	uint16_t offset = 0;
+
+	while (offset < nb_words)
+	{
+		uint16_t nb_chunk_words = nb_words - offset;
+
+		if (nb_chunk_words > LR11XX_HAL_SPI_BE32_CHUNK_WORDS)
+		{
+			nb_chunk_words = LR11XX_HAL_SPI_BE32_CHUNK_WORDS;
+		}
+
+		for (uint16_t i = 0; i < nb_chunk_words; i++)
+		{
+#if defined(LR11XX_HAL_HTOBE32)
+			chunk[i] = LR11XX_HAL_HTOBE32(words[offset + i]);
+#else
+			uint8_t *chunk_bytes = (uint8_t *)&chunk[i];
+
+			chunk_bytes[0] = (uint8_t)(words[offset + i] >> 24);
+			chunk_bytes[1] = (uint8_t)(words[offset + i] >> 16);
+			chunk_bytes[2] = (uint8_t)(words[offset + i] >> 8);
+			chunk_bytes[3] = (uint8_t)(words[offset + i] >> 0);
+#endif
+		}
+
+		lr11xx_hal_spi_write_buffer(radio, (const uint8_t *)chunk, nb_chunk_words * sizeof(uint32_t));
+		offset += nb_chunk_words;
+	}
+}
+
+/*!
+ * @brief Clock in a buffer from MISO while only NOPs are sent on MOSI
+ *
+ * The bulk path runs the transfer in place: the buffer is first filled with NOPs and used as both TX and RX buffer.
+ */
+static void lr11xx_hal_spi_read_buffer(const lr11xx_hal_context_t *radio, uint8_t *buffer, const uint16_t length)
+{
+#if (LR11XX_HAL_SPI_BULK_TRANSFER == 1)
+	if (length > 0)
+	{
+		memset(buffer, LR11XX_NOP, length);
+		radio->spi_transfer(buffer, buffer, length);
+	}
+#else
+	uint8_t nop[1] = {LR11XX_NOP};
+
+	for (int i = 0; i < length; i++)
+	{
+		radio->spi_transfer(nop, &buffer[i], 1);
+	}
+#endif
+}
+
+/*!
+ * @brief Check the CRC byte received at the end of a response
+ *
+ * @returns LR11XX_HAL_STATUS_ERROR, and counts the error, if the CRC does not match
+ */
+static lr11xx_hal_status_t lr11xx_hal_check_response_crc(lr11xx_hal_context_t *radio, const uint8_t *prefix,
+														 const uint16_t prefix_length, const uint8_t *data,
+														 const uint16_t data_length, const uint8_t received_crc)
+{
+	uint8_t crc = lr11xx_hal_compute_crc(LR11XX_HAL_CRC_INITIAL_VALUE, prefix, prefix_length);
+	crc = lr11xx_hal_compute_crc(crc, data, data_length);
+
+	if (crc != received_crc)
+	{
+		radio->state.stats.crc.nb_errors++;
+		return LR11XX_HAL_STATUS_ERROR;
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+/*!
+ * @brief Decide whether a transaction that failed must be sent again
+ *
+ * Only CRC errors are retried: they are the only errors reported as LR11XX_HAL_STATUS_ERROR by the transfer functions
+ * when CRC over SPI is enabled.
+ */
+static bool lr11xx_hal_crc_retry(lr11xx_hal_context_t *radio, const lr11xx_hal_status_t status, uint8_t *nb_retries)
+{
+	if ((status != LR11XX_HAL_STATUS_ERROR) || (radio->state.is_crc_enabled == false))
+	{
+		return false;
+	}
+
+	if (*nb_retries >= LR11XX_HAL_CRC_MAX_RETRIES)
+	{
+		radio->state.stats.crc.nb_failures++;
+		return false;
+	}
+
+	(*nb_retries)++;
+	radio->state.stats.crc.nb_retries++;
+
+	return true;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_direct_read_once(lr11xx_hal_context_t *radio, uint8_t *data,
+													   const uint16_t data_length)
+{
+	if (lr11xx_hal_wait_on_busy(radio) != LR11XX_HAL_STATUS_OK)
+	{
+		return LR11XX_HAL_STATUS_TIMEOUT;
+	}
+
+	radio->state.stats.nb_direct_reads++;
+	radio->state.stats.nb_bytes_rx += data_length;
+
+	lr11xx_hal_nss_write(radio, PIN_OFF);
+
+	lr11xx_hal_spi_read_buffer(radio, data, data_length);
+
+	uint8_t received_crc[1] = {0};
+	if (radio->state.is_crc_enabled == true)
+	{
+		lr11xx_hal_spi_read_buffer(radio, received_crc, 1);
+	}
+
+	lr11xx_hal_nss_write(radio, PIN_ON);
+
+	if (radio->state.is_crc_enabled == true)
+	{
+		return lr11xx_hal_check_response_crc(radio, NULL, 0, data, data_length, received_crc[0]);
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_write_once(lr11xx_hal_context_t *radio, const uint8_t *command,
+												 const uint16_t command_length, const uint8_t *data,
+												 const bool is_be32, const uint16_t data_length)
+{
+	if (lr11xx_hal_wait_on_busy(radio) != LR11XX_HAL_STATUS_OK)
+	{
+		return LR11XX_HAL_STATUS_TIMEOUT;
+	}
+
+	radio->state.stats.nb_writes++;
+	radio->state.stats.nb_bytes_tx += command_length + data_length;
+
+	lr11xx_hal_nss_write(radio, PIN_OFF);
+
+	lr11xx_hal_spi_write_buffer(radio, command, command_length);
+	if (is_be32 == true)
+	{
+		lr11xx_hal_spi_write_be32(radio, (const uint32_t *)data, data_length / sizeof(uint32_t));
+	}
+	else
+	{
+		lr11xx_hal_spi_write_buffer(radio, data, data_length);
+	}
+
+	if (radio->state.is_crc_enabled == true)
+	{
+		uint8_t crc[1];
+
+		crc[0] = lr11xx_hal_compute_crc(LR11XX_HAL_CRC_INITIAL_VALUE, command, command_length);
+		if (is_be32 == true)
+		{
+			crc[0] = lr11xx_hal_compute_crc_be32(crc[0], (const uint32_t *)data, data_length / sizeof(uint32_t));
+		}
+		else
+		{
+			crc[0] = lr11xx_hal_compute_crc(crc[0], data, data_length);
+		}
+		lr11xx_hal_spi_write_buffer(radio, crc, 1);
+	}
+
+	lr11xx_hal_nss_write(radio, PIN_ON);
+
+#if (LR11XX_HAL_CRC_CHECK_WRITES == 1)
+	if (radio->state.is_crc_enabled == true)
+	{
+		uint8_t stat1[1] = {0};
+		const lr11xx_hal_status_t status = lr11xx_hal_direct_read_once(radio, stat1, 1);
+
+		if (status != LR11XX_HAL_STATUS_OK)
+		{
+			return status;
+		}
+
+		if (LR11XX_HAL_STAT1_CMD_STATUS(stat1[0]) == LR11XX_HAL_STAT1_CMD_PERR)
+		{
+			radio->state.stats.crc.nb_errors++;
+			return LR11XX_HAL_STATUS_ERROR;
+		}
+	}
+#endif
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+/*!
+ * @brief First step of a read: send the command, then wait for the response to be ready
+ */
+static lr11xx_hal_status_t lr11xx_hal_read_command_once(lr11xx_hal_context_t *radio, const uint8_t *command,
+														const uint16_t command_length)
+{
+	if (lr11xx_hal_wait_on_busy(radio) != LR11XX_HAL_STATUS_OK)
+	{
+		return LR11XX_HAL_STATUS_TIMEOUT;
+	}
+
+	radio->state.stats.nb_reads++;
+	radio->state.stats.nb_bytes_tx += command_length;
+
+	lr11xx_hal_nss_write(radio, PIN_OFF);
+
+	lr11xx_hal_spi_write_buffer(radio, command, command_length);
+
+	if (radio->state.is_crc_enabled == true)
+	{
+		uint8_t crc[1];
+
+		crc[0] = lr11xx_hal_compute_crc(LR11XX_HAL_CRC_INITIAL_VALUE, command, command_length);
+		lr11xx_hal_spi_write_buffer(radio, crc, 1);
+	}
+
+	lr11xx_hal_nss_write(radio, PIN_ON);
+
+	if (lr11xx_hal_wait_on_busy(radio) != LR11XX_HAL_STATUS_OK)
+	{
+		return LR11XX_HAL_STATUS_TIMEOUT;
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_read_once(lr11xx_hal_context_t *radio, const uint8_t *command,
+												const uint16_t command_length, uint8_t *data,
+												const uint16_t data_length)
+{
+	const lr11xx_hal_status_t command_status = lr11xx_hal_read_command_once(radio, command, command_length);
+	if (command_status != LR11XX_HAL_STATUS_OK)
+	{
+		return command_status;
+	}
+
+	radio->state.stats.nb_bytes_rx += data_length;
+
+	lr11xx_hal_nss_write(radio, PIN_OFF);
+
+	uint8_t stat1[1] = {0};
+	lr11xx_hal_spi_read_buffer(radio, stat1, 1);
+	lr11xx_hal_spi_read_buffer(radio, data, data_length);
+
+	uint8_t received_crc[1] = {0};
+	if (radio->state.is_crc_enabled == true)
+	{
+		lr11xx_hal_spi_read_buffer(radio, received_crc, 1);
+	}
+
+	lr11xx_hal_nss_write(radio, PIN_ON);
+
+	if (radio->state.is_crc_enabled == true)
+	{
+		// A corrupted command is reported in stat1, a corrupted response by the trailing CRC
+		if (LR11XX_HAL_STAT1_CMD_STATUS(stat1[0]) == LR11XX_HAL_STAT1_CMD_PERR)
+		{
+			radio->state.stats.crc.nb_errors++;
+			return LR11XX_HAL_STATUS_ERROR;
+		}
+
+		return lr11xx_hal_check_response_crc(radio, stat1, 1, data, data_length, received_crc[0]);
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_read_records_once(lr11xx_hal_context_t *radio, const uint8_t *command,
+														const uint16_t command_length, const uint16_t record_length,
+														const uint16_t nb_records,
+														lr11xx_hal_record_callback_t callback, void *user_data)
+{
+	const lr11xx_hal_status_t command_status = lr11xx_hal_read_command_once(radio, command, command_length);
+	if (command_status != LR11XX_HAL_STATUS_OK)
+	{
+		return command_status;
+	}
+
+	radio->state.stats.nb_bytes_rx += record_length * nb_records;
+
+	lr11xx_hal_nss_write(radio, PIN_OFF);
+
+	uint8_t stat1[1] = {0};
+	lr11xx_hal_spi_read_buffer(radio, stat1, 1);
+
+	// The response CRC is computed on the fly, the records are not kept once handed over
+	uint8_t crc = lr11xx_hal_compute_crc(LR11XX_HAL_CRC_INITIAL_VALUE, stat1, 1);
+	uint8_t record[LR11XX_HAL_RECORD_MAX_LENGTH];
+
+	for (uint16_t i = 0; i < nb_records; i++)
+	{
+		lr11xx_hal_spi_read_buffer(radio, record, record_length);
+
+		if (radio->state.is_crc_enabled == true)
+		{
+			crc = lr11xx_hal_compute_crc(crc, record, record_length);
+		}
+#if (LR11XX_HAL_CAPTURE == 1)
+		lr11xx_hal_capture_put_data(&radio->state.capture, record, record_length);
+#endif
+
+		callback(user_data, i, record);
+	}
+
+	uint8_t received_crc[1] = {0};
+	if (radio->state.is_crc_enabled == true)
+	{
+		lr11xx_hal_spi_read_buffer(radio, received_crc, 1);
+	}
+
+	lr11xx_hal_nss_write(radio, PIN_ON);
+
+	if (radio->state.is_crc_enabled == true)
+	{
+		if ((LR11XX_HAL_STAT1_CMD_STATUS(stat1[0]) == LR11XX_HAL_STAT1_CMD_PERR) || (crc != received_crc[0]))
+		{
+			radio->state.stats.crc.nb_errors++;
+			return LR11XX_HAL_STATUS_ERROR;
+		}
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_write_transaction(lr11xx_hal_context_t *radio, const uint8_t *command,
+														const uint16_t command_length, const uint8_t *data,
+														const bool is_be32, const uint16_t data_length)
+{
+	lr11xx_hal_status_t status;
+	uint8_t nb_retries = 0;
+	lr11xx_hal_instr_sample_t sample;
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_WRITE, command, command_length, data, is_be32,
+									  NULL, data_length, &status) == true)
+	{
+		return status;
+	}
+
+	lr11xx_hal_instr_start(radio, &sample);
+
+	do
+	{
+		status = lr11xx_hal_write_once(radio, command, command_length, data, is_be32, data_length);
+	} while (lr11xx_hal_crc_retry(radio, status, &nb_retries) == true);
+
+	lr11xx_hal_instr_record(radio, &sample, command, command_length, command_length + data_length, 0);
+	lr11xx_hal_capture_record(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_WRITE, status, command, command_length, data,
+							  is_be32, data_length);
+
+	return status;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_read_transaction(lr11xx_hal_context_t *radio, const uint8_t *command,
+													   const uint16_t command_length, uint8_t *data,
+													   const uint16_t data_length)
+{
+	lr11xx_hal_status_t status;
+	uint8_t nb_retries = 0;
+	lr11xx_hal_instr_sample_t sample;
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_READ, command, command_length, NULL, false,
+									  data, data_length, &status) == true)
+	{
+		return status;
+	}
+
+	lr11xx_hal_instr_start(radio, &sample);
+
+	do
+	{
+		status = lr11xx_hal_read_once(radio, command, command_length, data, data_length);
+	} while (lr11xx_hal_crc_retry(radio, status, &nb_retries) == true);
+
+	lr11xx_hal_instr_record(radio, &sample, command, command_length, command_length, data_length);
+	lr11xx_hal_capture_record(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_READ, status, command, command_length, data,
+							  false, data_length);
+
+	return status;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_direct_read_transaction(lr11xx_hal_context_t *radio, uint8_t *data,
+															  const uint16_t data_length)
+{
+	lr11xx_hal_status_t status;
+	uint8_t nb_retries = 0;
+	lr11xx_hal_instr_sample_t sample;
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_DIRECT_READ, NULL, 0, NULL, false, data,
+									  data_length, &status) == true)
+	{
+		return status;
+	}
+
+	lr11xx_hal_instr_start(radio, &sample);
+
+	do
+	{
+		status = lr11xx_hal_direct_read_once(radio, data, data_length);
+	} while (lr11xx_hal_crc_retry(radio, status, &nb_retries) == true);
+
+	lr11xx_hal_instr_record(radio, &sample, NULL, 0, 0, data_length);
+	lr11xx_hal_capture_record(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_DIRECT_READ, status, NULL, 0, data, false,
+							  data_length);
+
+	return status;
+}
+
+static lr11xx_hal_status_t lr11xx_hal_read_records_transaction(lr11xx_hal_context_t *radio, const uint8_t *command,
+															   const uint16_t command_length,
+															   const uint16_t record_length, const uint16_t nb_records,
+															   lr11xx_hal_record_callback_t callback, void *user_data)
+{
+	lr11xx_hal_status_t status;
+	uint8_t nb_retries = 0;
+	lr11xx_hal_instr_sample_t sample;
+	const uint16_t data_length = record_length * nb_records;
+
+	if (lr11xx_hal_replay_records(radio, command, command_length, record_length, nb_records, callback, user_data,
+								  &status) == true)
+	{
+		return status;
+	}
+
+	lr11xx_hal_instr_start(radio, &sample);
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_capture_open(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_READ, command, command_length, data_length);
+#endif
+
+	do
+	{
+#if (LR11XX_HAL_CAPTURE == 1)
+		lr11xx_hal_capture_rewind(&radio->state.capture);
+#endif
+		status = lr11xx_hal_read_records_once(radio, command, command_length, record_length, nb_records, callback,
+											  user_data);
+	} while (lr11xx_hal_crc_retry(radio, status, &nb_retries) == true);
+
+	lr11xx_hal_instr_record(radio, &sample, command, command_length, command_length, data_length);
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_capture_close(&radio->state.capture, &sample, LR11XX_HAL_CAPTURE_RECORD_READ, status);
+#endif
+
+	return status;
+}
+
+/*!
+ * @brief Execute one transaction of a batch
+ */
+static lr11xx_hal_status_t lr11xx_hal_run_transaction(lr11xx_hal_context_t *radio,
+													  const lr11xx_hal_transaction_t *transaction)
+{
+	switch (transaction->type)
+	{
+	case LR11XX_HAL_TRANSACTION_WRITE:
+		return lr11xx_hal_write_transaction(radio, transaction->command, transaction->command_length,
+											transaction->tx_data, false, transaction->data_length);
+	case LR11XX_HAL_TRANSACTION_READ:
+		return lr11xx_hal_read_transaction(radio, transaction->command, transaction->command_length,
+										   transaction->rx_data, transaction->data_length);
+	case LR11XX_HAL_TRANSACTION_DIRECT_READ:
+		return lr11xx_hal_direct_read_transaction(radio, transaction->rx_data, transaction->data_length);
+	}
+
+	return LR11XX_HAL_STATUS_ERROR;
+}
+
+/*!
+ * @brief Execute and empty the write queue filled while a batch is open
+ */
+static lr11xx_hal_status_t lr11xx_hal_batch_flush(lr11xx_hal_context_t *radio)
+{
+	lr11xx_hal_batch_t *batch = &radio->state.batch;
+
+	const lr11xx_hal_status_t status =
+		lr11xx_hal_transfer_batch(radio, batch->transactions, batch->nb_transactions, NULL);
+
+	batch->nb_transactions = 0;
+	batch->buffer_used = 0;
+
+	if ((status != LR11XX_HAL_STATUS_OK) && (batch->status == LR11XX_HAL_STATUS_OK))
+	{
+		batch->status = status;
+	}
+
+	return status;
+}
+
+/*!
+ * @brief Flush the write queue before a transaction that cannot be queued
+ */
+static lr11xx_hal_status_t lr11xx_hal_batch_flush_pending(lr11xx_hal_context_t *radio)
+{
+	if ((radio->state.batch.is_open == true) && (radio->state.batch.nb_transactions > 0))
+	{
+		return lr11xx_hal_batch_flush(radio);
+	}
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+/*!
+ * @brief Copy a write into the batch queue, flushing the queue first when it cannot hold it
+ *
+ * @returns false if the write does not fit in an empty queue and must be sent directly
+ */
+static bool lr11xx_hal_batch_queue_write(lr11xx_hal_context_t *radio, const uint8_t *command,
+										 const uint16_t command_length, const uint8_t *data,
+										 const uint16_t data_length)
+{
+	lr11xx_hal_batch_t *batch = &radio->state.batch;
+	const uint16_t length = command_length + data_length;
+
+	if (length > LR11XX_HAL_BATCH_BUFFER_SIZE)
+	{
+		return false;
+	}
+
+	if ((batch->nb_transactions == LR11XX_HAL_BATCH_MAX_TRANSACTIONS) ||
+		((batch->buffer_used + length) > LR11XX_HAL_BATCH_BUFFER_SIZE))
+	{
+		(void)lr11xx_hal_batch_flush(radio);
+	}
+
+	uint8_t *queued_bytes = &batch->buffer[batch->buffer_used];
+
+	memcpy(queued_bytes, command, command_length);
+	if (data_length > 0)
+	{
+		memcpy(&queued_bytes[command_length], data, data_length);
+	}
+
+	// Command and data are contiguous in the queue: send them as a single command phase
+	lr11xx_hal_transaction_t *transaction = &batch->transactions[batch->nb_transactions];
+	transaction->type = LR11XX_HAL_TRANSACTION_WRITE;
+	transaction->command = queued_bytes;
+	transaction->command_length = length;
+	transaction->tx_data = NULL;
+	transaction->rx_data = NULL;
+	transaction->data_length = 0;
+
+	batch->nb_transactions++;
+	batch->buffer_used += length;
+
+	return true;
+}
+
+lr11xx_hal_status_t lr11xx_hal_context_init(lr11xx_hal_context_t *radio, lr11xx_hal_spi_transfer_t spi_transfer,
+											const lr11xx_hal_gpio_t nss, const lr11xx_hal_gpio_t busy,
+											const lr11xx_hal_gpio_t nreset)
+{
+	lr11xx_hal_bus_t *bus = NULL;
+
+	memset(radio, 0, sizeof(*radio));
+
+	radio->spi_transfer = (spi_transfer != NULL) ? spi_transfer : lr11xx_hal_default_spi_transfer;
+	radio->nss = nss;
+	radio->busy = busy;
+	radio->nreset = nreset;
+	radio->state.busy_timeout_ms = LR11XX_HAL_BUSY_TIMEOUT_MS;
+
+	// Radios sharing a transfer function share the bus and its lock
+	taskENTER_CRITICAL();
+	for (uint8_t i = 0; i < LR11XX_HAL_MAX_SPI_BUSES; i++)
+	{
+		if ((lr11xx_hal_buses[i].spi_transfer == radio->spi_transfer) || (lr11xx_hal_buses[i].spi_transfer == NULL))
+		{
+			bus = &lr11xx_hal_buses[i];
+			bus->spi_transfer = radio->spi_transfer;
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (bus == NULL)
+	{
+		return LR11XX_HAL_STATUS_ERROR;
+	}
+
+	radio->state.bus_lock = &bus->lock;
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+/*!
+ * @brief Pick the waiter the radio is handed over to
+ *
+ * Highest task priority first, then short transactions, then arrival order.
+ */
+static uint8_t lr11xx_hal_lock_next_waiter(const lr11xx_hal_lock_t *lock)
+{
+	uint8_t next = 0;
+
+	for (uint8_t i = 1; i < lock->nb_waiters; i++)
+	{
+		const lr11xx_hal_lock_waiter_t *candidate = &lock->waiters[i];
+		const lr11xx_hal_lock_waiter_t *best = &lock->waiters[next];
+
+		if (candidate->priority != best->priority)
+		{
+			if (candidate->priority > best->priority)
+			{
+				next = i;
+			}
+		}
+		else if (candidate->is_short != best->is_short)
+		{
+			if (candidate->is_short == true)
+			{
+				next = i;
+			}
+		}
+		else if ((int32_t)(candidate->ticket - best->ticket) < 0)
+		{
+			next = i;
+		}
+	}
+
+	return next;
+}
+
+/*!
+ * @brief Take a lock, waiting by priority if it is held by another task
+ *
+ * @param [in] stats Contention counters updated on the first level of recursion, NULL if not counted
+ */
+static void lr11xx_hal_lock_take(lr11xx_hal_lock_t *lock, lr11xx_hal_lock_stats_t *stats, const uint16_t length)
+{
+	if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+	{
+		return;
+	}
+
+	TaskHandle_t self = xTaskGetCurrentTaskHandle();
+	const TickType_t start = xTaskGetTickCount();
+	bool has_waited = false;
+
+	for (;;)
+	{
+		taskENTER_CRITICAL();
+
+		if ((lock->owner == NULL) || (lock->owner == self))
+		{
+			lock->owner = self;
+			lock->depth++;
+			taskEXIT_CRITICAL();
+			break;
+		}
+
+		if (lock->nb_waiters < LR11XX_HAL_LOCK_MAX_WAITERS)
+		{
+			lr11xx_hal_lock_waiter_t *waiter = &lock->waiters[lock->nb_waiters];
+
+			waiter->task = self;
+			waiter->priority = uxTaskPriorityGet(NULL);
+			waiter->is_short = (length > 0) && (length <= LR11XX_HAL_LOCK_SHORT_TRANSACTION_SIZE);
+			waiter->ticket = lock->next_ticket++;
+
+			lock->nb_waiters++;
+			if ((stats != NULL) && (lock->nb_waiters > stats->max_waiters))
+			{
+				stats->max_waiters = lock->nb_waiters;
+			}
+
+			taskEXIT_CRITICAL();
+
+			// The lock is handed over before the notification is given: ignore notifications meant for BUSY or IRQ
+			while (lock->owner != self)
+			{
+				(void)ulTaskNotifyTakeIndexed(LR11XX_HAL_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+			}
+
+			has_waited = true;
+			break;
+		}
+
+		taskEXIT_CRITICAL();
+
+		has_waited = true;
+		vTaskDelay(1);
+	}
+
+	if ((stats != NULL) && (lock->depth == 1))
+	{
+		stats->nb_acquisitions++;
+
+		if (has_waited == true)
+		{
+			const TickType_t wait_ticks = xTaskGetTickCount() - start;
+
+			stats->nb_contentions++;
+			stats->total_wait_ticks += wait_ticks;
+			if (wait_ticks > stats->max_wait_ticks)
+			{
+				stats->max_wait_ticks = wait_ticks;
+			}
+		}
+	}
+}
 
-static void lr11xx_hal_wait_on_busy()
+/*!
+ * @brief Release a lock taken with @ref lr11xx_hal_lock_take, handing it over to the next waiter
+ */
+static void lr11xx_hal_lock_give(lr11xx_hal_lock_t *lock)
 {
-	while (HT_GPIO_PinRead(GPIO_BUSY_LR1110_INSTANCE, GPIO_BUSY_LR1110_PIN) == 1)
+	if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+	{
+		return;
+	}
+
+	TaskHandle_t next_owner = NULL;
+
+	taskENTER_CRITICAL();
+
+	if ((lock->owner == xTaskGetCurrentTaskHandle()) && (--lock->depth == 0))
+	{
+		if (lock->nb_waiters > 0)
+		{
+			const uint8_t next = lr11xx_hal_lock_next_waiter(lock);
+
+			next_owner = lock->waiters[next].task;
+			lock->waiters[next] = lock->waiters[lock->nb_waiters - 1];
+			lock->nb_waiters--;
+
+			lock->depth = 1;
+		}
+
+		lock->owner = next_owner;
+	}
+
+	taskEXIT_CRITICAL();
+
+	if (next_owner != NULL)
 	{
+		(void)xTaskNotifyGiveIndexed(next_owner, LR11XX_HAL_NOTIFY_INDEX);
 	}
 }
 
+void lr11xx_hal_lock(const void *context, const uint16_t length)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock_take(&radio->state.lock, &radio->state.stats.lock, length);
+}
+
+void lr11xx_hal_unlock(const void *context)
+{
+	lr11xx_hal_lock_give(&lr11xx_hal_get_context(context)->state.lock);
+}
+
 lr11xx_hal_status_t lr11xx_hal_write(const void *context, const uint8_t *command, const uint16_t command_length,
 									 const uint8_t *data, const uint16_t data_length)
 {
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	lr11xx_hal_status_t status = LR11XX_HAL_STATUS_OK;
 
-	lr11xx_hal_wait_on_busy();
+	lr11xx_hal_lock(radio, command_length + data_length);
 
-	uint8_t statBuff[1] = {0};
+	if (radio->state.batch.is_open == true)
+	{
+		if (lr11xx_hal_batch_queue_write(radio, command, command_length, data, data_length) == true)
+		{
+			lr11xx_hal_unlock(radio);
+			return LR11XX_HAL_STATUS_OK;
+		}
+
+		status = lr11xx_hal_batch_flush(radio);
+	}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_OFF);
-	for (int i = 0; i < command_length; i++)
+	if (status == LR11XX_HAL_STATUS_OK)
 	{
-		HT_SPI_TransmitReceive((uint8_t *)&command[i], statBuff, 1);
+		status = lr11xx_hal_write_transaction(radio, command, command_length, data, false, data_length);
 	}
 
-	for (int i = 0; i < data_length; i++)
+	lr11xx_hal_unlock(radio);
+
+	return status;
+}
+
+lr11xx_hal_status_t lr11xx_hal_write_be32(const void *context, const uint8_t *command, const uint16_t command_length,
+										  const uint32_t *words, const uint16_t nb_words)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	const uint16_t data_length = nb_words * sizeof(uint32_t);
+
+	lr11xx_hal_lock(radio, command_length + data_length);
+
+	lr11xx_hal_status_t status = lr11xx_hal_batch_flush_pending(radio);
+	if (status == LR11XX_HAL_STATUS_OK)
 	{
-		HT_SPI_TransmitReceive((uint8_t *)&data[i], statBuff, 1);
+		status = lr11xx_hal_write_transaction(radio, command, command_length, (const uint8_t *)words, true,
+											  data_length);
 	}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_ON);
+	lr11xx_hal_unlock(radio);
 
-	return LR11XX_HAL_STATUS_OK;
+	return status;
 }
 
 lr11xx_hal_status_t lr11xx_hal_read(const void *context, const uint8_t *command, const uint16_t command_length,
 									uint8_t *data, const uint16_t data_length)
 {
-	lr11xx_hal_wait_on_busy();
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
 
-	uint8_t bufferRX[1] = {0};
+	lr11xx_hal_lock(radio, command_length + data_length);
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_OFF);
-	for (int i = 0; i < command_length; i++)
+	lr11xx_hal_status_t status = lr11xx_hal_batch_flush_pending(radio);
+	if (status == LR11XX_HAL_STATUS_OK)
 	{
-		HT_SPI_TransmitReceive((uint8_t *)&command[i], bufferRX, 1);
+		status = lr11xx_hal_read_transaction(radio, command, command_length, data, data_length);
 	}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_ON);
+	lr11xx_hal_unlock(radio);
 
-	lr11xx_hal_wait_on_busy();
+	return status;
+}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_OFF);
+lr11xx_hal_status_t lr11xx_hal_read_records(const void *context, const uint8_t *command,
+											const uint16_t command_length, const uint16_t record_length,
+											const uint16_t nb_records, lr11xx_hal_record_callback_t callback,
+											void *user_data)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
 
-	uint8_t txStat1[1] = {0};
-	HT_SPI_TransmitReceive(txStat1, bufferRX, 1);
-	for (int i = 0; i < data_length; i++)
+	if ((record_length == 0) || (record_length > LR11XX_HAL_RECORD_MAX_LENGTH) ||
+		(((uint32_t)record_length * nb_records) > 0xFFFF) || (callback == NULL))
 	{
-		HT_SPI_TransmitReceive(txStat1, (uint8_t *)&data[i], 1);
+		return LR11XX_HAL_STATUS_ERROR;
 	}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_ON);
+	lr11xx_hal_lock(radio, command_length + record_length * nb_records);
 
-	return LR11XX_HAL_STATUS_OK;
+	lr11xx_hal_status_t status = lr11xx_hal_batch_flush_pending(radio);
+	if (status == LR11XX_HAL_STATUS_OK)
+	{
+		status = lr11xx_hal_read_records_transaction(radio, command, command_length, record_length, nb_records,
+													 callback, user_data);
+	}
+
+	lr11xx_hal_unlock(radio);
+
+	return status;
 }
 
 lr11xx_hal_status_t lr11xx_hal_direct_read(const void *context, uint8_t *data, const uint16_t data_length)
 {
-	lr11xx_hal_wait_on_busy();
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
 
-	uint8_t txStat1[1] = {0};
+	lr11xx_hal_lock(radio, data_length);
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_OFF);
-	for (int i = 0; i < data_length; i++)
+	lr11xx_hal_status_t status = lr11xx_hal_batch_flush_pending(radio);
+	if (status == LR11XX_HAL_STATUS_OK)
 	{
-		HT_SPI_TransmitReceive(txStat1, (uint8_t *)&data[i], 1);
+		status = lr11xx_hal_direct_read_transaction(radio, data, data_length);
 	}
 
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_ON);
+	lr11xx_hal_unlock(radio);
 
-	return LR11XX_HAL_STATUS_OK;
+	return status;
 }
 
 lr11xx_hal_status_t lr11xx_hal_reset(const void *context)
 {
-	HT_GPIO_WritePin(GPIO_NRESET_LR1110_PIN, GPIO_NRESET_LR1110_INSTANCE, PIN_OFF);
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
 
-	delay_us(6000);
-	HT_GPIO_WritePin(GPIO_NRESET_LR1110_PIN, GPIO_NRESET_LR1110_INSTANCE, PIN_ON);
+	lr11xx_hal_status_t status = LR11XX_HAL_STATUS_OK;
+	lr11xx_hal_instr_sample_t sample;
 
-	return LR11XX_HAL_STATUS_OK;
+	lr11xx_hal_lock(radio, 0);
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_RESET, NULL, 0, NULL, false, NULL, 0,
+									  &status) == false)
+	{
+		lr11xx_hal_instr_start(radio, &sample);
+
+		HT_GPIO_WritePin(radio->nreset.pin, radio->nreset.instance, PIN_OFF);
+
+		delay_us(6000);
+		HT_GPIO_WritePin(radio->nreset.pin, radio->nreset.instance, PIN_ON);
+
+		lr11xx_hal_capture_record(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_RESET, status, NULL, 0, NULL, false, 0);
+	}
+
+	// The radio restarts with CRC over SPI disabled
+	radio->state.is_crc_enabled = false;
+
+	lr11xx_hal_unlock(radio);
+
+	return status;
 }
 
 lr11xx_hal_status_t lr11xx_hal_wakeup(const void *context)
 {
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_OFF);
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_status_t status = LR11XX_HAL_STATUS_OK;
+	lr11xx_hal_instr_sample_t sample;
+
+	lr11xx_hal_lock(radio, 0);
+
+	if (lr11xx_hal_replay_transaction(radio, LR11XX_HAL_CAPTURE_RECORD_WAKEUP, NULL, 0, NULL, false, NULL, 0,
+									  &status) == false)
+	{
+		lr11xx_hal_instr_start(radio, &sample);
+
+		lr11xx_hal_nss_write(radio, PIN_OFF);
+
+		delay_us(1000);
+		lr11xx_hal_nss_write(radio, PIN_ON);
+
+		lr11xx_hal_capture_record(radio, &sample, LR11XX_HAL_CAPTURE_RECORD_WAKEUP, status, NULL, 0, NULL, false, 0);
+	}
+
+	lr11xx_hal_unlock(radio);
+
+	return status;
+}
+
+void lr11xx_hal_set_busy_timeout(const void *context, const uint32_t timeout_ms)
+{
+	lr11xx_hal_get_context(context)->state.busy_timeout_ms = timeout_ms;
+}
+
+void lr11xx_hal_busy_irq_handler(const void *context)
+{
+	TaskHandle_t waiting_task = lr11xx_hal_get_context(context)->state.busy_waiting_task;
+
+	if (waiting_task != NULL)
+	{
+		BaseType_t higher_priority_task_woken = pdFALSE;
+
+		vTaskNotifyGiveIndexedFromISR(waiting_task, LR11XX_HAL_NOTIFY_INDEX, &higher_priority_task_woken);
+		portYIELD_FROM_ISR(higher_priority_task_woken);
+	}
+}
+
+void lr11xx_hal_clear_irq(const void *context)
+{
+	lr11xx_hal_get_context(context)->state.is_irq_pending = false;
+}
+
+lr11xx_hal_status_t lr11xx_hal_wait_irq(const void *context, const uint32_t timeout_ms)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	const TickType_t start = xTaskGetTickCount();
+	const TickType_t timeout_ticks = pdMS_TO_TICKS(timeout_ms);
+
+#if (LR11XX_HAL_DIO_EXTI == 1)
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		radio->state.irq_waiting_task = xTaskGetCurrentTaskHandle();
+
+		// Drop a notification left over by an edge that came after a previous timeout
+		(void)ulTaskNotifyTakeIndexed(LR11XX_HAL_NOTIFY_INDEX, pdTRUE, 0);
+
+		while (radio->state.is_irq_pending == false)
+		{
+			const TickType_t elapsed = xTaskGetTickCount() - start;
+
+			if (elapsed >= timeout_ticks)
+			{
+				break;
+			}
+
+			(void)ulTaskNotifyTakeIndexed(LR11XX_HAL_NOTIFY_INDEX, pdTRUE, timeout_ticks - elapsed);
+		}
+
+		radio->state.irq_waiting_task = NULL;
+	}
+	else
+	{
+		while ((radio->state.is_irq_pending == false) && ((xTaskGetTickCount() - start) < timeout_ticks))
+		{
+		}
+	}
+
+	if (radio->state.is_irq_pending == false)
+	{
+		return LR11XX_HAL_STATUS_TIMEOUT;
+	}
+
+	radio->state.is_irq_pending = false;
+#else
+	// The IRQ is raised when the operation completes, which is also when the radio releases BUSY
+	while (lr11xx_hal_is_busy(radio) == true)
+	{
+		if ((xTaskGetTickCount() - start) >= timeout_ticks)
+		{
+			return LR11XX_HAL_STATUS_TIMEOUT;
+		}
+
+		if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+		{
+			vTaskDelay(1);
+		}
+	}
+#endif
+
+	return LR11XX_HAL_STATUS_OK;
+}
+
+void lr11xx_hal_dio_irq_handler(const void *context)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	TaskHandle_t waiting_task = radio->state.irq_waiting_task;
+
+	radio->state.is_irq_pending = true;
+
+	if (waiting_task != NULL)
+	{
+		BaseType_t higher_priority_task_woken = pdFALSE;
+
+		vTaskNotifyGiveIndexedFromISR(waiting_task, LR11XX_HAL_NOTIFY_INDEX, &higher_priority_task_woken);
+		portYIELD_FROM_ISR(higher_priority_task_woken);
+	}
+}
+
+lr11xx_hal_status_t lr11xx_hal_transfer_batch(const void *context, const lr11xx_hal_transaction_t *transactions,
+											  const uint8_t nb_transactions, uint8_t *nb_done)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	lr11xx_hal_status_t status = LR11XX_HAL_STATUS_OK;
+	uint8_t index = 0;
+
+	lr11xx_hal_lock(radio, 0);
+
+	while ((index < nb_transactions) && (status == LR11XX_HAL_STATUS_OK))
+	{
+		status = lr11xx_hal_run_transaction(radio, &transactions[index]);
+		if (status == LR11XX_HAL_STATUS_OK)
+		{
+			index++;
+		}
+	}
+
+	lr11xx_hal_unlock(radio);
+
+	if (nb_done != NULL)
+	{
+		*nb_done = index;
+	}
+
+	return status;
+}
+
+void lr11xx_hal_batch_begin(const void *context)
+{
+	lr11xx_hal_batch_t *batch = &lr11xx_hal_get_context(context)->state.batch;
+
+	// Released by lr11xx_hal_batch_submit: queued writes of one task are never flushed by another
+	lr11xx_hal_lock(context, 0);
+
+	batch->is_open = true;
+	batch->status = LR11XX_HAL_STATUS_OK;
+	batch->nb_transactions = 0;
+	batch->buffer_used = 0;
+}
+
+lr11xx_hal_status_t lr11xx_hal_batch_submit(const void *context)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	(void)lr11xx_hal_batch_flush_pending(radio);
+
+	radio->state.batch.is_open = false;
+
+	const lr11xx_hal_status_t status = radio->state.batch.status;
+
+	lr11xx_hal_unlock(radio);
+
+	return status;
+}
+
+/*!
+ * @brief Job of the requests built by lr11xx_hal_write_async
+ */
+static lr11xx_hal_status_t lr11xx_hal_write_job(const lr11xx_hal_async_request_t *request)
+{
+	return lr11xx_hal_write(request->context, request->command, request->command_length, request->tx_data,
+							request->data_length);
+}
+
+/*!
+ * @brief Job of the requests built by lr11xx_hal_read_async
+ */
+static lr11xx_hal_status_t lr11xx_hal_read_job(const lr11xx_hal_async_request_t *request)
+{
+	return lr11xx_hal_read(request->context, request->command, request->command_length, request->rx_data,
+						   request->data_length);
+}
+
+static void lr11xx_hal_async_task(void *parameters)
+{
+	lr11xx_hal_async_request_t request;
+
+	(void)parameters;
+
+	for (;;)
+	{
+		if (xQueueReceive(lr11xx_hal_async_queue, &request, portMAX_DELAY) != pdPASS)
+		{
+			continue;
+		}
+
+		const lr11xx_hal_status_t status =
+			(request.job != NULL) ? request.job(&request) : LR11XX_HAL_STATUS_ERROR;
+
+		if (request.callback != NULL)
+		{
+			request.callback(request.context, status, request.user_data);
+		}
+	}
+}
+
+lr11xx_hal_status_t lr11xx_hal_async_init(void)
+{
+	if (lr11xx_hal_async_queue != NULL)
+	{
+		return LR11XX_HAL_STATUS_OK;
+	}
+
+	lr11xx_hal_async_queue = xQueueCreate(LR11XX_HAL_ASYNC_QUEUE_LENGTH, sizeof(lr11xx_hal_async_request_t));
+	if (lr11xx_hal_async_queue == NULL)
+	{
+		return LR11XX_HAL_STATUS_ERROR;
+	}
 
-	delay_us(1000);
-	HT_GPIO_WritePin(GPIO_NSS_LR1110_PIN, GPIO_NSS_LR1110_INSTANCE, PIN_ON);
+	if (xTaskCreate(lr11xx_hal_async_task, "lr11xx_hal", LR11XX_HAL_ASYNC_TASK_STACK_SIZE, NULL,
+					LR11XX_HAL_ASYNC_TASK_PRIORITY, NULL) != pdPASS)
+	{
+		// Without a worker the queue would accept requests that never complete
+		vQueueDelete(lr11xx_hal_async_queue);
+		lr11xx_hal_async_queue = NULL;
+		return LR11XX_HAL_STATUS_ERROR;
+	}
 
 	return LR11XX_HAL_STATUS_OK;
 }
+
+lr11xx_hal_status_t lr11xx_hal_async_submit(const lr11xx_hal_async_request_t *request)
+{
+	if ((lr11xx_hal_async_queue == NULL) || (request->job == NULL))
+	{
+		return LR11XX_HAL_STATUS_ERROR;
+	}
+
+	return (xQueueSend(lr11xx_hal_async_queue, request, 0) == pdPASS) ? LR11XX_HAL_STATUS_OK
+																	   : LR11XX_HAL_STATUS_ERROR;
+}
+
+lr11xx_hal_status_t lr11xx_hal_write_async(const void *context, const uint8_t *command, const uint16_t command_length,
+										   const uint8_t *data, const uint16_t data_length,
+										   lr11xx_hal_async_callback_t callback, void *user_data)
+{
+	if (command_length > LR11XX_HAL_ASYNC_CMD_LENGTH_MAX)
+	{
+		return LR11XX_HAL_STATUS_ERROR;
+	}
+
+	lr11xx_hal_async_request_t request = {
+		.job = lr11xx_hal_write_job,
+		.context = context,
+		.command_length = command_length,
+		.tx_data = data,
+		.data_length = data_length,
+		.callback = callback,
+		.user_data = user_data,
+	};
+	memcpy(request.command, command, command_length);
+
+	return lr11xx_hal_async_submit(&request);
+}
+
+lr11xx_hal_status_t lr11xx_hal_read_async(const void *context, const uint8_t *command, const uint16_t command_length,
+										  uint8_t *data, const uint16_t data_length,
+										  lr11xx_hal_async_callback_t callback, void *user_data)
+{
+	if (command_length > LR11XX_HAL_ASYNC_CMD_LENGTH_MAX)
+	{
+		return LR11XX_HAL_STATUS_ERROR;
+	}
+
+	lr11xx_hal_async_request_t request = {
+		.job = lr11xx_hal_read_job,
+		.context = context,
+		.command_length = command_length,
+		.rx_data = data,
+		.data_length = data_length,
+		.callback = callback,
+		.user_data = user_data,
+	};
+	memcpy(request.command, command, command_length);
+
+	return lr11xx_hal_async_submit(&request);
+}
+
+void lr11xx_hal_set_crc_mode(const void *context, const bool enable)
+{
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+
+	// Writes still queued were built for the current mode, the command switching the mode among them
+	(void)lr11xx_hal_batch_flush_pending(radio);
+
+	radio->state.is_crc_enabled = enable;
+
+	lr11xx_hal_unlock(radio);
+}
+
+void lr11xx_hal_get_crc_stats(const void *context, lr11xx_hal_crc_stats_t *stats)
+{
+	*stats = lr11xx_hal_get_context(context)->state.stats.crc;
+}
+
+void lr11xx_hal_get_stats(const void *context, lr11xx_hal_stats_t *stats)
+{
+	*stats = lr11xx_hal_get_context(context)->state.stats;
+}
+
+void lr11xx_hal_reset_stats(const void *context)
+{
+	memset(&lr11xx_hal_get_context(context)->state.stats, 0, sizeof(lr11xx_hal_stats_t));
+}
+
+uint8_t lr11xx_hal_get_opcode_stats(const void *context, lr11xx_hal_opcode_stats_t *stats, const uint8_t max_stats,
+									uint32_t *nb_untracked)
+{
+	uint8_t nb_stats = 0;
+	uint32_t untracked = 0;
+
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+
+	nb_stats = (radio->state.instr.nb_opcodes < max_stats) ? radio->state.instr.nb_opcodes : max_stats;
+	memcpy(stats, radio->state.instr.opcodes, nb_stats * sizeof(lr11xx_hal_opcode_stats_t));
+	untracked = radio->state.instr.nb_untracked;
+
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+	(void)stats;
+	(void)max_stats;
+#endif
+
+	if (nb_untracked != NULL)
+	{
+		*nb_untracked = untracked;
+	}
+
+	return nb_stats;
+}
+
+void lr11xx_hal_dump_opcode_stats(const void *context)
+{
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	// Static to keep the table off the caller's stack, the dump prints a copy taken under the radio lock
+	static lr11xx_hal_opcode_stats_t snapshot[LR11XX_HAL_INSTR_MAX_OPCODES];
+	uint32_t nb_untracked = 0;
+	const uint8_t nb_opcodes =
+		lr11xx_hal_get_opcode_stats(context, snapshot, LR11XX_HAL_INSTR_MAX_OPCODES, &nb_untracked);
+
+	// The transfer time has no column of its own, only its histogram
+	printf("opcode  calls  tx  rx  busy_us  transfer_us histogram (%u log2 bins)\n",
+		   (unsigned int)LR11XX_HAL_INSTR_HISTOGRAM_BINS);
+
+	for (uint8_t i = 0; i < nb_opcodes; i++)
+	{
+		const lr11xx_hal_opcode_stats_t *entry = &snapshot[i];
+
+		printf("0x%04X %lu %lu %lu %lu ", entry->opcode, (unsigned long)entry->nb_calls,
+			   (unsigned long)entry->nb_bytes_tx, (unsigned long)entry->nb_bytes_rx,
+			   (unsigned long)entry->busy_wait_us);
+
+		for (uint8_t bin = 0; bin < LR11XX_HAL_INSTR_HISTOGRAM_BINS; bin++)
+		{
+			printf(" %lu", (unsigned long)entry->transfer_us_histogram[bin]);
+		}
+
+		printf("\n");
+	}
+
+	printf("untracked: %lu\n", (unsigned long)nb_untracked);
+#else
+	(void)context;
+	printf("LR11XX HAL instrumentation disabled\n");
+#endif
+}
+
+void lr11xx_hal_reset_opcode_stats(const void *context)
+{
+#if (LR11XX_HAL_INSTRUMENTATION == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+
+	radio->state.instr.nb_opcodes = 0;
+	radio->state.instr.nb_untracked = 0;
+
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+#endif
+}
+
+void lr11xx_hal_capture_start(const void *context, uint8_t *buffer, const uint32_t size)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+
+	lr11xx_hal_lock(radio, 0);
+
+	capture->buffer = buffer;
+	capture->size = size;
+	capture->head = 0;
+	capture->tail = 0;
+	capture->used = 0;
+	memset(&capture->stats, 0, sizeof(capture->stats));
+
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+	(void)buffer;
+	(void)size;
+#endif
+}
+
+void lr11xx_hal_capture_stop(const void *context)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+	radio->state.capture.buffer = NULL;
+	radio->state.capture.used = 0;
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+#endif
+}
+
+uint32_t lr11xx_hal_capture_read(const void *context, uint8_t *buffer, const uint32_t max_length)
+{
+	uint32_t length = 0;
+
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+	lr11xx_hal_capture_t *capture = &radio->state.capture;
+
+	lr11xx_hal_lock(radio, 0);
+
+	while ((capture->buffer != NULL) && (capture->used > 0))
+	{
+		const uint16_t record_length = lr11xx_hal_capture_peek_length(capture);
+
+		if ((length + record_length) > max_length)
+		{
+			break;
+		}
+
+		const uint32_t first =
+			((capture->size - capture->tail) < record_length) ? (capture->size - capture->tail) : record_length;
+
+		memcpy(&buffer[length], &capture->buffer[capture->tail], first);
+		memcpy(&buffer[length + first], capture->buffer, record_length - first);
+
+		capture->tail = (capture->tail + record_length) % capture->size;
+		capture->used -= record_length;
+		length += record_length;
+	}
+
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+	(void)buffer;
+	(void)max_length;
+#endif
+
+	return length;
+}
+
+void lr11xx_hal_replay_start(const void *context, const uint8_t *capture, const uint32_t length)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+
+	radio->state.capture.replay = capture;
+	radio->state.capture.replay_length = length;
+	radio->state.capture.replay_offset = 0;
+	memset(&radio->state.capture.stats, 0, sizeof(radio->state.capture.stats));
+
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+	(void)capture;
+	(void)length;
+#endif
+}
+
+void lr11xx_hal_replay_stop(const void *context)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	lr11xx_hal_context_t *radio = lr11xx_hal_get_context(context);
+
+	lr11xx_hal_lock(radio, 0);
+	radio->state.capture.replay = NULL;
+	lr11xx_hal_unlock(radio);
+#else
+	(void)context;
+#endif
+}
+
+void lr11xx_hal_get_capture_stats(const void *context, lr11xx_hal_capture_stats_t *stats)
+{
+#if (LR11XX_HAL_CAPTURE == 1)
+	*stats = lr11xx_hal_get_context(context)->state.capture.stats;
+#else
+	(void)context;
+	memset(stats, 0, sizeof(*stats));
+#endif
+}
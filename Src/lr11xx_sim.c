@@ -0,0 +1,1139 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      lr11xx_sim.c
+ *
+ * @brief     Host simulator of the LR11XX radio, see lr11xx_sim.h
+ */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#if defined(LR11XX_SIM)
+
+#include <string.h>
+#include "LR1110_Driver/lr11xx_sim.h"
+#include "LR1110_Driver/lr11xx_hal.h"
+#include "LR1110_Driver/lr1110_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define LR11XX_SIM_FRAME_MAX_LENGTH (1024)
+#define LR11XX_SIM_RESPONSE_MAX_LENGTH (1 + LR11XX_SIM_MAX_RESULTS * LR11XX_SIM_EXTENDED_RESULT_SIZE)
+#define LR11XX_SIM_STATUS_LENGTH (6)
+
+#define LR11XX_SIM_MAX_RESULTS (32)
+#define LR11XX_SIM_BASIC_COMPLETE_RESULT_SIZE (22)
+#define LR11XX_SIM_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE (9)
+#define LR11XX_SIM_EXTENDED_RESULT_SIZE (79)
+#define LR11XX_SIM_COUNTRY_CODE_RESULT_SIZE (10)
+
+#define LR11XX_SIM_INFOPAGE_SIZE (512)
+
+#define LR11XX_SIM_STAT1_CMD_FAIL (0x00)
+#define LR11XX_SIM_STAT1_CMD_PERR (0x01)
+#define LR11XX_SIM_STAT1_CMD_OK (0x02)
+#define LR11XX_SIM_STAT1_CMD_DAT (0x03)
+
+#define LR11XX_SIM_TYPE_TRANSCEIVER (0x01)
+#define LR11XX_SIM_TYPE_BOOTLOADER (0xDF)
+
+#define LR11XX_SIM_IRQ_WIFI_SCAN_DONE (1UL << 20)
+
+#define LR11XX_SIM_WIFI_TYPE_SCAN_B_G_N (4)
+#define LR11XX_SIM_WIFI_SCAN_MODE_FULL_BEACON (4)
+#define LR11XX_SIM_WIFI_FORMAT_CODE_MAC_TYPE_CHANNEL (0x04)
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef enum
+{
+    LR11XX_SIM_MODE_TRANSCEIVER,
+    LR11XX_SIM_MODE_BOOTLOADER,
+} lr11xx_sim_mode_t;
+
+typedef struct
+{
+    uint8_t access_point;
+    int8_t rssi_dbm;
+    uint64_t timestamp_us; //!< Virtual time the beacon was received, reported as the uptime of the access point
+} lr11xx_sim_wifi_result_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+GPIO_TypeDef lr11xx_sim_gpio_port = {0};
+
+static struct
+{
+    lr11xx_sim_config_t config;
+    lr11xx_sim_stats_t stats;
+    uint64_t time_ns;
+    uint64_t busy_until_ns;
+    uint32_t random_state;
+
+    lr11xx_sim_mode_t mode;
+    bool has_firmware;
+    uint32_t nb_flash_bytes;
+    uint16_t fw_version;
+    bool is_sleeping;
+    bool is_in_reset;
+    bool is_busy_output;
+    uint8_t busy_output_level;
+
+    bool is_nss_low;
+    bool is_response_frame;
+    uint8_t frame[LR11XX_SIM_FRAME_MAX_LENGTH];
+    uint16_t frame_length;
+    uint8_t status[LR11XX_SIM_STATUS_LENGTH];
+    uint8_t response[LR11XX_SIM_RESPONSE_MAX_LENGTH]; //!< stat1 followed by the response data
+    uint16_t response_length;                         //!< Response data length, stat1 excluded
+    bool is_response_pending;
+    const uint8_t *out;
+    uint16_t out_length;
+    uint16_t out_index;
+    uint8_t out_crc;
+
+    uint8_t command_status;
+    bool is_crc_enabled;
+    uint32_t irq_status;
+    uint32_t irq_mask;
+    uint16_t errors;
+    uint8_t infopage[LR11XX_SIM_INFOPAGE_SIZE];
+
+    lr11xx_sim_access_point_t access_points[LR11XX_SIM_MAX_ACCESS_POINTS];
+    uint8_t nb_access_points;
+    lr11xx_sim_wifi_result_t results[LR11XX_SIM_MAX_RESULTS];
+    uint8_t nb_results;
+    lr11xx_sim_wifi_result_t country_code_results[LR11XX_SIM_MAX_RESULTS];
+    uint8_t nb_country_code_results;
+    uint8_t last_scan_mode;
+    uint32_t timing_detection_us;
+    uint32_t timing_correlation_us;
+    uint32_t timing_capture_us;
+    uint32_t timing_demodulation_us;
+} lr11xx_sim;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+static void lr11xx_sim_boot(const bool stay_in_bootloader);
+static void lr11xx_sim_start_frame(void);
+static void lr11xx_sim_end_frame(void);
+static void lr11xx_sim_execute(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args);
+static bool lr11xx_sim_execute_system(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                      uint32_t *busy_us);
+static bool lr11xx_sim_execute_wifi(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                    uint32_t *busy_us);
+static bool lr11xx_sim_execute_crypto(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                      uint32_t *busy_us);
+static bool lr11xx_sim_execute_bootloader(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                          uint32_t *busy_us);
+static void lr11xx_sim_wifi_scan(const uint8_t signal_type, const uint16_t channels, const uint8_t scan_mode,
+                                 const uint8_t max_results, const uint8_t nb_scan_per_channel,
+                                 const uint32_t dwell_us, uint32_t *busy_us);
+static uint8_t lr11xx_sim_wifi_receive(const uint8_t signal_type, const uint16_t channels, const uint8_t max_results,
+                                       const uint8_t nb_scan_per_channel, const uint32_t dwell_us,
+                                       const bool is_country_code_search, lr11xx_sim_wifi_result_t *results,
+                                       uint32_t *busy_us);
+static void lr11xx_sim_wifi_read_results(const uint8_t start_index, const uint8_t nb_results,
+                                         const uint8_t format_code);
+static void lr11xx_sim_wifi_read_country_code_results(const uint8_t start_index, const uint8_t nb_results);
+static uint8_t *lr11xx_sim_respond(const uint16_t length);
+static uint32_t lr11xx_sim_random(void);
+static void lr11xx_sim_advance_spi(const uint16_t length);
+static uint8_t lr11xx_sim_stat1(void);
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void lr11xx_sim_get_default_config(lr11xx_sim_config_t *config)
+{
+    config->spi_bitrate_hz = 8000000;
+    config->command_processing_us = 20;
+    config->boot_us = 250000;
+    config->calibration_us = 6000;
+    config->flash_erase_us = 2500000;
+    config->flash_write_us = 3000;
+    config->wifi_empty_channel_us = 2000;
+    config->wifi_demodulation_us = 1500;
+    config->rssi_jitter_db = 3;
+    config->seed = 0x1110;
+    config->hw_version = 0x22;
+    config->fw_version = 0x0308;
+    config->fw_version_after_update = 0x0401;
+    config->bootloader_version = 0x6500;
+}
+
+void lr11xx_sim_init(const lr11xx_sim_config_t *config)
+{
+    memset(&lr11xx_sim, 0, sizeof(lr11xx_sim));
+
+    if (config != NULL)
+    {
+        lr11xx_sim.config = *config;
+    }
+    else
+    {
+        lr11xx_sim_get_default_config(&lr11xx_sim.config);
+    }
+
+    lr11xx_sim.random_state = (lr11xx_sim.config.seed != 0) ? lr11xx_sim.config.seed : 1;
+    lr11xx_sim.has_firmware = true;
+    lr11xx_sim.fw_version = lr11xx_sim.config.fw_version;
+    memset(lr11xx_sim.infopage, 0xFF, sizeof(lr11xx_sim.infopage));
+
+    lr11xx_sim_boot(false);
+    lr11xx_sim.busy_until_ns = 0;
+}
+
+bool lr11xx_sim_add_access_point(const lr11xx_sim_access_point_t *access_point)
+{
+    if (lr11xx_sim.nb_access_points == LR11XX_SIM_MAX_ACCESS_POINTS)
+    {
+        return false;
+    }
+
+    lr11xx_sim.access_points[lr11xx_sim.nb_access_points++] = *access_point;
+
+    return true;
+}
+
+void lr11xx_sim_clear_access_points(void)
+{
+    lr11xx_sim.nb_access_points = 0;
+    lr11xx_sim.nb_results = 0;
+    lr11xx_sim.nb_country_code_results = 0;
+}
+
+uint64_t lr11xx_sim_get_time_us(void)
+{
+    return lr11xx_sim.time_ns / 1000;
+}
+
+void lr11xx_sim_advance_time_us(const uint32_t duration_us)
+{
+    lr11xx_sim.time_ns += (uint64_t)duration_us * 1000;
+}
+
+void lr11xx_sim_get_stats(lr11xx_sim_stats_t *stats)
+{
+    *stats = lr11xx_sim.stats;
+}
+
+void HT_GPIO_Init(GPIO_InitType *gpio)
+{
+    if ((gpio->instance == LR11XX_SIM_GPIO) && (gpio->gpio_pin == GPIO_BUSY_LR1110_PIN))
+    {
+        lr11xx_sim.is_busy_output = (gpio->pin_direction == GPIO_DirectionOutput);
+        lr11xx_sim.busy_output_level = gpio->init_output;
+    }
+}
+
+void HT_GPIO_WritePin(uint16_t pin, GPIO_TypeDef *instance, uint16_t value)
+{
+    if (instance != LR11XX_SIM_GPIO)
+    {
+        return;
+    }
+
+    switch (pin)
+    {
+    case GPIO_NSS_LR1110_PIN:
+        if ((value == PIN_OFF) && (lr11xx_sim.is_nss_low == false))
+        {
+            lr11xx_sim.is_nss_low = true;
+            lr11xx_sim_start_frame();
+        }
+        else if ((value == PIN_ON) && (lr11xx_sim.is_nss_low == true))
+        {
+            lr11xx_sim.is_nss_low = false;
+            lr11xx_sim_end_frame();
+        }
+        break;
+    case GPIO_BUSY_LR1110_PIN:
+        lr11xx_sim.busy_output_level = (uint8_t)value;
+        break;
+    case GPIO_NRESET_LR1110_PIN:
+        if (value == PIN_OFF)
+        {
+            lr11xx_sim.is_in_reset = true;
+        }
+        else if (lr11xx_sim.is_in_reset == true)
+        {
+            lr11xx_sim.is_in_reset = false;
+            // BUSY held low by the host while the radio leaves reset selects the bootloader
+            lr11xx_sim_boot((lr11xx_sim.is_busy_output == true) && (lr11xx_sim.busy_output_level == 0));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+uint16_t HT_GPIO_PinRead(GPIO_TypeDef *instance, uint16_t pin)
+{
+    if ((instance != LR11XX_SIM_GPIO) || (pin != GPIO_BUSY_LR1110_PIN))
+    {
+        return 0;
+    }
+
+    if (lr11xx_sim.is_busy_output == true)
+    {
+        return lr11xx_sim.busy_output_level;
+    }
+
+    if (lr11xx_sim.is_in_reset == true)
+    {
+        return 1;
+    }
+
+    if (lr11xx_sim.time_ns < lr11xx_sim.busy_until_ns)
+    {
+        // Nothing else happens while the host waits: jump to the end of the operation
+        lr11xx_sim.time_ns = lr11xx_sim.busy_until_ns;
+        return 1;
+    }
+
+    return 0;
+}
+
+void HT_SPI_TransmitReceive(uint8_t *tx_buffer, uint8_t *rx_buffer, uint16_t length)
+{
+    lr11xx_sim_advance_spi(length);
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        // tx_buffer and rx_buffer may be the same buffer: sample MOSI before driving MISO
+        const uint8_t mosi = tx_buffer[i];
+        uint8_t miso = LR11XX_NOP;
+
+        if (lr11xx_sim.is_nss_low == true)
+        {
+            if (lr11xx_sim.out_index < lr11xx_sim.out_length)
+            {
+                miso = lr11xx_sim.out[lr11xx_sim.out_index];
+                lr11xx_sim.out_crc = lr11xx_hal_compute_crc(lr11xx_sim.out_crc, &miso, 1);
+            }
+            else if ((lr11xx_sim.is_crc_enabled == true) && (lr11xx_sim.out_index == lr11xx_sim.out_length))
+            {
+                miso = lr11xx_sim.out_crc;
+            }
+            lr11xx_sim.out_index++;
+
+            if ((lr11xx_sim.is_response_frame == false) && (lr11xx_sim.frame_length < LR11XX_SIM_FRAME_MAX_LENGTH))
+            {
+                lr11xx_sim.frame[lr11xx_sim.frame_length++] = mosi;
+            }
+        }
+
+        rx_buffer[i] = miso;
+    }
+}
+
+void delay_us(uint32_t us)
+{
+    lr11xx_sim_advance_time_us(us);
+}
+
+/*
+ * The modem firmware is modelled at the HAL level only: every command succeeds and reads return zeros.
+ */
+lr1110_modem_hal_status_t lr1110_modem_hal_write(const void *context, const uint8_t *command,
+                                                 const uint16_t command_length, const uint8_t *data,
+                                                 const uint16_t data_length)
+{
+    (void)context;
+    (void)command;
+    (void)data;
+
+    lr11xx_sim_advance_spi(command_length + data_length);
+    lr11xx_sim_advance_time_us(lr11xx_sim.config.command_processing_us);
+
+    return LR1110_MODEM_HAL_STATUS_OK;
+}
+
+lr1110_modem_hal_status_t lr1110_modem_hal_read(const void *context, const uint8_t *command,
+                                                const uint16_t command_length, uint8_t *data,
+                                                const uint16_t data_length)
+{
+    (void)context;
+    (void)command;
+
+    memset(data, 0, data_length);
+    lr11xx_sim_advance_spi(command_length + data_length + 1);
+    lr11xx_sim_advance_time_us(lr11xx_sim.config.command_processing_us);
+
+    return LR1110_MODEM_HAL_STATUS_OK;
+}
+
+lr1110_modem_hal_status_t lr1110_modem_hal_write_read(const void *context, const uint8_t *command, uint8_t *data,
+                                                      const uint16_t data_length)
+{
+    (void)context;
+    (void)command;
+
+    memset(data, 0, data_length);
+    lr11xx_sim_advance_spi(data_length);
+
+    return LR1110_MODEM_HAL_STATUS_OK;
+}
+
+lr1110_modem_hal_status_t lr1110_modem_hal_write_without_rc(const void *context, const uint8_t *command,
+                                                            const uint16_t command_length, const uint8_t *data,
+                                                            const uint16_t data_length)
+{
+    return lr1110_modem_hal_write(context, command, command_length, data, data_length);
+}
+
+lr1110_modem_hal_status_t lr1110_modem_hal_reset(const void *context)
+{
+    (void)context;
+
+    lr11xx_sim_advance_time_us(lr11xx_sim.config.boot_us);
+
+    return LR1110_MODEM_HAL_STATUS_OK;
+}
+
+void lr1110_modem_hal_enter_dfu(const void *context)
+{
+    (void)context;
+
+    lr11xx_sim_boot(true);
+}
+
+lr1110_modem_hal_status_t lr1110_modem_hal_wakeup(const void *context)
+{
+    (void)context;
+
+    return LR1110_MODEM_HAL_STATUS_OK;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void lr11xx_sim_boot(const bool stay_in_bootloader)
+{
+    lr11xx_sim.mode = ((stay_in_bootloader == true) || (lr11xx_sim.has_firmware == false))
+                          ? LR11XX_SIM_MODE_BOOTLOADER
+                          : LR11XX_SIM_MODE_TRANSCEIVER;
+    lr11xx_sim.is_sleeping = false;
+    lr11xx_sim.is_response_pending = false;
+    lr11xx_sim.command_status = LR11XX_SIM_STAT1_CMD_OK;
+    lr11xx_sim.is_crc_enabled = false;
+    lr11xx_sim.irq_status = 0;
+    lr11xx_sim.irq_mask = 0;
+    lr11xx_sim.errors = 0;
+    lr11xx_sim.nb_results = 0;
+    lr11xx_sim.nb_country_code_results = 0;
+    lr11xx_sim.busy_until_ns = lr11xx_sim.time_ns + (uint64_t)lr11xx_sim.config.boot_us * 1000;
+}
+
+static uint8_t lr11xx_sim_stat1(void)
+{
+    const uint8_t irq_pending = ((lr11xx_sim.irq_status & lr11xx_sim.irq_mask) != 0) ? 0x01 : 0x00;
+
+    return (uint8_t)(lr11xx_sim.command_status << 1) | irq_pending;
+}
+
+static void lr11xx_sim_start_frame(void)
+{
+    if (lr11xx_sim.is_sleeping == true)
+    {
+        // The NSS falling edge wakes the radio up, the frame itself is lost
+        lr11xx_sim.is_sleeping = false;
+        lr11xx_sim.busy_until_ns = lr11xx_sim.time_ns + (uint64_t)lr11xx_sim.config.command_processing_us * 1000;
+    }
+
+    lr11xx_sim.frame_length = 0;
+    lr11xx_sim.out_index = 0;
+    lr11xx_sim.out_crc = LR11XX_HAL_CRC_INITIAL_VALUE;
+
+    if (lr11xx_sim.is_response_pending == true)
+    {
+        lr11xx_sim.response[0] = lr11xx_sim_stat1();
+        lr11xx_sim.out = lr11xx_sim.response;
+        lr11xx_sim.out_length = 1 + lr11xx_sim.response_length;
+        lr11xx_sim.is_response_frame = true;
+    }
+    else
+    {
+        const uint8_t stat2 = (lr11xx_sim.mode == LR11XX_SIM_MODE_TRANSCEIVER) ? 0x03 : 0x02;
+
+        lr11xx_sim.status[0] = lr11xx_sim_stat1();
+        lr11xx_sim.status[1] = stat2;
+        lr11xx_sim.status[2] = (uint8_t)(lr11xx_sim.irq_status >> 24);
+        lr11xx_sim.status[3] = (uint8_t)(lr11xx_sim.irq_status >> 16);
+        lr11xx_sim.status[4] = (uint8_t)(lr11xx_sim.irq_status >> 8);
+        lr11xx_sim.status[5] = (uint8_t)(lr11xx_sim.irq_status >> 0);
+        lr11xx_sim.out = lr11xx_sim.status;
+        lr11xx_sim.out_length = LR11XX_SIM_STATUS_LENGTH;
+        lr11xx_sim.is_response_frame = false;
+    }
+}
+
+static void lr11xx_sim_end_frame(void)
+{
+    if (lr11xx_sim.is_response_frame == true)
+    {
+        lr11xx_sim.is_response_pending = false;
+        return;
+    }
+
+    // A frame shorter than an opcode is a direct read
+    if (lr11xx_sim.frame_length < 2)
+    {
+        return;
+    }
+
+    uint16_t length = lr11xx_sim.frame_length;
+
+    lr11xx_sim.stats.nb_commands++;
+    lr11xx_sim.is_response_pending = false;
+
+    if (lr11xx_sim.is_crc_enabled == true)
+    {
+        length--;
+
+        if ((length < 2) ||
+            (lr11xx_hal_compute_crc(LR11XX_HAL_CRC_INITIAL_VALUE, lr11xx_sim.frame, length) != lr11xx_sim.frame[length]))
+        {
+            lr11xx_sim.stats.nb_crc_errors++;
+            lr11xx_sim.command_status = LR11XX_SIM_STAT1_CMD_PERR;
+            lr11xx_sim.busy_until_ns = lr11xx_sim.time_ns + (uint64_t)lr11xx_sim.config.command_processing_us * 1000;
+            return;
+        }
+    }
+
+    const uint16_t opcode = ((uint16_t)lr11xx_sim.frame[0] << 8) | lr11xx_sim.frame[1];
+
+    lr11xx_sim_execute(opcode, &lr11xx_sim.frame[2], length - 2);
+}
+
+static void lr11xx_sim_execute(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args)
+{
+    uint32_t busy_us = lr11xx_sim.config.command_processing_us;
+    bool is_modelled = false;
+
+    lr11xx_sim.response_length = 0;
+
+    if (lr11xx_sim.mode == LR11XX_SIM_MODE_BOOTLOADER)
+    {
+        is_modelled = lr11xx_sim_execute_bootloader(opcode, args, nb_args, &busy_us);
+    }
+    else
+    {
+        switch (opcode >> 8)
+        {
+        case 0x01:
+            is_modelled = lr11xx_sim_execute_system(opcode, args, nb_args, &busy_us);
+            break;
+        case 0x03:
+            is_modelled = lr11xx_sim_execute_wifi(opcode, args, nb_args, &busy_us);
+            break;
+        case 0x05:
+            is_modelled = lr11xx_sim_execute_crypto(opcode, args, nb_args, &busy_us);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (is_modelled == false)
+    {
+        lr11xx_sim.stats.nb_unmodelled_commands++;
+    }
+
+    lr11xx_sim.is_response_pending = (lr11xx_sim.response_length > 0);
+    lr11xx_sim.command_status =
+        (lr11xx_sim.is_response_pending == true) ? LR11XX_SIM_STAT1_CMD_DAT : LR11XX_SIM_STAT1_CMD_OK;
+
+    // A reboot already set BUSY for the boot time
+    const uint64_t busy_until_ns = lr11xx_sim.time_ns + (uint64_t)busy_us * 1000;
+    if (busy_until_ns > lr11xx_sim.busy_until_ns)
+    {
+        lr11xx_sim.busy_until_ns = busy_until_ns;
+    }
+}
+
+static bool lr11xx_sim_execute_system(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                      uint32_t *busy_us)
+{
+    uint8_t *response;
+
+    switch (opcode)
+    {
+    case 0x0100: // Clear reset status
+    case 0x0110: // Set regulator mode
+    case 0x0112: // Set DIO as RF switch
+    case 0x0116: // Configure LF clock
+    case 0x0117: // Set TCXO mode
+    case 0x011C: // Set standby
+    case 0x011D: // Set FS
+    case 0x012A: // Drive DIO in sleep mode
+        return true;
+    case 0x0101: // Get version
+        response = lr11xx_sim_respond(4);
+        response[0] = lr11xx_sim.config.hw_version;
+        response[1] = LR11XX_SIM_TYPE_TRANSCEIVER;
+        response[2] = (uint8_t)(lr11xx_sim.fw_version >> 8);
+        response[3] = (uint8_t)(lr11xx_sim.fw_version >> 0);
+        return true;
+    case 0x010D: // Get errors
+        response = lr11xx_sim_respond(2);
+        response[0] = (uint8_t)(lr11xx_sim.errors >> 8);
+        response[1] = (uint8_t)(lr11xx_sim.errors >> 0);
+        return true;
+    case 0x010E: // Clear errors
+        lr11xx_sim.errors = 0;
+        return true;
+    case 0x010F: // Calibrate
+    case 0x0111: // Calibrate image
+        *busy_us += lr11xx_sim.config.calibration_us;
+        return true;
+    case 0x0113: // Set DIO IRQ parameters
+        if (nb_args >= 4)
+        {
+            lr11xx_sim.irq_mask = ((uint32_t)args[0] << 24) | ((uint32_t)args[1] << 16) | ((uint32_t)args[2] << 8) |
+                                  ((uint32_t)args[3] << 0);
+        }
+        return true;
+    case 0x0114: // Clear IRQ
+        if (nb_args >= 4)
+        {
+            lr11xx_sim.irq_status &= ~(((uint32_t)args[0] << 24) | ((uint32_t)args[1] << 16) |
+                                       ((uint32_t)args[2] << 8) | ((uint32_t)args[3] << 0));
+        }
+        return true;
+    case 0x0118: // Reboot
+        lr11xx_sim_boot((nb_args >= 1) && (args[0] != 0));
+        return true;
+    case 0x0119: // Get VBAT
+        response = lr11xx_sim_respond(1);
+        response[0] = 0xA0;
+        return true;
+    case 0x011A: // Get temperature
+        response = lr11xx_sim_respond(2);
+        response[0] = 0x02;
+        response[1] = 0xC0;
+        return true;
+    case 0x011B: // Set sleep
+        lr11xx_sim.is_sleeping = true;
+        return true;
+    case 0x0120: // Get random number
+    {
+        const uint32_t random = lr11xx_sim_random();
+
+        response = lr11xx_sim_respond(4);
+        response[0] = (uint8_t)(random >> 24);
+        response[1] = (uint8_t)(random >> 16);
+        response[2] = (uint8_t)(random >> 8);
+        response[3] = (uint8_t)(random >> 0);
+        return true;
+    }
+    case 0x0121: // Erase infopage
+        memset(lr11xx_sim.infopage, 0xFF, sizeof(lr11xx_sim.infopage));
+        *busy_us += lr11xx_sim.config.flash_write_us;
+        return true;
+    case 0x0122: // Write infopage: id, address, words
+        if (nb_args >= 3)
+        {
+            const uint16_t address = ((uint16_t)args[1] << 8) | args[2];
+
+            for (uint16_t i = 3; (i < nb_args) && ((address + i - 3) < LR11XX_SIM_INFOPAGE_SIZE); i++)
+            {
+                lr11xx_sim.infopage[address + i - 3] = args[i];
+            }
+        }
+        *busy_us += lr11xx_sim.config.flash_write_us;
+        return true;
+    case 0x0123: // Read infopage: id, address, number of words
+        if (nb_args >= 4)
+        {
+            const uint16_t address = ((uint16_t)args[1] << 8) | args[2];
+            const uint16_t length = (uint16_t)args[3] * 4;
+
+            response = lr11xx_sim_respond(length);
+            for (uint16_t i = 0; i < length; i++)
+            {
+                response[i] =
+                    ((address + i) < LR11XX_SIM_INFOPAGE_SIZE) ? lr11xx_sim.infopage[address + i] : 0xFF;
+            }
+        }
+        return true;
+    case 0x0125: // Read UID
+    case 0x0126: // Read join EUI
+        response = lr11xx_sim_respond(8);
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            response[i] = (uint8_t)((opcode & 0x0F) << 4) | i;
+        }
+        return true;
+    case 0x0127: // Read PIN
+        response = lr11xx_sim_respond(4);
+        response[0] = 0x12;
+        response[1] = 0x34;
+        response[2] = 0x56;
+        response[3] = 0x78;
+        return true;
+    case 0x0128: // Enable SPI CRC, applies to the next command
+        lr11xx_sim.is_crc_enabled = (nb_args >= 1) && ((args[0] & 0x01) != 0);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool lr11xx_sim_execute_wifi(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                    uint32_t *busy_us)
+{
+    uint8_t *response;
+
+    switch (opcode)
+    {
+    case 0x0300: // Scan: type, channels, mode, max results, scans per channel, timeout, abort on timeout
+        if (nb_args >= 8)
+        {
+            const uint32_t dwell_us = (((uint32_t)args[6] << 8) | args[7]) * 1000;
+
+            lr11xx_sim_wifi_scan(args[0], ((uint16_t)args[1] << 8) | args[2], args[3], args[4], args[5], dwell_us,
+                                 busy_us);
+        }
+        return true;
+    case 0x0301: // Scan time limit: type, channels, mode, max results, timeout per channel, timeout per scan
+        if (nb_args >= 9)
+        {
+            const uint32_t dwell_us = (((uint32_t)args[7] << 8) | args[8]) * 1000;
+
+            lr11xx_sim_wifi_scan(args[0], ((uint16_t)args[1] << 8) | args[2], args[3], args[4], 1, dwell_us,
+                                 busy_us);
+        }
+        return true;
+    case 0x0302: // Search country code: channels, max results, scans per channel, timeout, abort on timeout
+        if (nb_args >= 6)
+        {
+            const uint32_t dwell_us = (((uint32_t)args[4] << 8) | args[5]) * 1000;
+
+            lr11xx_sim.stats.nb_scans++;
+            lr11xx_sim.nb_country_code_results =
+                lr11xx_sim_wifi_receive(LR11XX_SIM_WIFI_TYPE_SCAN_B_G_N, ((uint16_t)args[0] << 8) | args[1], args[2],
+                                        args[3], dwell_us, true, lr11xx_sim.country_code_results, busy_us);
+        }
+        return true;
+    case 0x0303: // Search country code time limit: channels, max results, timeout per channel, timeout per scan
+        if (nb_args >= 5)
+        {
+            const uint32_t dwell_us = (((uint32_t)args[3] << 8) | args[4]) * 1000;
+
+            lr11xx_sim.stats.nb_scans++;
+            lr11xx_sim.nb_country_code_results =
+                lr11xx_sim_wifi_receive(LR11XX_SIM_WIFI_TYPE_SCAN_B_G_N, ((uint16_t)args[0] << 8) | args[1], args[2],
+                                        1, dwell_us, true, lr11xx_sim.country_code_results, busy_us);
+        }
+        return true;
+    case 0x0305: // Get number of results
+        response = lr11xx_sim_respond(1);
+        response[0] = lr11xx_sim.nb_results;
+        return true;
+    case 0x0306: // Read results: start index, number, format
+        if (nb_args >= 3)
+        {
+            lr11xx_sim_wifi_read_results(args[0], args[1], args[2]);
+        }
+        return true;
+    case 0x0307: // Reset cumulative timing
+        lr11xx_sim.timing_detection_us = 0;
+        lr11xx_sim.timing_correlation_us = 0;
+        lr11xx_sim.timing_capture_us = 0;
+        lr11xx_sim.timing_demodulation_us = 0;
+        return true;
+    case 0x0308: // Read cumulative timing
+    {
+        const uint32_t timings[4] = {lr11xx_sim.timing_detection_us, lr11xx_sim.timing_correlation_us,
+                                     lr11xx_sim.timing_capture_us, lr11xx_sim.timing_demodulation_us};
+
+        response = lr11xx_sim_respond(16);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            response[4 * i + 0] = (uint8_t)(timings[i] >> 24);
+            response[4 * i + 1] = (uint8_t)(timings[i] >> 16);
+            response[4 * i + 2] = (uint8_t)(timings[i] >> 8);
+            response[4 * i + 3] = (uint8_t)(timings[i] >> 0);
+        }
+        return true;
+    }
+    case 0x0309: // Get country code result size
+        response = lr11xx_sim_respond(1);
+        response[0] = lr11xx_sim.nb_country_code_results;
+        return true;
+    case 0x030A: // Read country code results: start index, number
+        if (nb_args >= 2)
+        {
+            lr11xx_sim_wifi_read_country_code_results(args[0], args[1]);
+        }
+        return true;
+    case 0x030B: // Configure timestamp AP phone
+        return true;
+    case 0x0320: // Get Wi-Fi firmware version
+        response = lr11xx_sim_respond(2);
+        response[0] = 0x01;
+        response[1] = 0x03;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool lr11xx_sim_execute_crypto(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                      uint32_t *busy_us)
+{
+    (void)args;
+
+    // Crypto engine: every operation succeeds (status 0) and produces zeroed data
+    switch (opcode)
+    {
+    case 0x0500: // Select
+        return true;
+    case 0x0502: // Set key
+    case 0x0503: // Derive key
+    case 0x0506: // Verify AES CMAC
+    case 0x050A: // Store to flash
+    case 0x050B: // Restore from flash
+    case 0x050D: // Set parameter
+        (void)lr11xx_sim_respond(1);
+        return true;
+    case 0x0505: // Compute AES CMAC
+    case 0x050E: // Get parameter
+        (void)lr11xx_sim_respond(1 + 4);
+        return true;
+    case 0x0507: // Encrypt AES-01
+    case 0x0508: // Encrypt AES
+    case 0x0509: // Decrypt AES: key id then data
+        (void)lr11xx_sim_respond(1 + ((nb_args > 1) ? nb_args - 1 : 0));
+        return true;
+    case 0x0504: // Process join accept: key ids, version, header, data
+        (void)lr11xx_sim_respond(1 + ((nb_args > 3) ? nb_args - 3 : 0));
+        return true;
+    case 0x050F: // Check encrypted firmware image
+        *busy_us += lr11xx_sim.config.flash_write_us;
+        return true;
+    case 0x0510: // Get check encrypted firmware image result
+        lr11xx_sim_respond(1)[0] = 0x01;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool lr11xx_sim_execute_bootloader(const uint16_t opcode, const uint8_t *args, const uint16_t nb_args,
+                                          uint32_t *busy_us)
+{
+    uint8_t *response;
+
+    switch (opcode)
+    {
+    case 0x0100: // Clear reset status
+        return true;
+    case 0x0101: // Get version
+        response = lr11xx_sim_respond(4);
+        response[0] = lr11xx_sim.config.hw_version;
+        response[1] = LR11XX_SIM_TYPE_BOOTLOADER;
+        response[2] = (uint8_t)(lr11xx_sim.config.bootloader_version >> 8);
+        response[3] = (uint8_t)(lr11xx_sim.config.bootloader_version >> 0);
+        return true;
+    case 0x8000: // Erase flash
+        lr11xx_sim.has_firmware = false;
+        lr11xx_sim.nb_flash_bytes = 0;
+        *busy_us += lr11xx_sim.config.flash_erase_us;
+        return true;
+    case 0x8003: // Write flash encrypted: offset then data
+        if (nb_args > 4)
+        {
+            lr11xx_sim.nb_flash_bytes += nb_args - 4;
+        }
+        *busy_us += lr11xx_sim.config.flash_write_us;
+        return true;
+    case 0x8005: // Reboot
+        if (lr11xx_sim.nb_flash_bytes > 0)
+        {
+            lr11xx_sim.has_firmware = true;
+            lr11xx_sim.fw_version = lr11xx_sim.config.fw_version_after_update;
+        }
+        lr11xx_sim_boot((nb_args >= 1) && (args[0] != 0));
+        return true;
+    case 0x800B: // Get PIN
+        response = lr11xx_sim_respond(4);
+        response[0] = 0x12;
+        response[1] = 0x34;
+        response[2] = 0x56;
+        response[3] = 0x78;
+        return true;
+    case 0x800C: // Read chip EUI
+    case 0x800D: // Read join EUI
+        response = lr11xx_sim_respond(8);
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            response[i] = (uint8_t)((opcode & 0x0F) << 4) | i;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void lr11xx_sim_wifi_scan(const uint8_t signal_type, const uint16_t channels, const uint8_t scan_mode,
+                                 const uint8_t max_results, const uint8_t nb_scan_per_channel,
+                                 const uint32_t dwell_us, uint32_t *busy_us)
+{
+    lr11xx_sim.stats.nb_scans++;
+    lr11xx_sim.last_scan_mode = scan_mode;
+    lr11xx_sim.nb_results = lr11xx_sim_wifi_receive(signal_type, channels, max_results, nb_scan_per_channel, dwell_us,
+                                                    false, lr11xx_sim.results, busy_us);
+}
+
+/*!
+ * @brief Receive the beacons of the access points on the given channels, as a scan or a country code search
+ *
+ * A country code search only reports the access points whose beacons carry a country code.
+ *
+ * @returns Number of results stored in results
+ */
+static uint8_t lr11xx_sim_wifi_receive(const uint8_t signal_type, const uint16_t channels, const uint8_t max_results,
+                                       const uint8_t nb_scan_per_channel, const uint32_t dwell_us,
+                                       const bool is_country_code_search, lr11xx_sim_wifi_result_t *results,
+                                       uint32_t *busy_us)
+{
+    const uint8_t nb_max_results = (max_results < LR11XX_SIM_MAX_RESULTS) ? max_results : LR11XX_SIM_MAX_RESULTS;
+    uint8_t nb_results = 0;
+    uint32_t duration_us = 0;
+
+    for (uint8_t channel = 1; channel <= 14; channel++)
+    {
+        bool is_channel_busy = false;
+
+        if ((channels & (1U << (channel - 1))) == 0)
+        {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < lr11xx_sim.nb_access_points; i++)
+        {
+            const lr11xx_sim_access_point_t *access_point = &lr11xx_sim.access_points[i];
+
+            // Scan type 4 is B, G and N; G and N scans see both G and N access points
+            if ((access_point->channel != channel) ||
+                ((signal_type == 1) && (access_point->signal_type != 1)) ||
+                (((signal_type == 2) || (signal_type == 3)) && (access_point->signal_type == 1)))
+            {
+                continue;
+            }
+
+            is_channel_busy = true;
+
+            if ((is_country_code_search == true) && (access_point->country_code[0] == '\0'))
+            {
+                continue;
+            }
+
+            if ((nb_results < nb_max_results) &&
+                ((lr11xx_sim_random() % 100) < access_point->detection_percent))
+            {
+                const int32_t jitter = (lr11xx_sim.config.rssi_jitter_db > 0)
+                                           ? (int32_t)(lr11xx_sim_random() % (2U * lr11xx_sim.config.rssi_jitter_db + 1)) -
+                                                 lr11xx_sim.config.rssi_jitter_db
+                                           : 0;
+                int32_t rssi_dbm = access_point->rssi_dbm + jitter;
+
+                if (rssi_dbm > -1)
+                {
+                    rssi_dbm = -1;
+                }
+
+                results[nb_results].access_point = i;
+                results[nb_results].rssi_dbm = (int8_t)rssi_dbm;
+                results[nb_results].timestamp_us = lr11xx_sim_get_time_us() + duration_us;
+                nb_results++;
+            }
+        }
+
+        duration_us += nb_scan_per_channel * ((is_channel_busy == true) ? dwell_us : lr11xx_sim.config.wifi_empty_channel_us);
+    }
+
+    const uint32_t demodulation_us = nb_results * lr11xx_sim.config.wifi_demodulation_us;
+
+    lr11xx_sim.timing_detection_us += duration_us;
+    lr11xx_sim.timing_capture_us += duration_us;
+    lr11xx_sim.timing_demodulation_us += demodulation_us;
+
+    lr11xx_sim.irq_status |= LR11XX_SIM_IRQ_WIFI_SCAN_DONE;
+    *busy_us += duration_us + demodulation_us;
+
+    return nb_results;
+}
+
+static void lr11xx_sim_wifi_read_results(const uint8_t start_index, const uint8_t nb_results,
+                                         const uint8_t format_code)
+{
+    uint8_t result_size = LR11XX_SIM_BASIC_COMPLETE_RESULT_SIZE;
+
+    // The basic complete and extended full formats share a code: the scan mode tells them apart
+    if (format_code == LR11XX_SIM_WIFI_FORMAT_CODE_MAC_TYPE_CHANNEL)
+    {
+        result_size = LR11XX_SIM_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE;
+    }
+    else if (lr11xx_sim.last_scan_mode == LR11XX_SIM_WIFI_SCAN_MODE_FULL_BEACON)
+    {
+        result_size = LR11XX_SIM_EXTENDED_RESULT_SIZE;
+    }
+
+    uint8_t *response = lr11xx_sim_respond((uint16_t)nb_results * result_size);
+
+    for (uint8_t n = 0; n < nb_results; n++)
+    {
+        uint8_t *result = &response[n * result_size];
+        const uint8_t index = start_index + n;
+
+        if (index >= lr11xx_sim.nb_results)
+        {
+            break;
+        }
+
+        const lr11xx_sim_access_point_t *access_point =
+            &lr11xx_sim.access_points[lr11xx_sim.results[index].access_point];
+        const uint64_t timestamp_us = lr11xx_sim.results[index].timestamp_us;
+
+        result[0] = access_point->signal_type; // Data rate 0
+        result[1] = access_point->channel | (1 << 4);
+        result[2] = (uint8_t)lr11xx_sim.results[index].rssi_dbm;
+
+        if (result_size == LR11XX_SIM_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE)
+        {
+            memcpy(&result[3], access_point->mac_address, 6);
+        }
+        else if (result_size == LR11XX_SIM_BASIC_COMPLETE_RESULT_SIZE)
+        {
+            result[3] = (0x08 << 2); // Management frame, beacon subtype
+            memcpy(&result[4], access_point->mac_address, 6);
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                result[12 + i] = (uint8_t)(timestamp_us >> (56 - 8 * i));
+            }
+            result[20] = (uint8_t)(access_point->beacon_period_tu >> 8);
+            result[21] = (uint8_t)(access_point->beacon_period_tu >> 0);
+        }
+        else
+        {
+            result[8] = 0x80; // Frame control: beacon
+            memset(&result[10], 0xFF, 6);
+            memcpy(&result[16], access_point->mac_address, 6);
+            memcpy(&result[22], access_point->mac_address, 6);
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                result[28 + i] = (uint8_t)(timestamp_us >> (56 - 8 * i));
+            }
+            result[36] = (uint8_t)(access_point->beacon_period_tu >> 8);
+            result[37] = (uint8_t)(access_point->beacon_period_tu >> 0);
+            memcpy(&result[40], access_point->ssid, sizeof(access_point->ssid));
+            result[72] = access_point->channel;
+            memcpy(&result[73], access_point->country_code, 2);
+            result[76] = 0x03; // FCS checked and valid
+        }
+    }
+}
+
+static void lr11xx_sim_wifi_read_country_code_results(const uint8_t start_index, const uint8_t nb_results)
+{
+    uint8_t *response = lr11xx_sim_respond((uint16_t)nb_results * LR11XX_SIM_COUNTRY_CODE_RESULT_SIZE);
+
+    for (uint8_t n = 0; n < nb_results; n++)
+    {
+        uint8_t *result = &response[n * LR11XX_SIM_COUNTRY_CODE_RESULT_SIZE];
+        const uint8_t index = start_index + n;
+
+        if (index >= lr11xx_sim.nb_country_code_results)
+        {
+            break;
+        }
+
+        const lr11xx_sim_access_point_t *access_point =
+            &lr11xx_sim.access_points[lr11xx_sim.country_code_results[index].access_point];
+
+        memcpy(&result[0], access_point->country_code, 2);
+        result[2] = ' '; // I/O regulation: any environment
+        result[3] = access_point->channel | (1 << 4);
+        // The MAC address is sent last byte first
+        for (uint8_t i = 0; i < 6; i++)
+        {
+            result[4 + i] = access_point->mac_address[5 - i];
+        }
+    }
+}
+
+/*!
+ * @brief Reserve a zeroed response of the given length for the command being executed
+ */
+static uint8_t *lr11xx_sim_respond(const uint16_t length)
+{
+    const uint16_t max_length = LR11XX_SIM_RESPONSE_MAX_LENGTH - 1;
+
+    lr11xx_sim.response_length = (length < max_length) ? length : max_length;
+    memset(&lr11xx_sim.response[1], 0, lr11xx_sim.response_length);
+
+    return &lr11xx_sim.response[1];
+}
+
+static uint32_t lr11xx_sim_random(void)
+{
+    uint32_t x = lr11xx_sim.random_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    lr11xx_sim.random_state = x;
+
+    return x;
+}
+
+static void lr11xx_sim_advance_spi(const uint16_t length)
+{
+    if (lr11xx_sim.config.spi_bitrate_hz != 0)
+    {
+        lr11xx_sim.time_ns += ((uint64_t)length * 8 * 1000000000) / lr11xx_sim.config.spi_bitrate_hz;
+    }
+}
+
+#endif // LR11XX_SIM
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -149,6 +149,11 @@ static void lr11xx_system_convert_stat1_byte_to_enum(uint8_t stat1_byte, lr11xx_
  */
 static void lr11xx_system_convert_stat2_byte_to_enum(uint8_t stat2_byte, lr11xx_system_stat2_t *stat2);
 
+/*!
+ * @brief HAL job running @ref lr11xx_system_get_and_clear_irq_status from the HAL worker task
+ */
+static lr11xx_hal_status_t lr11xx_system_get_and_clear_irq_status_job(const lr11xx_hal_async_request_t *request);
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -361,6 +366,20 @@ lr11xx_status_t lr11xx_system_get_and_clear_irq_status(const void *context, lr11
     return status;
 }
 
+lr11xx_status_t lr11xx_system_get_and_clear_irq_status_async(const void *context, lr11xx_system_irq_mask_t *irq,
+                                                             lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    const lr11xx_hal_async_request_t request = {
+        .job = lr11xx_system_get_and_clear_irq_status_job,
+        .context = context,
+        .rx_data = (uint8_t *)irq,
+        .callback = callback,
+        .user_data = user_data,
+    };
+
+    return (lr11xx_status_t)lr11xx_hal_async_submit(&request);
+}
+
 lr11xx_status_t lr11xx_system_cfg_lfclk(const void *context, const lr11xx_system_lfclk_cfg_t lfclock_cfg,
                                         const bool wait_for_32k_ready)
 {
@@ -492,20 +511,8 @@ lr11xx_status_t lr11xx_system_write_infopage(const void *context, const lr11xx_s
         (uint8_t)(address >> 8),
         (uint8_t)(address >> 0),
     };
-    uint8_t cdata[256];
-
-    for (uint16_t index = 0; index < length; index++)
-    {
-        uint8_t *cdata_local = &cdata[index * sizeof(uint32_t)];
-
-        cdata_local[0] = (uint8_t)(data[index] >> 24);
-        cdata_local[1] = (uint8_t)(data[index] >> 16);
-        cdata_local[2] = (uint8_t)(data[index] >> 8);
-        cdata_local[3] = (uint8_t)(data[index] >> 0);
-    }
-
-    return (lr11xx_status_t)lr11xx_hal_write(context, cbuffer, LR11XX_SYSTEM_WRITE_INFOPAGE_CMD_LENGTH, cdata,
-                                             length * sizeof(uint32_t));
+    return (lr11xx_status_t)lr11xx_hal_write_be32(context, cbuffer, LR11XX_SYSTEM_WRITE_INFOPAGE_CMD_LENGTH, data,
+                                                  length);
 }
 
 lr11xx_status_t lr11xx_system_read_infopage(const void *context, const lr11xx_system_infopage_id_t infopage_id,
@@ -619,7 +626,16 @@ lr11xx_status_t lr11xx_system_enable_spi_crc(const void *context, bool enable_cr
         (enable_crc == true) ? 0x01 : 0x00,
     };
 
-    return (lr11xx_status_t)lr11xx_hal_write(context, cbuffer, LR11XX_SYSTEM_ENABLE_SPI_CRC_CMD_LENGTH, 0, 0);
+    // The command is sent in the current CRC mode, the new mode applies to the following transactions
+    const lr11xx_hal_status_t hal_status =
+        lr11xx_hal_write(context, cbuffer, LR11XX_SYSTEM_ENABLE_SPI_CRC_CMD_LENGTH, 0, 0);
+
+    if (hal_status == LR11XX_HAL_STATUS_OK)
+    {
+        lr11xx_hal_set_crc_mode(context, enable_crc);
+    }
+
+    return (lr11xx_status_t)hal_status;
 }
 
 lr11xx_status_t lr11xx_system_drive_dio_in_sleep_mode(const void *context, bool enable_drive)
@@ -658,4 +674,10 @@ static void lr11xx_system_convert_stat2_byte_to_enum(uint8_t stat2_byte, lr11xx_
     }
 }
 
+static lr11xx_hal_status_t lr11xx_system_get_and_clear_irq_status_job(const lr11xx_hal_async_request_t *request)
+{
+    return (lr11xx_hal_status_t)lr11xx_system_get_and_clear_irq_status(request->context,
+                                                                       (lr11xx_system_irq_mask_t *)request->rx_data);
+}
+
 /* --- EOF ------------------------------------------------------------------ */
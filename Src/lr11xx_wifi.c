@@ -40,9 +40,11 @@
 // #include "lr11xx_wifi.h"
 // #include "lr11xx_system_types.h"
 // #include "lr11xx_hal.h"
+#include <string.h>
 #include "LR1110_Driver/lr11xx_wifi.h"
 #include "LR1110_Driver/lr11xx_system_types.h"
 #include "LR1110_Driver/lr11xx_hal.h"
+#include "LR1110_Driver/lr11xx_energy.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -63,6 +65,11 @@
  */
 #define IS_BETWEEN_0x80_AND_0xBF(value) IS_BETWEEN(value, 0x80, 0xBF)
 
+/*!
+ * @brief Most significant bit of each byte of a 32-bit word, set in any byte that is not ASCII
+ */
+#define LR11XX_WIFI_NON_ASCII_WORD_MASK (0x80808080UL)
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -71,9 +78,6 @@
 #define LR11XX_WIFI_BASIC_COMPLETE_RESULT_SIZE (22)
 #define LR11XX_WIFI_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE (9)
 
-#define LR11XX_WIFI_MAX_SIZE_PER_SPI(single_size) \
-    (single_size * (LR11XX_WIFI_MAX_RESULT_PER_TRANSACTION(single_size)))
-
 #define LR11XX_WIFI_MAX_RESULT_PER_TRANSACTION(single_size) \
     (MIN((LR11XX_WIFI_READ_RESULT_LIMIT) / (single_size), LR11XX_WIFI_N_RESULTS_MAX_PER_CHUNK))
 
@@ -100,15 +104,6 @@
 #define LR11XX_WIFI_CFG_TIMESTAMP_AP_PHONE_CMD_LENGTH (2 + 4)
 #define LR11XX_WIFI_GET_VERSION_CMD_LENGTH (2)
 
-/*!
- * @brief Wi-Fi scan power consumption
- *
- * @note these numbers are given for information, it should be modified according to the used hardware.
- */
-#define LR11XX_WIFI_CORRELATION_UA (12000)
-#define LR11XX_WIFI_CAPTURE_UA (12000)
-#define LR11XX_WIFI_DEMODULATION_UA (4000)
-
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -143,6 +138,16 @@ typedef union
     lr11xx_wifi_extended_full_result_t *extended_complete;
 } lr11xx_wifi_result_interface_t;
 
+/*!
+ * @brief Destination of the results decoded while they are read, see @ref generic_results_interpreter
+ */
+typedef struct
+{
+    lr11xx_wifi_result_interface_t result_interface;
+    lr11xx_wifi_result_format_t format_code;
+    uint8_t index_result_start_writing; //!< Where the first result of the transaction is written
+} lr11xx_wifi_result_stream_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -173,46 +178,40 @@ static uint16_t uint16_from_array(const uint8_t *array, const uint16_t index);
 static uint64_t uint64_from_array(const uint8_t *array, const uint16_t index);
 
 /*!
- * @brief Propagate the result buffer interpretation depending on the format_code selected
+ * @brief Interpret one result record as it is received, depending on the format_code selected
+ *
+ * Called by the HAL for each record of a read result transaction, user_data is a lr11xx_wifi_result_stream_t.
  *
  * @see interpret_basic_complete_result_from_buffer, interpret_basic_mac_type_channel_result_from_buffer,
  * interpret_extended_full_result_from_buffer
  */
-static void generic_results_interpreter(const uint8_t n_result_to_parse, const uint8_t index_result_start_writing,
-                                        const uint8_t *buffer, lr11xx_wifi_result_interface_t result_interface,
-                                        const lr11xx_wifi_result_format_t format_code);
+static void generic_results_interpreter(void *user_data, const uint16_t index, const uint8_t *record);
 
 /*!
  * @brief Parse basic complete result
  */
-static void interpret_basic_complete_result_from_buffer(const uint8_t nb_results,
-                                                        const uint8_t index_result_start_writing,
-                                                        const uint8_t *buffer,
+static void interpret_basic_complete_result_from_buffer(const uint8_t *buffer,
                                                         lr11xx_wifi_basic_complete_result_t *result);
 
 /*!
  * @brief Parse basic MAC - type - channel result
  */
-static void interpret_basic_mac_type_channel_result_from_buffer(const uint8_t nb_results,
-                                                                const uint8_t index_result_start_writing,
-                                                                const uint8_t *buffer,
+static void interpret_basic_mac_type_channel_result_from_buffer(const uint8_t *buffer,
                                                                 lr11xx_wifi_basic_mac_type_channel_result_t *result);
 
 /*!
  * @brief Parse extended full result
  */
-static void interpret_extended_full_result_from_buffer(const uint8_t nb_results,
-                                                       const uint8_t index_result_start_writing, const uint8_t *buffer,
+static void interpret_extended_full_result_from_buffer(const uint8_t *buffer,
                                                        lr11xx_wifi_extended_full_result_t *result);
 
 /*!
- * @brief Parse basic MAC - type - channel result
+ * @brief Fetch results by chunks of at most nb_results_per_chunk_max, decoding them while they are received
  */
 static lr11xx_status_t fetch_and_aggregate_all_results(const void *context, const uint8_t index_result_start,
                                                        const uint8_t nb_results,
                                                        const uint8_t nb_results_per_chunk_max,
                                                        const lr11xx_wifi_result_format_t result_format_code,
-                                                       uint8_t *result_buffer,
                                                        lr11xx_wifi_result_interface_t result_structures);
 
 /*!
@@ -228,8 +227,7 @@ static uint8_t lr11xx_wifi_get_result_size_from_format(const lr11xx_wifi_result_
  * @returns Operation status
  */
 static lr11xx_hal_status_t lr11xx_wifi_read_results_helper(const void *context, const uint8_t start_index,
-                                                           const uint8_t n_elem, uint8_t *buffer,
-                                                           const lr11xx_wifi_result_format_t result_format);
+                                                           const uint8_t n_elem, lr11xx_wifi_result_stream_t *stream);
 
 /*!
  * @brief Extract Wi-Fi MAC address from a buffer
@@ -244,6 +242,22 @@ static void lr11xx_wifi_read_mac_address_from_buffer(const uint8_t *buffer, cons
  */
 static uint8_t lr11xx_wifi_get_format_code(const lr11xx_wifi_result_format_t format);
 
+/*!
+ * @brief HAL job reading Wi-Fi results from the HAL worker task
+ *
+ * The request param holds the start index (bits 0-7), the number of results (bits 8-15) and the result format (bits
+ * 16-23). The results array is carried by rx_data.
+ */
+static lr11xx_hal_status_t lr11xx_wifi_read_results_job(const lr11xx_hal_async_request_t *request);
+
+/*!
+ * @brief Build and submit a request for @ref lr11xx_wifi_read_results_job
+ */
+static lr11xx_status_t lr11xx_wifi_read_results_async(const void *context, const uint8_t start_result_index,
+                                                      const uint8_t nb_results,
+                                                      const lr11xx_wifi_result_format_t result_format, void *results,
+                                                      lr11xx_hal_async_callback_t callback, void *user_data);
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -348,7 +362,6 @@ lr11xx_status_t lr11xx_wifi_read_basic_complete_results(const void *context, con
                                                         const uint8_t nb_results,
                                                         lr11xx_wifi_basic_complete_result_t *results)
 {
-    uint8_t result_buffer[LR11XX_WIFI_MAX_SIZE_PER_SPI(LR11XX_WIFI_BASIC_COMPLETE_RESULT_SIZE)] = {0};
     const uint8_t nb_results_per_chunk_max =
         LR11XX_WIFI_MAX_RESULT_PER_TRANSACTION(LR11XX_WIFI_BASIC_COMPLETE_RESULT_SIZE);
 
@@ -356,14 +369,13 @@ lr11xx_status_t lr11xx_wifi_read_basic_complete_results(const void *context, con
     result_interface.basic_complete = results;
 
     return fetch_and_aggregate_all_results(context, start_result_index, nb_results, nb_results_per_chunk_max,
-                                           LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE, result_buffer, result_interface);
+                                           LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE, result_interface);
 }
 
 lr11xx_status_t lr11xx_wifi_read_basic_mac_type_channel_results(const void *context, const uint8_t start_result_index,
                                                                 const uint8_t nb_results,
                                                                 lr11xx_wifi_basic_mac_type_channel_result_t *results)
 {
-    uint8_t result_buffer[LR11XX_WIFI_MAX_SIZE_PER_SPI(LR11XX_WIFI_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE)] = {0};
     const uint8_t nb_results_per_chunk_max =
         LR11XX_WIFI_MAX_RESULT_PER_TRANSACTION(LR11XX_WIFI_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE);
 
@@ -371,15 +383,13 @@ lr11xx_status_t lr11xx_wifi_read_basic_mac_type_channel_results(const void *cont
     result_interface.basic_mac_type_channel = results;
 
     return fetch_and_aggregate_all_results(context, start_result_index, nb_results, nb_results_per_chunk_max,
-                                           LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL, result_buffer,
-                                           result_interface);
+                                           LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL, result_interface);
 }
 
 lr11xx_status_t lr11xx_wifi_read_extended_full_results(const void *radio, const uint8_t start_result_index,
                                                        const uint8_t nb_results,
                                                        lr11xx_wifi_extended_full_result_t *results)
 {
-    uint8_t result_buffer[LR11XX_WIFI_MAX_SIZE_PER_SPI(LR11XX_WIFI_EXTENDED_COMPLETE_RESULT_SIZE)] = {0};
     const uint8_t nb_results_per_chunk_max =
         LR11XX_WIFI_MAX_RESULT_PER_TRANSACTION(LR11XX_WIFI_EXTENDED_COMPLETE_RESULT_SIZE);
 
@@ -387,7 +397,98 @@ lr11xx_status_t lr11xx_wifi_read_extended_full_results(const void *radio, const
     result_interface.extended_complete = results;
 
     return fetch_and_aggregate_all_results(radio, start_result_index, nb_results, nb_results_per_chunk_max,
-                                           LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL, result_buffer, result_interface);
+                                           LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL, result_interface);
+}
+
+lr11xx_status_t lr11xx_wifi_fetch_all_results(const void *context, const lr11xx_wifi_result_format_t result_format,
+                                              void *results, const uint8_t max_results, uint8_t *nb_results)
+{
+    uint8_t nb_available_results = 0;
+
+    *nb_results = 0;
+
+    const lr11xx_status_t status = lr11xx_wifi_get_nb_results(context, &nb_available_results);
+    if (status != LR11XX_STATUS_OK)
+    {
+        return status;
+    }
+
+    const uint8_t nb_results_to_read = MIN(nb_available_results, max_results);
+    if (nb_results_to_read == 0)
+    {
+        return LR11XX_STATUS_OK;
+    }
+
+    switch (result_format)
+    {
+    case LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE:
+        if (lr11xx_wifi_read_basic_complete_results(context, 0, nb_results_to_read,
+                                                    (lr11xx_wifi_basic_complete_result_t *)results) != LR11XX_STATUS_OK)
+        {
+            return LR11XX_STATUS_ERROR;
+        }
+        break;
+    case LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL:
+        if (lr11xx_wifi_read_basic_mac_type_channel_results(
+                context, 0, nb_results_to_read, (lr11xx_wifi_basic_mac_type_channel_result_t *)results) !=
+            LR11XX_STATUS_OK)
+        {
+            return LR11XX_STATUS_ERROR;
+        }
+        break;
+    case LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL:
+        if (lr11xx_wifi_read_extended_full_results(context, 0, nb_results_to_read,
+                                                   (lr11xx_wifi_extended_full_result_t *)results) != LR11XX_STATUS_OK)
+        {
+            return LR11XX_STATUS_ERROR;
+        }
+        break;
+    default:
+        return LR11XX_STATUS_ERROR;
+    }
+
+    *nb_results = nb_results_to_read;
+
+    return LR11XX_STATUS_OK;
+}
+
+lr11xx_status_t lr11xx_wifi_get_nb_results_async(const void *context, uint8_t *nb_results,
+                                                 lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    const uint8_t cbuffer[LR11XX_WIFI_GET_RESULT_SIZE_CMD_LENGTH] = {
+        (uint8_t)(LR11XX_WIFI_GET_RESULT_SIZE_OC >> 8),
+        (uint8_t)(LR11XX_WIFI_GET_RESULT_SIZE_OC >> 0),
+    };
+
+    return (lr11xx_status_t)lr11xx_hal_read_async(context, cbuffer, LR11XX_WIFI_GET_RESULT_SIZE_CMD_LENGTH,
+                                                  nb_results, sizeof(*nb_results), callback, user_data);
+}
+
+lr11xx_status_t lr11xx_wifi_read_basic_complete_results_async(const void *context, const uint8_t start_result_index,
+                                                              const uint8_t nb_results,
+                                                              lr11xx_wifi_basic_complete_result_t *results,
+                                                              lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    return lr11xx_wifi_read_results_async(context, start_result_index, nb_results,
+                                          LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE, results, callback, user_data);
+}
+
+lr11xx_status_t lr11xx_wifi_read_basic_mac_type_channel_results_async(
+    const void *context, const uint8_t start_result_index, const uint8_t nb_results,
+    lr11xx_wifi_basic_mac_type_channel_result_t *results, lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    return lr11xx_wifi_read_results_async(context, start_result_index, nb_results,
+                                          LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL, results, callback,
+                                          user_data);
+}
+
+lr11xx_status_t lr11xx_wifi_read_extended_full_results_async(const void *context, const uint8_t start_result_index,
+                                                             const uint8_t nb_results,
+                                                             lr11xx_wifi_extended_full_result_t *results,
+                                                             lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    return lr11xx_wifi_read_results_async(context, start_result_index, nb_results,
+                                          LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL, results, callback, user_data);
 }
 
 lr11xx_status_t lr11xx_wifi_reset_cumulative_timing(const void *context)
@@ -464,7 +565,7 @@ lr11xx_status_t lr11xx_wifi_read_country_code_results(const void *context, const
     {
         for (uint8_t result_index = 0; result_index < nb_country_results; result_index++)
         {
-            const uint8_t local_index = result_index * LR11XX_WIFI_SCAN_SINGLE_COUNTRY_CODE_RESULT_SIZE;
+            const uint16_t local_index = result_index * LR11XX_WIFI_SCAN_SINGLE_COUNTRY_CODE_RESULT_SIZE;
             lr11xx_wifi_country_code_t *local_country_code_result = &country_code_results[result_index];
 
             local_country_code_result->country_code[0] = rbuffer[local_index + 0];
@@ -558,22 +659,14 @@ lr11xx_wifi_signal_type_result_t lr11xx_wifi_extract_signal_type_from_data_rate_
 
 uint64_t lr11xx_wifi_get_consumption(lr11xx_system_reg_mode_t regulator, lr11xx_wifi_cumulative_timings_t timing)
 {
-    uint64_t wifi_scan_consumption_uah = 0;
-
-    wifi_scan_consumption_uah = (timing.rx_capture_us * LR11XX_WIFI_CAPTURE_UA) +
-                                (timing.demodulation_us * LR11XX_WIFI_DEMODULATION_UA) +
-                                (timing.rx_correlation_us * LR11XX_WIFI_CORRELATION_UA);
-
-    wifi_scan_consumption_uah =
-        wifi_scan_consumption_uah /
-        (3600000000 - (timing.rx_capture_us + timing.demodulation_us + timing.rx_correlation_us));
-
-    if (regulator == LR11XX_SYSTEM_REG_MODE_LDO)
-    {
-        wifi_scan_consumption_uah *= 2;
-    }
+    // Rounded to the nearest uAh, the division by a constant is turned into a multiplication by the compiler
+    return (lr11xx_energy_get_wifi_charge_nah(regulator, &timing) + 500) / 1000;
+}
 
-    return wifi_scan_consumption_uah;
+uint32_t lr11xx_wifi_get_consumption_nah(lr11xx_system_reg_mode_t regulator,
+                                         const lr11xx_wifi_cumulative_timings_t *timing)
+{
+    return lr11xx_energy_get_wifi_charge_nah(regulator, timing);
 }
 
 /*
@@ -582,16 +675,65 @@ uint64_t lr11xx_wifi_get_consumption(lr11xx_system_reg_mode_t regulator, lr11xx_
  */
 
 static lr11xx_hal_status_t lr11xx_wifi_read_results_helper(const void *context, const uint8_t start_index,
-                                                           const uint8_t n_elem, uint8_t *buffer,
-                                                           const lr11xx_wifi_result_format_t result_format)
+                                                           const uint8_t n_elem, lr11xx_wifi_result_stream_t *stream)
 {
-    const uint8_t size_single_elem = lr11xx_wifi_get_result_size_from_format(result_format);
-    const uint8_t result_format_code = lr11xx_wifi_get_format_code(result_format);
+    const uint8_t size_single_elem = lr11xx_wifi_get_result_size_from_format(stream->format_code);
+    const uint8_t result_format_code = lr11xx_wifi_get_format_code(stream->format_code);
     const uint8_t cbuffer[LR11XX_WIFI_READ_RESULT_CMD_LENGTH] = {(uint8_t)(LR11XX_WIFI_READ_RESULT_OC >> 8),
                                                                  (uint8_t)(LR11XX_WIFI_READ_RESULT_OC & 0x00FF),
                                                                  start_index, n_elem, result_format_code};
-    const uint16_t size_total = n_elem * size_single_elem;
-    return lr11xx_hal_read(context, cbuffer, LR11XX_WIFI_READ_RESULT_CMD_LENGTH, buffer, size_total);
+    return lr11xx_hal_read_records(context, cbuffer, LR11XX_WIFI_READ_RESULT_CMD_LENGTH, size_single_elem, n_elem,
+                                   generic_results_interpreter, stream);
+}
+
+static lr11xx_status_t lr11xx_wifi_read_results_async(const void *context, const uint8_t start_result_index,
+                                                      const uint8_t nb_results,
+                                                      const lr11xx_wifi_result_format_t result_format, void *results,
+                                                      lr11xx_hal_async_callback_t callback, void *user_data)
+{
+    const lr11xx_hal_async_request_t request = {
+        .job = lr11xx_wifi_read_results_job,
+        .context = context,
+        .rx_data = (uint8_t *)results,
+        .param = ((uint32_t)start_result_index << 0) | ((uint32_t)nb_results << 8) | ((uint32_t)result_format << 16),
+        .callback = callback,
+        .user_data = user_data,
+    };
+
+    return (lr11xx_status_t)lr11xx_hal_async_submit(&request);
+}
+
+static lr11xx_hal_status_t lr11xx_wifi_read_results_job(const lr11xx_hal_async_request_t *request)
+{
+    const uint8_t start_result_index = (uint8_t)(request->param >> 0);
+    const uint8_t nb_results = (uint8_t)(request->param >> 8);
+    const lr11xx_wifi_result_format_t result_format = (lr11xx_wifi_result_format_t)((request->param >> 16) & 0xFF);
+    lr11xx_status_t status = LR11XX_STATUS_ERROR;
+
+    switch (result_format)
+    {
+    case LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE:
+    {
+        status = lr11xx_wifi_read_basic_complete_results(request->context, start_result_index, nb_results,
+                                                         (lr11xx_wifi_basic_complete_result_t *)request->rx_data);
+        break;
+    }
+    case LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL:
+    {
+        status = lr11xx_wifi_read_basic_mac_type_channel_results(
+            request->context, start_result_index, nb_results,
+            (lr11xx_wifi_basic_mac_type_channel_result_t *)request->rx_data);
+        break;
+    }
+    case LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL:
+    {
+        status = lr11xx_wifi_read_extended_full_results(request->context, start_result_index, nb_results,
+                                                        (lr11xx_wifi_extended_full_result_t *)request->rx_data);
+        break;
+    }
+    }
+
+    return (lr11xx_hal_status_t)status;
 }
 
 static uint16_t uint16_from_array(const uint8_t *array, const uint16_t index)
@@ -668,144 +810,114 @@ static lr11xx_status_t fetch_and_aggregate_all_results(const void *context, cons
                                                        const uint8_t nb_results,
                                                        const uint8_t nb_results_per_chunk_max,
                                                        const lr11xx_wifi_result_format_t result_format_code,
-                                                       uint8_t *result_buffer,
                                                        lr11xx_wifi_result_interface_t result_structures)
 {
     uint8_t index_to_read = index_result_start;
-    uint8_t index_result_start_writing = 0;
     uint8_t remaining_results = nb_results;
 
+    lr11xx_wifi_result_stream_t stream = {
+        .result_interface = result_structures,
+        .format_code = result_format_code,
+        .index_result_start_writing = 0,
+    };
+
     lr11xx_hal_status_t hal_status = LR11XX_HAL_STATUS_OK;
     while (remaining_results > 0)
     {
         uint8_t results_to_read = MIN(remaining_results, nb_results_per_chunk_max);
 
-        lr11xx_hal_status_t local_hal_status = lr11xx_wifi_read_results_helper(context, index_to_read, results_to_read,
-                                                                               result_buffer, result_format_code);
+        // Results are decoded into result_structures while they are received, no intermediate buffer is needed
+        lr11xx_hal_status_t local_hal_status =
+            lr11xx_wifi_read_results_helper(context, index_to_read, results_to_read, &stream);
         if (local_hal_status != LR11XX_HAL_STATUS_OK)
         {
             return (lr11xx_status_t)local_hal_status;
         }
 
-        generic_results_interpreter(results_to_read, index_result_start_writing, result_buffer, result_structures,
-                                    result_format_code);
-
-        // Reset the content of the result_buffer in case there are still results to fetch
-        {
-            const uint16_t result_buffer_size =
-                LR11XX_WIFI_MAX_SIZE_PER_SPI(lr11xx_wifi_get_result_size_from_format(result_format_code));
-            for (uint16_t index = 0; index < result_buffer_size; index++)
-            {
-                result_buffer[index] = 0;
-            }
-        }
-
         index_to_read += results_to_read;
-        index_result_start_writing += results_to_read;
+        stream.index_result_start_writing += results_to_read;
         remaining_results -= results_to_read;
     }
     return (lr11xx_status_t)hal_status;
 }
 
-static void generic_results_interpreter(const uint8_t n_result_to_parse, const uint8_t index_result_start_writing,
-                                        const uint8_t *buffer, lr11xx_wifi_result_interface_t result_interface,
-                                        const lr11xx_wifi_result_format_t format_code)
+static void generic_results_interpreter(void *user_data, const uint16_t index, const uint8_t *record)
 {
-    switch (format_code)
+    const lr11xx_wifi_result_stream_t *stream = (const lr11xx_wifi_result_stream_t *)user_data;
+    const uint16_t index_result = stream->index_result_start_writing + index;
+
+    switch (stream->format_code)
     {
     case LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE:
     {
-        interpret_basic_complete_result_from_buffer(n_result_to_parse, index_result_start_writing, buffer,
-                                                    result_interface.basic_complete);
+        interpret_basic_complete_result_from_buffer(record, &stream->result_interface.basic_complete[index_result]);
         break;
     }
 
     case LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL:
     {
-        interpret_basic_mac_type_channel_result_from_buffer(n_result_to_parse, index_result_start_writing, buffer,
-                                                            result_interface.basic_mac_type_channel);
+        interpret_basic_mac_type_channel_result_from_buffer(
+            record, &stream->result_interface.basic_mac_type_channel[index_result]);
         break;
     }
 
     case LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL:
     {
-        interpret_extended_full_result_from_buffer(n_result_to_parse, index_result_start_writing, buffer,
-                                                   result_interface.extended_complete);
+        interpret_extended_full_result_from_buffer(record, &stream->result_interface.extended_complete[index_result]);
         break;
     }
     }
 }
 
-static void interpret_basic_complete_result_from_buffer(const uint8_t nb_results,
-                                                        const uint8_t index_result_start_writing,
-                                                        const uint8_t *buffer,
+static void interpret_basic_complete_result_from_buffer(const uint8_t *buffer,
                                                         lr11xx_wifi_basic_complete_result_t *result)
 {
-    for (uint8_t result_index = 0; result_index < nb_results; result_index++)
-    {
-        const uint16_t local_index_start = LR11XX_WIFI_BASIC_COMPLETE_RESULT_SIZE * result_index;
-        lr11xx_wifi_basic_complete_result_t *local_wifi_result = &result[index_result_start_writing + result_index];
-        local_wifi_result->data_rate_info_byte = buffer[local_index_start + 0];
-        local_wifi_result->channel_info_byte = buffer[local_index_start + 1];
-        local_wifi_result->rssi = buffer[local_index_start + 2];
-        local_wifi_result->frame_type_info_byte = buffer[local_index_start + 3];
-        lr11xx_wifi_read_mac_address_from_buffer(buffer, local_index_start + 4, local_wifi_result->mac_address);
-        local_wifi_result->phi_offset = uint16_from_array(buffer, local_index_start + 10);
-        local_wifi_result->timestamp_us = uint64_from_array(buffer, local_index_start + 12);
-        local_wifi_result->beacon_period_tu = uint16_from_array(buffer, local_index_start + 20);
-    }
+    result->data_rate_info_byte = buffer[0];
+    result->channel_info_byte = buffer[1];
+    result->rssi = buffer[2];
+    result->frame_type_info_byte = buffer[3];
+    lr11xx_wifi_read_mac_address_from_buffer(buffer, 4, result->mac_address);
+    result->phi_offset = uint16_from_array(buffer, 10);
+    result->timestamp_us = uint64_from_array(buffer, 12);
+    result->beacon_period_tu = uint16_from_array(buffer, 20);
 }
 
-static void interpret_basic_mac_type_channel_result_from_buffer(const uint8_t nb_results,
-                                                                const uint8_t index_result_start_writing,
-                                                                const uint8_t *buffer,
+static void interpret_basic_mac_type_channel_result_from_buffer(const uint8_t *buffer,
                                                                 lr11xx_wifi_basic_mac_type_channel_result_t *result)
 {
-    for (uint8_t result_index = 0; result_index < nb_results; result_index++)
-    {
-        const uint16_t local_index_start = LR11XX_WIFI_BASIC_MAC_TYPE_CHANNEL_RESULT_SIZE * result_index;
-        lr11xx_wifi_basic_mac_type_channel_result_t *local_wifi_result =
-            &result[index_result_start_writing + result_index];
-        local_wifi_result->data_rate_info_byte = buffer[local_index_start + 0];
-        local_wifi_result->channel_info_byte = buffer[local_index_start + 1];
-        local_wifi_result->rssi = buffer[local_index_start + 2];
-        lr11xx_wifi_read_mac_address_from_buffer(buffer, local_index_start + 3, local_wifi_result->mac_address);
-    }
+    result->data_rate_info_byte = buffer[0];
+    result->channel_info_byte = buffer[1];
+    result->rssi = buffer[2];
+    lr11xx_wifi_read_mac_address_from_buffer(buffer, 3, result->mac_address);
 }
 
-void interpret_extended_full_result_from_buffer(const uint8_t nb_results, const uint8_t index_result_start_writing,
-                                                const uint8_t *buffer, lr11xx_wifi_extended_full_result_t *result)
+static void interpret_extended_full_result_from_buffer(const uint8_t *buffer,
+                                                       lr11xx_wifi_extended_full_result_t *result)
 {
-    for (uint8_t result_index = 0; result_index < nb_results; result_index++)
+    result->data_rate_info_byte = buffer[0];
+    result->channel_info_byte = buffer[1];
+    result->rssi = buffer[2];
+    result->rate = buffer[3];
+    result->service = uint16_from_array(buffer, 4);
+    result->length = uint16_from_array(buffer, 6);
+    result->frame_control = uint16_from_array(buffer, 8);
+    lr11xx_wifi_read_mac_address_from_buffer(buffer, 10, result->mac_address_1);
+    lr11xx_wifi_read_mac_address_from_buffer(buffer, 16, result->mac_address_2);
+    lr11xx_wifi_read_mac_address_from_buffer(buffer, 22, result->mac_address_3);
+    result->timestamp_us = uint64_from_array(buffer, 28);
+    result->beacon_period_tu = uint16_from_array(buffer, 36);
+    result->seq_control = uint16_from_array(buffer, 38);
+    for (uint8_t ssid_index = 0; ssid_index < LR11XX_WIFI_RESULT_SSID_LENGTH; ssid_index++)
     {
-        const uint16_t local_index_start = LR11XX_WIFI_EXTENDED_COMPLETE_RESULT_SIZE * result_index;
-        lr11xx_wifi_extended_full_result_t *local_wifi_result = &result[index_result_start_writing + result_index];
-
-        local_wifi_result->data_rate_info_byte = buffer[local_index_start + 0];
-        local_wifi_result->channel_info_byte = buffer[local_index_start + 1];
-        local_wifi_result->rssi = buffer[local_index_start + 2];
-        local_wifi_result->rate = buffer[local_index_start + 3];
-        local_wifi_result->service = uint16_from_array(buffer, local_index_start + 4);
-        local_wifi_result->length = uint16_from_array(buffer, local_index_start + 6);
-        local_wifi_result->frame_control = uint16_from_array(buffer, local_index_start + 8);
-        lr11xx_wifi_read_mac_address_from_buffer(buffer, local_index_start + 10, local_wifi_result->mac_address_1);
-        lr11xx_wifi_read_mac_address_from_buffer(buffer, local_index_start + 16, local_wifi_result->mac_address_2);
-        lr11xx_wifi_read_mac_address_from_buffer(buffer, local_index_start + 22, local_wifi_result->mac_address_3);
-        local_wifi_result->timestamp_us = uint64_from_array(buffer, local_index_start + 28);
-        local_wifi_result->beacon_period_tu = uint16_from_array(buffer, local_index_start + 36);
-        local_wifi_result->seq_control = uint16_from_array(buffer, local_index_start + 38);
-        for (uint8_t ssid_index = 0; ssid_index < LR11XX_WIFI_RESULT_SSID_LENGTH; ssid_index++)
-        {
-            local_wifi_result->ssid_bytes[ssid_index] = buffer[local_index_start + ssid_index + 40];
-        }
-        local_wifi_result->current_channel = buffer[local_index_start + 72];
-        local_wifi_result->country_code[0] = buffer[local_index_start + 73];
-        local_wifi_result->country_code[1] = buffer[local_index_start + 74];
-        local_wifi_result->io_regulation = buffer[local_index_start + 75];
-        local_wifi_result->fcs_check_byte.is_fcs_checked = ((buffer[local_index_start + 76] & 0x01) == 0x01);
-        local_wifi_result->fcs_check_byte.is_fcs_ok = ((buffer[local_index_start + 76] & 0x02) == 0x02);
-        local_wifi_result->phi_offset = uint16_from_array(buffer, local_index_start + 77);
+        result->ssid_bytes[ssid_index] = buffer[ssid_index + 40];
     }
+    result->current_channel = buffer[72];
+    result->country_code[0] = buffer[73];
+    result->country_code[1] = buffer[74];
+    result->io_regulation = buffer[75];
+    result->fcs_check_byte.is_fcs_checked = ((buffer[76] & 0x01) == 0x01);
+    result->fcs_check_byte.is_fcs_ok = ((buffer[76] & 0x02) == 0x02);
+    result->phi_offset = uint16_from_array(buffer, 77);
 }
 
 bool lr11xx_wifi_is_well_formed_utf8_byte_sequence(const uint8_t *buffer, const uint8_t length)
@@ -814,6 +926,19 @@ bool lr11xx_wifi_is_well_formed_utf8_byte_sequence(const uint8_t *buffer, const
 
     while (index < length)
     {
+        uint32_t word = 0;
+
+        // ASCII fast path: SSIDs are mostly ASCII, skip them a word at a time
+        if ((uint8_t)(length - index) >= sizeof(word))
+        {
+            memcpy(&word, &buffer[index], sizeof(word));
+            if ((word & LR11XX_WIFI_NON_ASCII_WORD_MASK) == 0)
+            {
+                index += sizeof(word);
+                continue;
+            }
+        }
+
         if (IS_BETWEEN(buffer[index], 0x00, 0x7F))
         {
             index += 1;
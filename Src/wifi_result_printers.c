@@ -49,11 +49,27 @@
  * --- PRIVATE MACROS-----------------------------------------------------------
  */
 
+#define WIFI_RESULT_PRINTERS_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*!
+ * @brief Number of results of type result_type that fit in the local array of a printer
+ */
+#define WIFI_RESULT_PRINTERS_N_RESULTS_PER_CHUNK(result_type) \
+    WIFI_RESULT_PRINTERS_MIN(WIFI_RESULT_PRINTERS_CHUNK_BUFFER_SIZE / sizeof(result_type), \
+                             LR11XX_WIFI_N_RESULTS_MAX_PER_CHUNK)
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+/*!
+ * @brief Task stack used by the local result array of a printer, in bytes
+ *
+ * Bounds the chunk of the large formats: 4 extended full results or 12 basic complete results per read.
+ */
+#define WIFI_RESULT_PRINTERS_CHUNK_BUFFER_SIZE (384)
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -69,7 +85,7 @@
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
-void print_mac_address(const char *prefix, lr11xx_wifi_mac_address_t mac);
+void print_mac_address(const char *prefix, const lr11xx_wifi_mac_address_t mac);
 
 /*
  * -----------------------------------------------------------------------------
@@ -81,25 +97,43 @@ void wifi_fetch_and_print_scan_basic_mac_type_channel_results(const void *contex
     uint8_t n_results = 0;
     lr11xx_wifi_get_nb_results(context, &n_results);
 
-    for (uint8_t result_index = 0; result_index < n_results; result_index++)
+    lr11xx_wifi_basic_mac_type_channel_result_t
+        results[WIFI_RESULT_PRINTERS_N_RESULTS_PER_CHUNK(lr11xx_wifi_basic_mac_type_channel_result_t)] = {0};
+    const uint8_t nb_results_per_chunk =
+        WIFI_RESULT_PRINTERS_MIN((uint8_t)(sizeof(results) / sizeof(results[0])),
+                                 lr11xx_wifi_get_nb_results_max_per_chunk());
+
+    // Results are read by chunks that fit in the local array, the driver splits each chunk into SPI transactions
+    for (uint8_t chunk_start = 0; chunk_start < n_results; chunk_start += nb_results_per_chunk)
     {
-        lr11xx_wifi_basic_mac_type_channel_result_t local_result = {0};
-        lr11xx_wifi_read_basic_mac_type_channel_results(context, result_index, 1, &local_result);
-
-        lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
-        lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
-        bool rssi_validity = false;
-        lr11xx_wifi_parse_channel_info(local_result.channel_info_byte, &channel, &rssi_validity, &mac_origin);
-
-        printf("Result %u/%u\n", result_index + 1, n_results);
-        print_mac_address("  -> MAC address: ", local_result.mac_address);
-        printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
-        printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
-        printf(
-            "  -> Signal type: %s\n",
-            lr11xx_wifi_signal_type_result_to_str(
-                lr11xx_wifi_extract_signal_type_from_data_rate_info(local_result.data_rate_info_byte)));
-        printf("\n");
+        const uint8_t nb_chunk_results = WIFI_RESULT_PRINTERS_MIN(n_results - chunk_start, nb_results_per_chunk);
+
+        if (lr11xx_wifi_read_basic_mac_type_channel_results(context, chunk_start, nb_chunk_results,
+                                                            results) != LR11XX_STATUS_OK)
+        {
+            return;
+        }
+
+        for (uint8_t chunk_index = 0; chunk_index < nb_chunk_results; chunk_index++)
+        {
+            const uint8_t result_index = chunk_start + chunk_index;
+            const lr11xx_wifi_basic_mac_type_channel_result_t *local_result = &results[chunk_index];
+
+            lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
+            lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+            bool rssi_validity = false;
+            lr11xx_wifi_parse_channel_info(local_result->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+
+            printf("Result %u/%u\n", result_index + 1, n_results);
+            print_mac_address("  -> MAC address: ", local_result->mac_address);
+            printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
+            printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
+            printf(
+                "  -> Signal type: %s\n",
+                lr11xx_wifi_signal_type_result_to_str(
+                    lr11xx_wifi_extract_signal_type_from_data_rate_info(local_result->data_rate_info_byte)));
+            printf("\n");
+        }
     }
 }
 
@@ -108,40 +142,58 @@ void wifi_fetch_and_print_scan_basic_complete_results(const void *context)
     uint8_t n_results = 0;
     lr11xx_wifi_get_nb_results(context, &n_results);
 
-    for (uint8_t result_index = 0; result_index < n_results; result_index++)
+    lr11xx_wifi_basic_complete_result_t
+        results[WIFI_RESULT_PRINTERS_N_RESULTS_PER_CHUNK(lr11xx_wifi_basic_complete_result_t)] = {0};
+    const uint8_t nb_results_per_chunk =
+        WIFI_RESULT_PRINTERS_MIN((uint8_t)(sizeof(results) / sizeof(results[0])),
+                                 lr11xx_wifi_get_nb_results_max_per_chunk());
+
+    // Results are read by chunks that fit in the local array, the driver splits each chunk into SPI transactions
+    for (uint8_t chunk_start = 0; chunk_start < n_results; chunk_start += nb_results_per_chunk)
     {
-        lr11xx_wifi_basic_complete_result_t local_result = {0};
-        lr11xx_wifi_read_basic_complete_results(context, result_index, 1, &local_result);
-
-        lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
-        lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
-        bool rssi_validity = false;
-        lr11xx_wifi_parse_channel_info(local_result.channel_info_byte, &channel, &rssi_validity, &mac_origin);
-
-        lr11xx_wifi_frame_type_t frame_type = LR11XX_WIFI_FRAME_TYPE_MANAGEMENT;
-        lr11xx_wifi_frame_sub_type_t frame_sub_type = 0;
-        bool to_ds = false;
-        bool from_ds = false;
-        lr11xx_wifi_parse_frame_type_info(local_result.frame_type_info_byte, &frame_type, &frame_sub_type, &to_ds,
-                                          &from_ds);
-
-        printf("Result %u/%u\n", result_index + 1, n_results);
-        print_mac_address("  -> MAC address: ", local_result.mac_address);
-        printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
-        printf("  -> MAC origin: %d\n", mac_origin);
-        printf("  -> RSSI validation: %s\n", (rssi_validity == true) ? "true" : "false");
-        printf(
-            "  -> Signal type: %s\n",
-            lr11xx_wifi_signal_type_result_to_str(
-                lr11xx_wifi_extract_signal_type_from_data_rate_info(local_result.data_rate_info_byte)));
-        printf("  -> Frame type: %s\n", lr11xx_wifi_frame_type_to_str(frame_type));
-        printf("  -> Frame sub-type: 0x%02X\n", frame_sub_type);
-        printf("  -> FromDS/ToDS: %s / %s\n", ((from_ds == true) ? "true" : "false"),
-               ((to_ds == true) ? "true" : "false"));
-        printf("  -> Phi Offset: %i\n", local_result.phi_offset);
-        printf("  -> Timestamp: %llu us\n", local_result.timestamp_us);
-        printf("  -> Beacon period: %u TU\n", local_result.beacon_period_tu);
-        printf("\n");
+        const uint8_t nb_chunk_results = WIFI_RESULT_PRINTERS_MIN(n_results - chunk_start, nb_results_per_chunk);
+
+        if (lr11xx_wifi_read_basic_complete_results(context, chunk_start, nb_chunk_results,
+                                                    results) != LR11XX_STATUS_OK)
+        {
+            return;
+        }
+
+        for (uint8_t chunk_index = 0; chunk_index < nb_chunk_results; chunk_index++)
+        {
+            const uint8_t result_index = chunk_start + chunk_index;
+            const lr11xx_wifi_basic_complete_result_t *local_result = &results[chunk_index];
+
+            lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
+            lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+            bool rssi_validity = false;
+            lr11xx_wifi_parse_channel_info(local_result->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+
+            lr11xx_wifi_frame_type_t frame_type = LR11XX_WIFI_FRAME_TYPE_MANAGEMENT;
+            lr11xx_wifi_frame_sub_type_t frame_sub_type = 0;
+            bool to_ds = false;
+            bool from_ds = false;
+            lr11xx_wifi_parse_frame_type_info(local_result->frame_type_info_byte, &frame_type, &frame_sub_type, &to_ds,
+                                              &from_ds);
+
+            printf("Result %u/%u\n", result_index + 1, n_results);
+            print_mac_address("  -> MAC address: ", local_result->mac_address);
+            printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
+            printf("  -> MAC origin: %d\n", mac_origin);
+            printf("  -> RSSI validation: %s\n", (rssi_validity == true) ? "true" : "false");
+            printf(
+                "  -> Signal type: %s\n",
+                lr11xx_wifi_signal_type_result_to_str(
+                    lr11xx_wifi_extract_signal_type_from_data_rate_info(local_result->data_rate_info_byte)));
+            printf("  -> Frame type: %s\n", lr11xx_wifi_frame_type_to_str(frame_type));
+            printf("  -> Frame sub-type: 0x%02X\n", frame_sub_type);
+            printf("  -> FromDS/ToDS: %s / %s\n", ((from_ds == true) ? "true" : "false"),
+                   ((to_ds == true) ? "true" : "false"));
+            printf("  -> Phi Offset: %i\n", local_result->phi_offset);
+            printf("  -> Timestamp: %llu us\n", local_result->timestamp_us);
+            printf("  -> Beacon period: %u TU\n", local_result->beacon_period_tu);
+            printf("\n");
+        }
     }
 }
 
@@ -150,47 +202,64 @@ void wifi_fetch_and_print_scan_extended_complete_results(const void *context)
     uint8_t n_results = 0;
     lr11xx_wifi_get_nb_results(context, &n_results);
 
-    for (uint8_t result_index = 0; result_index < n_results; result_index++)
+    lr11xx_wifi_extended_full_result_t
+        results[WIFI_RESULT_PRINTERS_N_RESULTS_PER_CHUNK(lr11xx_wifi_extended_full_result_t)] = {0};
+    const uint8_t nb_results_per_chunk =
+        WIFI_RESULT_PRINTERS_MIN((uint8_t)(sizeof(results) / sizeof(results[0])),
+                                 lr11xx_wifi_get_nb_results_max_per_chunk());
+
+    // Results are read by chunks that fit in the local array, the driver splits each chunk into SPI transactions
+    for (uint8_t chunk_start = 0; chunk_start < n_results; chunk_start += nb_results_per_chunk)
     {
-        lr11xx_wifi_extended_full_result_t local_result = {0};
-        lr11xx_wifi_read_extended_full_results(context, result_index, 1, &local_result);
-
-        lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
-        lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
-        bool rssi_validity = false;
-        lr11xx_wifi_parse_channel_info(local_result.channel_info_byte, &channel, &rssi_validity, &mac_origin);
-
-        lr11xx_wifi_signal_type_result_t wifi_signal_type = {0};
-        lr11xx_wifi_datarate_t wifi_data_rate = {0};
-        lr11xx_wifi_parse_data_rate_info(local_result.data_rate_info_byte, &wifi_signal_type, &wifi_data_rate);
-
-        printf("Result %u/%u\n", result_index + 1, n_results);
-        print_mac_address("  -> MAC address 1: ", local_result.mac_address_1);
-        print_mac_address("  -> MAC address 2: ", local_result.mac_address_2);
-        print_mac_address("  -> MAC address 3: ", local_result.mac_address_3);
-        printf("  -> Country code: %c%c\n", (uint8_t)(local_result.country_code[0]),
-               (uint8_t)(local_result.country_code[1]));
-        printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
-        printf("  -> Signal type: %s\n", lr11xx_wifi_signal_type_result_to_str(wifi_signal_type));
-        printf("  -> RSSI: %i dBm\n", local_result.rssi);
-        printf("  -> Rate index: 0x%02x\n", local_result.rate);
-        printf("  -> Service: 0x%04x\n", local_result.service);
-        printf("  -> Length: %u\n", local_result.length);
-        printf("  -> Frame control: 0x%04X\n", local_result.frame_control);
-        printf("  -> Data rate: %s\n", lr11xx_wifi_datarate_to_str(wifi_data_rate));
-        printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
-        printf("  -> Phi Offset: %i\n", local_result.phi_offset);
-        printf("  -> Timestamp: %llu us\n", local_result.timestamp_us);
-        printf("  -> Beacon period: %u TU\n", local_result.beacon_period_tu);
-        printf("  -> Sequence control: 0x%04x\n", local_result.seq_control);
-        printf("  -> IO regulation: 0x%02x\n", local_result.io_regulation);
-        printf("  -> Current channel: %s\n",
-               lr11xx_wifi_channel_to_str(local_result.current_channel));
-        printf("  -> FCS status:\n    - %s\n",
-               (local_result.fcs_check_byte.is_fcs_checked) ? "Is present" : "Is not present");
-        printf("    - %s\n", (local_result.fcs_check_byte.is_fcs_ok) ? "Valid" : "Not valid");
-
-        printf("\n");
+        const uint8_t nb_chunk_results = WIFI_RESULT_PRINTERS_MIN(n_results - chunk_start, nb_results_per_chunk);
+
+        if (lr11xx_wifi_read_extended_full_results(context, chunk_start, nb_chunk_results, results) != LR11XX_STATUS_OK)
+        {
+            return;
+        }
+
+        for (uint8_t chunk_index = 0; chunk_index < nb_chunk_results; chunk_index++)
+        {
+            const uint8_t result_index = chunk_start + chunk_index;
+            const lr11xx_wifi_extended_full_result_t *local_result = &results[chunk_index];
+
+            lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
+            lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+            bool rssi_validity = false;
+            lr11xx_wifi_parse_channel_info(local_result->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+
+            lr11xx_wifi_signal_type_result_t wifi_signal_type = {0};
+            lr11xx_wifi_datarate_t wifi_data_rate = {0};
+            lr11xx_wifi_parse_data_rate_info(local_result->data_rate_info_byte, &wifi_signal_type, &wifi_data_rate);
+
+            printf("Result %u/%u\n", result_index + 1, n_results);
+            print_mac_address("  -> MAC address 1: ", local_result->mac_address_1);
+            print_mac_address("  -> MAC address 2: ", local_result->mac_address_2);
+            print_mac_address("  -> MAC address 3: ", local_result->mac_address_3);
+            printf("  -> Country code: %c%c\n", (uint8_t)(local_result->country_code[0]),
+                   (uint8_t)(local_result->country_code[1]));
+            printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
+            printf("  -> Signal type: %s\n", lr11xx_wifi_signal_type_result_to_str(wifi_signal_type));
+            printf("  -> RSSI: %i dBm\n", local_result->rssi);
+            printf("  -> Rate index: 0x%02x\n", local_result->rate);
+            printf("  -> Service: 0x%04x\n", local_result->service);
+            printf("  -> Length: %u\n", local_result->length);
+            printf("  -> Frame control: 0x%04X\n", local_result->frame_control);
+            printf("  -> Data rate: %s\n", lr11xx_wifi_datarate_to_str(wifi_data_rate));
+            printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
+            printf("  -> Phi Offset: %i\n", local_result->phi_offset);
+            printf("  -> Timestamp: %llu us\n", local_result->timestamp_us);
+            printf("  -> Beacon period: %u TU\n", local_result->beacon_period_tu);
+            printf("  -> Sequence control: 0x%04x\n", local_result->seq_control);
+            printf("  -> IO regulation: 0x%02x\n", local_result->io_regulation);
+            printf("  -> Current channel: %s\n",
+                   lr11xx_wifi_channel_to_str(local_result->current_channel));
+            printf("  -> FCS status:\n    - %s\n",
+                   (local_result->fcs_check_byte.is_fcs_checked) ? "Is present" : "Is not present");
+            printf("    - %s\n", (local_result->fcs_check_byte.is_fcs_ok) ? "Valid" : "Not valid");
+
+            printf("\n");
+        }
     }
 }
 
@@ -199,26 +268,42 @@ void wifi_fetch_and_print_scan_country_code_results(const void *context)
     uint8_t n_results = 0;
     lr11xx_wifi_get_nb_results(context, &n_results);
 
-    for (uint8_t result_index = 0; result_index < n_results; result_index++)
+    lr11xx_wifi_country_code_t results[WIFI_RESULT_PRINTERS_N_RESULTS_PER_CHUNK(lr11xx_wifi_country_code_t)] = {0};
+    const uint8_t nb_results_per_chunk =
+        WIFI_RESULT_PRINTERS_MIN((uint8_t)(sizeof(results) / sizeof(results[0])),
+                                 lr11xx_wifi_get_nb_results_max_per_chunk());
+
+    // Results are read by chunks that fit in the local array, the driver splits each chunk into SPI transactions
+    for (uint8_t chunk_start = 0; chunk_start < n_results; chunk_start += nb_results_per_chunk)
     {
-        lr11xx_wifi_country_code_t local_result = {0};
-        lr11xx_wifi_read_country_code_results(context, result_index, 1, &local_result);
-
-        lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
-        lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
-        bool rssi_validity = false;
-        lr11xx_wifi_parse_channel_info(local_result.channel_info_byte, &channel, &rssi_validity, &mac_origin);
-
-        printf("Result %u/%u\n", result_index + 1, n_results);
-        print_mac_address("  -> MAC address: ", local_result.mac_address);
-        printf("  -> Country code: %c%c\n", local_result.country_code[0], local_result.country_code[1]);
-        printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
-        printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
-        printf("\n");
+        const uint8_t nb_chunk_results = WIFI_RESULT_PRINTERS_MIN(n_results - chunk_start, nb_results_per_chunk);
+
+        if (lr11xx_wifi_read_country_code_results(context, chunk_start, nb_chunk_results, results) != LR11XX_STATUS_OK)
+        {
+            return;
+        }
+
+        for (uint8_t chunk_index = 0; chunk_index < nb_chunk_results; chunk_index++)
+        {
+            const uint8_t result_index = chunk_start + chunk_index;
+            const lr11xx_wifi_country_code_t *local_result = &results[chunk_index];
+
+            lr11xx_wifi_mac_origin_t mac_origin = LR11XX_WIFI_ORIGIN_BEACON_FIX_AP;
+            lr11xx_wifi_channel_t channel = LR11XX_WIFI_NO_CHANNEL;
+            bool rssi_validity = false;
+            lr11xx_wifi_parse_channel_info(local_result->channel_info_byte, &channel, &rssi_validity, &mac_origin);
+
+            printf("Result %u/%u\n", result_index + 1, n_results);
+            print_mac_address("  -> MAC address: ", local_result->mac_address);
+            printf("  -> Country code: %c%c\n", local_result->country_code[0], local_result->country_code[1]);
+            printf("  -> Channel: %s\n", lr11xx_wifi_channel_to_str(channel));
+            printf("  -> MAC origin: %s\n", (rssi_validity ? "From gateway" : "From end device"));
+            printf("\n");
+        }
     }
 }
 
-void print_mac_address(const char *prefix, lr11xx_wifi_mac_address_t mac)
+void print_mac_address(const char *prefix, const lr11xx_wifi_mac_address_t mac)
 {
     printf("%s%02x:%02x:%02x:%02x:%02x:%02x\n", prefix, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
@@ -0,0 +1,238 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      country_code_check.c
+ *
+ * @brief     Host check of the country code search and of the regulatory channel mask
+ *
+ * Runs HE_WifiSearchCountryCode on the simulated LR1110 in environments with a majority country, a minority of other
+ * and malformed codes, and more access points than one chunked read returns. The results read from the radio must
+ * match the simulated access points, the majority code must be adopted and saved once, HE_GetRegulatoryChannelMask
+ * must follow it, and the following scans must skip the channels it forbids. Build and run from the repository
+ * root:
+ *
+ *   ln -s Inc LR1110_Driver
+ *   gcc -O2 -DLR11XX_SIM -I. -Ibench/host $(find Src -name '*.c') bench/host/freertos_host.c \
+ *       bench/country_code_check.c -o country_code_check
+ *   ./country_code_check
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "LR1110_Driver/lr11xx_sim.h"
+#include "LR1110_Driver/lr11xx_wifi.h"
+#include "LR1110_Driver/HE_LR1110_Api.h"
+
+#define CHECK_NB_ACCESS_POINTS (32)
+#define CHECK_SCAN_DEADLINE_MS (20000)
+
+static lr11xx_sim_access_point_t check_access_points[CHECK_NB_ACCESS_POINTS];
+static uint8_t check_nb_access_points;
+static uint32_t check_nb_failures;
+
+static uint8_t check_saved_code[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE];
+static uint32_t check_nb_saves;
+
+static void check(const bool is_ok, const char *what)
+{
+    if (is_ok == false)
+    {
+        printf("FAIL: %s\n", what);
+        check_nb_failures++;
+    }
+}
+
+static void check_save(const uint8_t *country_code)
+{
+    memcpy(check_saved_code, country_code, sizeof(check_saved_code));
+    check_nb_saves++;
+}
+
+// Environment of nb_access_points access points seen by every scan, on channels 1 to 13 in turn
+static void check_environment(const char (*country_codes)[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE],
+                              const uint8_t nb_access_points)
+{
+    lr11xx_sim_clear_access_points();
+    check_nb_access_points = nb_access_points;
+
+    for (uint8_t i = 0; i < nb_access_points; i++)
+    {
+        lr11xx_sim_access_point_t *access_point = &check_access_points[i];
+
+        *access_point = (lr11xx_sim_access_point_t){
+            {0x20, 0x02, 0x03, 0x04, 0x05, i}, 1 + (i % 13), 2, -40 - i, 100, 100, "", {0, 0},
+        };
+        memcpy(access_point->country_code, country_codes[i], LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
+        snprintf(access_point->ssid, sizeof(access_point->ssid), "check-%02u", i);
+        lr11xx_sim_add_access_point(access_point);
+    }
+}
+
+// Simulated access point a result comes from, found by its MAC address
+static const lr11xx_sim_access_point_t *check_find_access_point(const lr11xx_wifi_mac_address_t mac)
+{
+    for (uint8_t i = 0; i < check_nb_access_points; i++)
+    {
+        if (memcmp(check_access_points[i].mac_address, mac, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0)
+        {
+            return &check_access_points[i];
+        }
+    }
+
+    return NULL;
+}
+
+// The results of the last search, read back in one call, must be the access points that carry a country code
+static void check_results(void)
+{
+    lr11xx_wifi_country_code_t results[LR11XX_WIFI_MAX_COUNTRY_CODE];
+    bool is_found[CHECK_NB_ACCESS_POINTS] = {false};
+    uint8_t nb_results = 0;
+    uint8_t nb_expected = 0;
+
+    check(lr11xx_wifi_get_nb_country_code_results(NULL, &nb_results) == LR11XX_STATUS_OK, "result count read");
+    check(lr11xx_wifi_read_country_code_results(NULL, 0, nb_results, results) == LR11XX_STATUS_OK, "results read");
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const lr11xx_sim_access_point_t *access_point = check_find_access_point(results[i].mac_address);
+
+        check((access_point != NULL) && (is_found[access_point - check_access_points] == false), "result MAC address");
+        if (access_point == NULL)
+        {
+            continue;
+        }
+
+        is_found[access_point - check_access_points] = true;
+        check(memcmp(results[i].country_code, access_point->country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0,
+              "result country code");
+        check(lr11xx_wifi_extract_channel_from_info_byte(results[i].channel_info_byte) == access_point->channel,
+              "result channel");
+    }
+
+    for (uint8_t i = 0; i < check_nb_access_points; i++)
+    {
+        if (check_access_points[i].country_code[0] != '\0')
+        {
+            nb_expected++;
+        }
+    }
+
+    check(nb_results == nb_expected, "result count");
+}
+
+static void check_search(const char *name, const uint8_t expected_status, const char *expected_code,
+                         const uint16_t expected_mask, const uint32_t expected_nb_saves)
+{
+    uint8_t code[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE] = {0, 0};
+    uint8_t current_code[LR11XX_WIFI_STR_COUNTRY_CODE_SIZE] = {0, 0};
+    const uint8_t status = HE_WifiSearchCountryCode(NULL, code);
+    const bool is_known = HE_GetCountryCode(current_code);
+
+    printf("%-24s status %u, country %c%c, channel mask 0x%04X, %lu saves\n", name, status,
+           (is_known == true) ? current_code[0] : '-', (is_known == true) ? current_code[1] : '-',
+           HE_GetRegulatoryChannelMask(), (unsigned long)check_nb_saves);
+
+    check_results();
+    check(status == expected_status, "search status");
+    check(memcmp(current_code, expected_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0, "adopted country code");
+    check((status != LR1110_SUCCESS) || (memcmp(code, expected_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0),
+          "returned country code");
+    check(HE_GetRegulatoryChannelMask() == expected_mask, "regulatory channel mask");
+    check(check_nb_saves == expected_nb_saves, "number of saves");
+    check((expected_nb_saves == 0) ||
+              (memcmp(check_saved_code, expected_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0),
+          "saved country code");
+}
+
+// Every network found by a scan must be on a channel allowed by the regulatory channel mask
+static void check_scan_channels(void)
+{
+    lr11xx_wifi_basic_mac_type_channel_result_t results[LR11XX_WIFI_MAX_RESULTS];
+    uint8_t nb_results = 0;
+    uint8_t nb_allowed = 0;
+
+    for (uint8_t i = 0; i < check_nb_access_points; i++)
+    {
+        if ((HE_GetRegulatoryChannelMask() & (1u << (check_access_points[i].channel - 1))) != 0)
+        {
+            nb_allowed++;
+        }
+    }
+
+    check(HE_WifiScanAndWait(NULL, CHECK_SCAN_DEADLINE_MS, results, &nb_results) == LR1110_SUCCESS, "scan");
+    check(nb_results == nb_allowed, "scanned networks on allowed channels");
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const uint8_t channel = lr11xx_wifi_extract_channel_from_info_byte(results[i].channel_info_byte);
+
+        check((HE_GetRegulatoryChannelMask() & (1u << (channel - 1))) != 0, "scanned channel allowed");
+    }
+}
+
+int main(void)
+{
+    static char codes[CHECK_NB_ACCESS_POINTS][LR11XX_WIFI_STR_COUNTRY_CODE_SIZE];
+
+    lr11xx_sim_init(NULL);
+    HE_SetCountryCodeSaveCallback(check_save);
+
+    // 32 access points, two chunked reads: 18 US, 9 CA, 3 malformed, 2 without country code
+    for (uint8_t i = 0; i < CHECK_NB_ACCESS_POINTS; i++)
+    {
+        const char *code = (i < 18) ? "US" : (i < 27) ? "CA" : (i < 30) ? "u1" : "\0\0";
+
+        memcpy(codes[i], code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
+    }
+    check_environment(codes, CHECK_NB_ACCESS_POINTS);
+    check_search("US majority", LR1110_SUCCESS, "US", LR1110_WIFI_CHANNELS_1_TO_11_MASK, 1);
+    check_scan_channels();
+    check_search("US majority again", LR1110_SUCCESS, "US", LR1110_WIFI_CHANNELS_1_TO_11_MASK, 1);
+
+    // 26 access points: a JP majority among BR and US, all channels allowed
+    for (uint8_t i = 0; i < 26; i++)
+    {
+        memcpy(codes[i], ((i % 2) == 0) ? "JP" : ((i % 4) == 1) ? "BR" : "US", LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
+    }
+    check_environment(codes, 26);
+    check_search("JP majority", LR1110_SUCCESS, "JP", LR1110_WIFI_ALL_CHANNELS_MASK, 2);
+    check_scan_channels();
+
+    // BR majority: channels 1 to 13
+    for (uint8_t i = 0; i < 20; i++)
+    {
+        memcpy(codes[i], (i < 11) ? "BR" : "DE", LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
+    }
+    check_environment(codes, 20);
+    check_search("BR majority", LR1110_SUCCESS, "BR", LR1110_WIFI_CHANNELS_1_TO_13_MASK, 3);
+    check_scan_channels();
+
+    // No beacon carries a valid country code: the current country is kept
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        memcpy(codes[i], (i < 5) ? "\0\0" : "b2", LR11XX_WIFI_STR_COUNTRY_CODE_SIZE);
+    }
+    check_environment(codes, 10);
+    check_search("no valid country code", LR1110_NO_WIFI_FOUND, "BR", LR1110_WIFI_CHANNELS_1_TO_13_MASK, 3);
+
+    printf("%lu check failures\n", (unsigned long)check_nb_failures);
+
+    return (check_nb_failures == 0) ? 0 : 1;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      energy_bench.c
+ *
+ * @brief     Host benchmark of the fixed-point charge estimation
+ *
+ * Checks lr11xx_energy_get_charge_nah, lr11xx_energy_get_wifi_charge_nah and lr11xx_wifi_get_consumption against a
+ * double precision reference, then times them against the previous lr11xx_wifi_get_consumption, whose 64-bit
+ * division is run through a bitwise divider as libgcc does on a Cortex-M3. Build and run from the repository root:
+ *
+ *   ln -s Inc LR1110_Driver
+ *   gcc -O2 -DLR11XX_SIM -I. -Ibench/host $(find Src -name '*.c') bench/host/freertos_host.c \
+ *       bench/energy_bench.c -lm -o energy_bench
+ *   ./energy_bench
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "LR1110_Driver/lr11xx_energy.h"
+#include "LR1110_Driver/lr11xx_wifi.h"
+
+#define BENCH_NB_TIMINGS (1000000)
+
+// Longest duration checked, one hour in microseconds
+#define BENCH_MAX_DURATION_US (3600000000u)
+
+/*
+ * Bitwise 64-bit division, as __aeabi_uldivmod runs on a core without a 64-bit divider
+ */
+static __attribute__((noinline)) uint64_t bench_soft_udiv64(uint64_t dividend, uint64_t divisor)
+{
+    uint64_t quotient = 0;
+    uint64_t remainder = 0;
+
+    for (int8_t bit = 63; bit >= 0; bit--)
+    {
+        remainder = (remainder << 1) | ((dividend >> bit) & 1);
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= 1ull << bit;
+        }
+    }
+
+    return quotient;
+}
+
+/*
+ * Previous lr11xx_wifi_get_consumption, with the products widened to 64 bits
+ */
+static __attribute__((noinline)) uint64_t bench_previous_consumption(lr11xx_system_reg_mode_t regulator,
+                                                                     lr11xx_wifi_cumulative_timings_t timing)
+{
+    uint64_t consumption_uah = ((uint64_t)timing.rx_capture_us * 12000) + ((uint64_t)timing.demodulation_us * 4000) +
+                               ((uint64_t)timing.rx_correlation_us * 12000);
+
+    consumption_uah = bench_soft_udiv64(
+        consumption_uah, 3600000000ull - (timing.rx_capture_us + timing.demodulation_us + timing.rx_correlation_us));
+
+    if (regulator == LR11XX_SYSTEM_REG_MODE_LDO)
+    {
+        consumption_uah *= 2;
+    }
+
+    return consumption_uah;
+}
+
+static double bench_now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    static lr11xx_wifi_cumulative_timings_t timings[BENCH_NB_TIMINGS];
+    double max_charge_error_nah = 0;
+    double max_charge_relative_error = 0;
+    double max_wifi_error_nah = 0;
+    double max_previous_error_uah = 0;
+    double max_consumption_error_uah = 0;
+
+    srand(1);
+    for (uint32_t i = 0; i < BENCH_NB_TIMINGS; i++)
+    {
+        timings[i].rx_correlation_us = rand() % 2000000;
+        timings[i].rx_capture_us = rand() % 500000;
+        timings[i].demodulation_us = rand() % 200000;
+        timings[i].rx_detection_us = 0;
+    }
+
+    // Every activity and regulator, durations from 1 us to one hour
+    for (uint8_t regulator = 0; regulator < 2; regulator++)
+    {
+        for (uint8_t activity = 0; activity < LR11XX_ENERGY_NB_ACTIVITIES; activity++)
+        {
+            for (uint32_t duration_us = 1; duration_us < BENCH_MAX_DURATION_US; duration_us = duration_us * 3 + 7)
+            {
+                const double reference_nah =
+                    (double)lr11xx_energy_get_current_ua(regulator, activity) * duration_us / 3.6e6;
+                const double error_nah =
+                    fabs(lr11xx_energy_get_charge_nah(regulator, activity, duration_us) - reference_nah);
+
+                if (error_nah > max_charge_error_nah)
+                {
+                    max_charge_error_nah = error_nah;
+                }
+                if ((reference_nah > 1000) && (error_nah / reference_nah > max_charge_relative_error))
+                {
+                    max_charge_relative_error = error_nah / reference_nah;
+                }
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < BENCH_NB_TIMINGS; i++)
+    {
+        for (uint8_t regulator = 0; regulator < 2; regulator++)
+        {
+            const double factor = (regulator == LR11XX_SYSTEM_REG_MODE_LDO) ? 2 : 1;
+            const double reference_nah = factor *
+                                         (timings[i].rx_correlation_us * 12000.0 + timings[i].rx_capture_us * 12000.0 +
+                                          timings[i].demodulation_us * 4000.0) /
+                                         3.6e6;
+            const double wifi_error_nah =
+                fabs(lr11xx_energy_get_wifi_charge_nah(regulator, &timings[i]) - reference_nah);
+            const double previous_error_uah =
+                fabs(bench_previous_consumption(regulator, timings[i]) - reference_nah / 1000);
+            const double consumption_error_uah =
+                fabs(lr11xx_wifi_get_consumption(regulator, timings[i]) - reference_nah / 1000);
+
+            if (wifi_error_nah > max_wifi_error_nah)
+            {
+                max_wifi_error_nah = wifi_error_nah;
+            }
+            if (previous_error_uah > max_previous_error_uah)
+            {
+                max_previous_error_uah = previous_error_uah;
+            }
+            if (consumption_error_uah > max_consumption_error_uah)
+            {
+                max_consumption_error_uah = consumption_error_uah;
+            }
+        }
+    }
+
+    printf("charge: max error %.3f nAh, max relative error above 1 uAh %.2e\n", max_charge_error_nah,
+           max_charge_relative_error);
+    printf("wifi charge: max error %.3f nAh, uAh max error previous %.3f current %.3f\n", max_wifi_error_nah,
+           max_previous_error_uah, max_consumption_error_uah);
+
+    volatile uint64_t sink = 0;
+    const double start_s = bench_now_s();
+    for (uint32_t i = 0; i < BENCH_NB_TIMINGS; i++)
+    {
+        sink += bench_previous_consumption(LR11XX_SYSTEM_REG_MODE_DCDC, timings[i]);
+    }
+    const double previous_end_s = bench_now_s();
+    for (uint32_t i = 0; i < BENCH_NB_TIMINGS; i++)
+    {
+        sink += lr11xx_wifi_get_consumption(LR11XX_SYSTEM_REG_MODE_DCDC, timings[i]);
+    }
+    const double consumption_end_s = bench_now_s();
+    for (uint32_t i = 0; i < BENCH_NB_TIMINGS; i++)
+    {
+        sink += lr11xx_energy_get_wifi_charge_nah(LR11XX_SYSTEM_REG_MODE_DCDC, &timings[i]);
+    }
+    const double charge_end_s = bench_now_s();
+
+    printf("speed: previous uAh %.1f ns/call, current uAh %.1f ns/call, current nAh %.1f ns/call\n",
+           (previous_end_s - start_s) * 1e9 / BENCH_NB_TIMINGS,
+           (consumption_end_s - previous_end_s) * 1e9 / BENCH_NB_TIMINGS,
+           (charge_end_s - consumption_end_s) * 1e9 / BENCH_NB_TIMINGS);
+
+    return 0;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      FreeRTOS.h
+ *
+ * @brief     Single-task FreeRTOS stand-in for the host benchmarks
+ *
+ * Just enough of the kernel API for the driver to build on the host with LR11XX_SIM. The scheduler never runs, so
+ * the HAL locks are no-ops and the tick count follows the virtual clock of the simulator.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE (1)
+#define pdFALSE (0)
+#define pdPASS (1)
+#define portMAX_DELAY (0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS (1)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMINIMAL_STACK_SIZE (128)
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES (2)
+#define tskIDLE_PRIORITY (0)
+#define configASSERT(x)
+#define portYIELD_FROM_ISR(x) (void)(x)
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+
+#endif // FREERTOS_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      freertos_host.c
+ *
+ * @brief     Single-task FreeRTOS stand-in for the host benchmarks
+ *
+ * No task is ever created and the scheduler never starts: notifications and queues are inert, delays advance the
+ * virtual clock of the simulator.
+ */
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "LR1110_Driver/lr11xx_sim.h"
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)1;
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return taskSCHEDULER_NOT_STARTED;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(lr11xx_sim_get_time_us() / 1000);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    lr11xx_sim_advance_time_us((uint64_t)ticks * 1000);
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    (void)task;
+    return tskIDLE_PRIORITY;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint16_t stack_depth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    (void)function;
+    (void)name;
+    (void)stack_depth;
+    (void)parameters;
+    (void)priority;
+    (void)created_task;
+    return pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    return ulTaskNotifyTakeIndexed(0, clear_on_exit, ticks_to_wait);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return xTaskNotifyGiveIndexed(task, 0);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    vTaskNotifyGiveIndexedFromISR(task, 0, higher_priority_task_woken);
+}
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    (void)index;
+    (void)clear_on_exit;
+    (void)ticks_to_wait;
+    return 0;
+}
+
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index)
+{
+    (void)task;
+    (void)index;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t *higher_priority_task_woken)
+{
+    (void)task;
+    (void)index;
+    *higher_priority_task_woken = pdFALSE;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    (void)length;
+    (void)item_size;
+    return NULL;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    (void)queue;
+    (void)item;
+    (void)ticks_to_wait;
+    return pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    (void)queue;
+    (void)item;
+    (void)ticks_to_wait;
+    return pdFALSE;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    (void)queue;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,341 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      utf8_bench.c
+ *
+ * @brief     Host benchmark of the SSID UTF-8 validation
+ *
+ * Checks that lr11xx_wifi_is_well_formed_utf8_byte_sequence agrees with the previous byte-by-byte validator on random
+ * and exhaustive short buffers, then times both on the SSIDs of a corpus file, one UTF-8 SSID per line, trimmed and
+ * zero-padded to the 32-byte SSID field. The two validators run alternately, BENCH_NB_RUNS times each, and the median
+ * time per call is reported with the median and the range of the per-run speedups. Build and run from the repository
+ * root:
+ *
+ *   ln -s Inc LR1110_Driver
+ *   gcc -O2 -DLR11XX_SIM -I. -Ibench/host $(find Src -name '*.c') bench/host/freertos_host.c \
+ *       bench/utf8_bench.c -o utf8_bench
+ *   ./utf8_bench bench/ssid_corpus.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LR1110_Driver/lr11xx_wifi.h"
+
+#define BENCH_MAX_SSIDS (256)
+#define BENCH_NB_RANDOM_BUFFERS (20000000)
+#define BENCH_NB_ITERATIONS (100000)
+#define BENCH_NB_RUNS (21)
+
+#define IS_BETWEEN(value, min, max) ((min <= value) && (value <= max))
+#define IS_BETWEEN_0x80_AND_0xBF(value) IS_BETWEEN(value, 0x80, 0xBF)
+
+typedef bool (*bench_validator_t)(const uint8_t *buffer, const uint8_t length);
+
+typedef enum
+{
+    BENCH_SSIDS_ALL,
+    BENCH_SSIDS_NON_ASCII,
+    BENCH_SSIDS_ASCII,
+} bench_ssid_set_t;
+
+static uint8_t bench_ssids[BENCH_MAX_SSIDS][LR11XX_WIFI_RESULT_SSID_LENGTH];
+static uint8_t bench_ssid_lengths[BENCH_MAX_SSIDS];
+static bool bench_ssid_is_ascii[BENCH_MAX_SSIDS];
+static uint16_t bench_nb_ssids;
+
+/*
+ * Previous lr11xx_wifi_is_well_formed_utf8_byte_sequence, one byte at a time
+ */
+__attribute__((noinline)) static bool bench_previous_is_well_formed_utf8(const uint8_t *buffer, const uint8_t length)
+{
+    uint8_t index = 0;
+
+    while (index < length)
+    {
+        if (IS_BETWEEN(buffer[index], 0x00, 0x7F))
+        {
+            index += 1;
+            continue;
+        }
+
+        if (length - index >= 2)
+        {
+            if (IS_BETWEEN(buffer[index], 0xC2, 0xDF) && IS_BETWEEN_0x80_AND_0xBF(buffer[index + 1]))
+            {
+                index += 2;
+                continue;
+            }
+
+            if (length - index >= 3)
+            {
+                if ((buffer[index] == 0xE0) && IS_BETWEEN(buffer[index + 1], 0xA0, 0xBF) &&
+                    IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]))
+                {
+                    index += 3;
+                    continue;
+                }
+                else if (IS_BETWEEN(buffer[index], 0xE1, 0xEC) && IS_BETWEEN_0x80_AND_0xBF(buffer[index + 1]) &&
+                         IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]))
+                {
+                    index += 3;
+                    continue;
+                }
+                else if ((buffer[index] == 0xED) && IS_BETWEEN(buffer[index + 1], 0x80, 0x9F) &&
+                         IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]))
+                {
+                    index += 3;
+                    continue;
+                }
+                else if (IS_BETWEEN(buffer[index], 0xEE, 0xEF) && IS_BETWEEN_0x80_AND_0xBF(buffer[index + 1]) &&
+                         IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]))
+                {
+                    index += 3;
+                    continue;
+                }
+
+                if (length - index >= 4)
+                {
+                    if ((buffer[index] == 0xF0) && IS_BETWEEN(buffer[index + 1], 0x90, 0xBF) &&
+                        IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]) && IS_BETWEEN_0x80_AND_0xBF(buffer[index + 3]))
+                    {
+                        index += 4;
+                        continue;
+                    }
+                    else if (IS_BETWEEN(buffer[index], 0xF1, 0xF3) && IS_BETWEEN_0x80_AND_0xBF(buffer[index + 1]) &&
+                             IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]) &&
+                             IS_BETWEEN_0x80_AND_0xBF(buffer[index + 3]))
+                    {
+                        index += 4;
+                        continue;
+                    }
+                    else if ((buffer[index] == 0xF4) && IS_BETWEEN(buffer[index + 1], 0x80, 0x8F) &&
+                             IS_BETWEEN_0x80_AND_0xBF(buffer[index + 2]) &&
+                             IS_BETWEEN_0x80_AND_0xBF(buffer[index + 3]))
+                    {
+                        index += 4;
+                        continue;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_load_corpus(const char *path)
+{
+    char line[128];
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    while ((bench_nb_ssids < BENCH_MAX_SSIDS) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        size_t length = strcspn(line, "\r\n");
+
+        if ((length == 0) || (length > LR11XX_WIFI_RESULT_SSID_LENGTH))
+        {
+            continue;
+        }
+
+        memcpy(bench_ssids[bench_nb_ssids], line, length);
+        bench_ssid_lengths[bench_nb_ssids] = (uint8_t)length;
+        bench_ssid_is_ascii[bench_nb_ssids] = true;
+        for (size_t i = 0; i < length; i++)
+        {
+            if ((uint8_t)line[i] > 0x7F)
+            {
+                bench_ssid_is_ascii[bench_nb_ssids] = false;
+            }
+        }
+        bench_nb_ssids++;
+    }
+
+    fclose(file);
+    return bench_nb_ssids > 0;
+}
+
+static uint32_t bench_count_mismatches(void)
+{
+    uint32_t nb_mismatches = 0;
+
+    srand(1);
+    for (uint32_t i = 0; i < BENCH_NB_RANDOM_BUFFERS; i++)
+    {
+        uint8_t buffer[LR11XX_WIFI_RESULT_SSID_LENGTH];
+        const uint8_t length = rand() % (LR11XX_WIFI_RESULT_SSID_LENGTH + 1);
+
+        // A mix of ASCII, continuation and arbitrary bytes
+        for (uint8_t k = 0; k < length; k++)
+        {
+            const int kind = rand() % 4;
+
+            buffer[k] = (kind == 0) ? (rand() & 0x7F) : (kind == 1) ? (0x80 | (rand() & 0x3F)) : (rand() & 0xFF);
+        }
+
+        if (bench_previous_is_well_formed_utf8(buffer, length) !=
+            lr11xx_wifi_is_well_formed_utf8_byte_sequence(buffer, length))
+        {
+            nb_mismatches++;
+        }
+    }
+
+    // Every 3-byte prefix, alone and behind ASCII bytes
+    for (uint32_t value = 0; value < (1u << 24); value++)
+    {
+        const uint8_t prefix[4] = {(uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 'A'};
+        const uint8_t shifted[8] = {
+            'a', 'b', 'c', (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 'x', 'y',
+        };
+
+        for (uint8_t length = 1; length <= sizeof(prefix); length++)
+        {
+            if (bench_previous_is_well_formed_utf8(prefix, length) !=
+                lr11xx_wifi_is_well_formed_utf8_byte_sequence(prefix, length))
+            {
+                nb_mismatches++;
+            }
+        }
+        if (bench_previous_is_well_formed_utf8(shifted, sizeof(shifted)) !=
+            lr11xx_wifi_is_well_formed_utf8_byte_sequence(shifted, sizeof(shifted)))
+        {
+            nb_mismatches++;
+        }
+    }
+
+    return nb_mismatches;
+}
+
+// Time per call of one run of BENCH_NB_ITERATIONS passes over the SSIDs, in ns
+static double bench_time_ns(bench_validator_t validator, bool padded, bench_ssid_set_t set)
+{
+    struct timespec start;
+    struct timespec end;
+    volatile uint32_t nb_valid = 0;
+    uint32_t nb_calls = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t iteration = 0; iteration < BENCH_NB_ITERATIONS; iteration++)
+    {
+        for (uint16_t i = 0; i < bench_nb_ssids; i++)
+        {
+            if ((set != BENCH_SSIDS_ALL) && (bench_ssid_is_ascii[i] != (set == BENCH_SSIDS_ASCII)))
+            {
+                continue;
+            }
+            const uint8_t length = padded ? LR11XX_WIFI_RESULT_SSID_LENGTH : bench_ssid_lengths[i];
+
+            nb_valid += validator(bench_ssids[i], length);
+            nb_calls++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (nb_calls > 0) ? ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / nb_calls : 0;
+}
+
+static int bench_compare_doubles(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Sorts the values in place
+static double bench_median(double *values, const uint8_t nb_values)
+{
+    qsort(values, nb_values, sizeof(values[0]), bench_compare_doubles);
+
+    return values[nb_values / 2];
+}
+
+/*
+ * Times both validators BENCH_NB_RUNS times, alternating which one runs first so that frequency and cache drift hit
+ * them alike, and prints the median times and the median and range of the per-run speedups
+ */
+static void bench_compare(bool padded, bench_ssid_set_t set, const char *set_name)
+{
+    double previous_ns[BENCH_NB_RUNS];
+    double current_ns[BENCH_NB_RUNS];
+    double speedups[BENCH_NB_RUNS];
+
+    for (uint8_t run = 0; run < BENCH_NB_RUNS; run++)
+    {
+        if ((run % 2) == 0)
+        {
+            previous_ns[run] = bench_time_ns(bench_previous_is_well_formed_utf8, padded, set);
+            current_ns[run] = bench_time_ns(lr11xx_wifi_is_well_formed_utf8_byte_sequence, padded, set);
+        }
+        else
+        {
+            current_ns[run] = bench_time_ns(lr11xx_wifi_is_well_formed_utf8_byte_sequence, padded, set);
+            previous_ns[run] = bench_time_ns(bench_previous_is_well_formed_utf8, padded, set);
+        }
+        speedups[run] = previous_ns[run] / current_ns[run];
+    }
+
+    const double speedup = bench_median(speedups, BENCH_NB_RUNS);
+
+    printf("%-13s %-9s previous %5.1f ns current %5.1f ns (%.2fx, runs %.2fx to %.2fx)\n",
+           padded ? "32-byte field" : "trimmed", set_name, bench_median(previous_ns, BENCH_NB_RUNS),
+           bench_median(current_ns, BENCH_NB_RUNS), speedup, speedups[0], speedups[BENCH_NB_RUNS - 1]);
+}
+
+int main(int argc, char **argv)
+{
+    static const char *set_names[] = {"mixed", "non-ASCII", "ASCII"};
+    const char *path = (argc > 1) ? argv[1] : "bench/ssid_corpus.txt";
+
+    if (bench_load_corpus(path) == false)
+    {
+        fprintf(stderr, "cannot read SSIDs from %s\n", path);
+        return 1;
+    }
+
+    for (uint16_t i = 0; i < bench_nb_ssids; i++)
+    {
+        if (lr11xx_wifi_is_well_formed_utf8_byte_sequence(bench_ssids[i], LR11XX_WIFI_RESULT_SSID_LENGTH) == false)
+        {
+            printf("SSID %u rejected\n", i);
+        }
+    }
+
+    printf("%u SSIDs, %lu mismatches with the previous validator\n", bench_nb_ssids,
+           (unsigned long)bench_count_mismatches());
+
+    for (uint8_t padded = 0; padded < 2; padded++)
+    {
+        for (uint8_t set = BENCH_SSIDS_ALL; set <= BENCH_SSIDS_ASCII; set++)
+        {
+            bench_compare(padded, set, set_names[set]);
+        }
+    }
+
+    return 0;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,405 @@
+/*
+Copyright (c) 2023 Weslley Fábio
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+*/
+
+/*!
+ * @file      wifi_results_bench.c
+ *
+ * @brief     Host benchmark and check of the chunked Wi-Fi result reads
+ *
+ * Reads the results of a beacon scan in the basic complete format and of a full beacon scan in the extended full
+ * format, one result per call, with lr11xx_wifi_fetch_all_results and with the chunked result printers, on the
+ * simulated LR1110. The three reads must decode the same values, field by field, and match the simulated access
+ * points. Reads, bytes and time come from the HAL counters and the virtual clock of the simulator. Build and run from
+ * the repository root:
+ *
+ *   ln -s Inc LR1110_Driver
+ *   gcc -O2 -DLR11XX_SIM -I. -Ibench/host $(find Src -name '*.c') bench/host/freertos_host.c \
+ *       bench/wifi_results_bench.c -o wifi_results_bench
+ *   ./wifi_results_bench
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "LR1110_Driver/lr11xx_sim.h"
+#include "LR1110_Driver/lr11xx_hal.h"
+#include "LR1110_Driver/lr11xx_system.h"
+#include "LR1110_Driver/lr11xx_wifi.h"
+#include "LR1110_Driver/lr11xx_wifi_types_str.h"
+#include "LR1110_Driver/wifi_result_printers.h"
+#include "LR1110_Driver/HE_LR1110_Api.h"
+
+#define BENCH_NB_ACCESS_POINTS (32)
+#define BENCH_SCAN_DEADLINE_MS (20000)
+#define BENCH_FULL_BEACON_SCAN_PER_CHANNEL (3)
+#define BENCH_FULL_BEACON_SCAN_TIMEOUT_MS (110)
+#define BENCH_PRINTER_OUTPUT_SIZE (32768)
+
+static lr11xx_sim_access_point_t bench_access_points[BENCH_NB_ACCESS_POINTS];
+static uint64_t bench_start_us;
+static uint32_t bench_nb_failures;
+
+static FILE *bench_capture_file;
+static int bench_saved_stdout;
+static char bench_printer_output[BENCH_PRINTER_OUTPUT_SIZE];
+
+static void bench_start(void)
+{
+    lr11xx_hal_reset_stats(NULL);
+    bench_start_us = lr11xx_sim_get_time_us();
+}
+
+static void bench_report(const char *name)
+{
+    lr11xx_hal_stats_t stats;
+
+    lr11xx_hal_get_stats(NULL, &stats);
+    printf("%-36s %3lu reads %5lu B tx %5lu B rx %6llu us\n", name, (unsigned long)stats.nb_reads,
+           (unsigned long)stats.nb_bytes_tx, (unsigned long)stats.nb_bytes_rx,
+           (unsigned long long)(lr11xx_sim_get_time_us() - bench_start_us));
+}
+
+static void bench_check(const bool is_ok, const char *what, const uint8_t index)
+{
+    if (is_ok == false)
+    {
+        printf("FAIL: %s, result %u\n", what, index);
+        bench_nb_failures++;
+    }
+}
+
+// Simulated access point a result comes from, found by its MAC address
+static const lr11xx_sim_access_point_t *bench_find_access_point(const lr11xx_wifi_mac_address_t mac)
+{
+    for (uint8_t i = 0; i < BENCH_NB_ACCESS_POINTS; i++)
+    {
+        if (memcmp(bench_access_points[i].mac_address, mac, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0)
+        {
+            return &bench_access_points[i];
+        }
+    }
+
+    return NULL;
+}
+
+// The printers write to stdout: their output is kept in bench_printer_output to be checked
+static void bench_capture_start(void)
+{
+    fflush(stdout);
+    bench_capture_file = tmpfile();
+    bench_saved_stdout = dup(STDOUT_FILENO);
+    dup2(fileno(bench_capture_file), STDOUT_FILENO);
+}
+
+static void bench_capture_stop(void)
+{
+    fflush(stdout);
+    dup2(bench_saved_stdout, STDOUT_FILENO);
+    close(bench_saved_stdout);
+
+    rewind(bench_capture_file);
+    const size_t length = fread(bench_printer_output, 1, sizeof(bench_printer_output) - 1, bench_capture_file);
+    bench_printer_output[length] = '\0';
+    fclose(bench_capture_file);
+}
+
+// Look for the formatted line in the printer output after *cursor, and move *cursor past it
+static void bench_expect_line(const char **cursor, const uint8_t index, const char *format, ...)
+{
+    char line[128];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    const char *found = strstr(*cursor, line);
+
+    bench_check(found != NULL, line, index);
+    if (found != NULL)
+    {
+        *cursor = found + strlen(line);
+    }
+}
+
+static void bench_expect_mac_line(const char **cursor, const uint8_t index, const char *prefix,
+                                  const lr11xx_wifi_mac_address_t mac)
+{
+    bench_expect_line(cursor, index, "%s%02x:%02x:%02x:%02x:%02x:%02x\n", prefix, mac[0], mac[1], mac[2], mac[3],
+                      mac[4], mac[5]);
+}
+
+static void bench_check_basic_complete(const lr11xx_wifi_basic_complete_result_t *result,
+                                       const lr11xx_wifi_basic_complete_result_t *reference, const uint8_t index)
+{
+    bench_check(result->data_rate_info_byte == reference->data_rate_info_byte, "data_rate_info_byte", index);
+    bench_check(result->channel_info_byte == reference->channel_info_byte, "channel_info_byte", index);
+    bench_check(result->rssi == reference->rssi, "rssi", index);
+    bench_check(result->frame_type_info_byte == reference->frame_type_info_byte, "frame_type_info_byte", index);
+    bench_check(memcmp(result->mac_address, reference->mac_address, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address", index);
+    bench_check(result->phi_offset == reference->phi_offset, "phi_offset", index);
+    bench_check(result->timestamp_us == reference->timestamp_us, "timestamp_us", index);
+    bench_check(result->beacon_period_tu == reference->beacon_period_tu, "beacon_period_tu", index);
+}
+
+static void bench_check_extended_full(const lr11xx_wifi_extended_full_result_t *result,
+                                      const lr11xx_wifi_extended_full_result_t *reference, const uint8_t index)
+{
+    bench_check(result->data_rate_info_byte == reference->data_rate_info_byte, "data_rate_info_byte", index);
+    bench_check(result->channel_info_byte == reference->channel_info_byte, "channel_info_byte", index);
+    bench_check(result->rssi == reference->rssi, "rssi", index);
+    bench_check(result->rate == reference->rate, "rate", index);
+    bench_check(result->service == reference->service, "service", index);
+    bench_check(result->length == reference->length, "length", index);
+    bench_check(result->frame_control == reference->frame_control, "frame_control", index);
+    bench_check(memcmp(result->mac_address_1, reference->mac_address_1, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address_1", index);
+    bench_check(memcmp(result->mac_address_2, reference->mac_address_2, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address_2", index);
+    bench_check(memcmp(result->mac_address_3, reference->mac_address_3, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address_3", index);
+    bench_check(result->timestamp_us == reference->timestamp_us, "timestamp_us", index);
+    bench_check(result->beacon_period_tu == reference->beacon_period_tu, "beacon_period_tu", index);
+    bench_check(result->seq_control == reference->seq_control, "seq_control", index);
+    bench_check(memcmp(result->ssid_bytes, reference->ssid_bytes, LR11XX_WIFI_RESULT_SSID_LENGTH) == 0, "ssid_bytes",
+                index);
+    bench_check(result->current_channel == reference->current_channel, "current_channel", index);
+    bench_check(memcmp(result->country_code, reference->country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0,
+                "country_code", index);
+    bench_check(result->io_regulation == reference->io_regulation, "io_regulation", index);
+    bench_check(result->fcs_check_byte.is_fcs_checked == reference->fcs_check_byte.is_fcs_checked, "is_fcs_checked",
+                index);
+    bench_check(result->fcs_check_byte.is_fcs_ok == reference->fcs_check_byte.is_fcs_ok, "is_fcs_ok", index);
+    bench_check(result->phi_offset == reference->phi_offset, "phi_offset", index);
+}
+
+// Values the simulator encodes from the access point, independent of the read path
+static void bench_check_basic_complete_source(const lr11xx_wifi_basic_complete_result_t *result, const uint8_t index)
+{
+    const lr11xx_sim_access_point_t *access_point = bench_find_access_point(result->mac_address);
+
+    bench_check(access_point != NULL, "mac_address of a simulated access point", index);
+    if (access_point != NULL)
+    {
+        bench_check((result->channel_info_byte & 0x0F) == access_point->channel, "channel", index);
+        bench_check(result->beacon_period_tu == access_point->beacon_period_tu, "beacon_period_tu of the AP", index);
+    }
+}
+
+static void bench_check_extended_full_source(const lr11xx_wifi_extended_full_result_t *result, const uint8_t index)
+{
+    static const lr11xx_wifi_mac_address_t broadcast = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const lr11xx_sim_access_point_t *access_point = bench_find_access_point(result->mac_address_2);
+
+    bench_check(memcmp(result->mac_address_1, broadcast, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address_1 broadcast", index);
+    bench_check(memcmp(result->mac_address_3, result->mac_address_2, LR11XX_WIFI_MAC_ADDRESS_LENGTH) == 0,
+                "mac_address_3 equal to mac_address_2", index);
+    bench_check(access_point != NULL, "mac_address_2 of a simulated access point", index);
+    if (access_point != NULL)
+    {
+        bench_check((result->channel_info_byte & 0x0F) == access_point->channel, "channel", index);
+        bench_check(result->current_channel == access_point->channel, "current_channel of the AP", index);
+        bench_check(result->beacon_period_tu == access_point->beacon_period_tu, "beacon_period_tu of the AP", index);
+        bench_check(memcmp(result->ssid_bytes, access_point->ssid, LR11XX_WIFI_RESULT_SSID_LENGTH) == 0,
+                    "ssid_bytes of the AP", index);
+        bench_check(memcmp(result->country_code, access_point->country_code, LR11XX_WIFI_STR_COUNTRY_CODE_SIZE) == 0,
+                    "country_code of the AP", index);
+        bench_check((result->fcs_check_byte.is_fcs_checked == true) && (result->fcs_check_byte.is_fcs_ok == true),
+                    "fcs_check_byte", index);
+    }
+}
+
+// Scan in the full beacon mode, the only one whose results can be read in the extended full format
+static bool bench_full_beacon_scan(uint8_t *nb_results)
+{
+    lr11xx_system_irq_mask_t irq_status = 0;
+
+    if ((lr11xx_system_clear_irq_status(NULL, LR11XX_SYSTEM_IRQ_ALL_MASK) != LR11XX_STATUS_OK) ||
+        (lr11xx_wifi_scan(NULL, LR11XX_WIFI_TYPE_SCAN_B_G_N, LR1110_WIFI_ALL_CHANNELS_MASK,
+                          LR11XX_WIFI_SCAN_MODE_FULL_BEACON, LR11XX_WIFI_MAX_RESULTS,
+                          BENCH_FULL_BEACON_SCAN_PER_CHANNEL, BENCH_FULL_BEACON_SCAN_TIMEOUT_MS,
+                          false) != LR11XX_STATUS_OK))
+    {
+        return false;
+    }
+    lr11xx_hal_clear_irq(NULL);
+
+    if ((lr11xx_hal_wait_irq(NULL, BENCH_SCAN_DEADLINE_MS) != LR11XX_HAL_STATUS_OK) ||
+        (lr11xx_system_get_and_clear_irq_status(NULL, &irq_status) != LR11XX_STATUS_OK) ||
+        ((irq_status & LR11XX_SYSTEM_IRQ_WIFI_SCAN_DONE) == 0))
+    {
+        return false;
+    }
+
+    return (lr11xx_wifi_get_nb_results(NULL, nb_results) == LR11XX_STATUS_OK) && (*nb_results > 0);
+}
+
+static void bench_basic_complete(const uint8_t nb_results)
+{
+    static lr11xx_wifi_basic_complete_result_t per_call[LR11XX_WIFI_MAX_RESULTS];
+    static lr11xx_wifi_basic_complete_result_t fetched[LR11XX_WIFI_MAX_RESULTS];
+    uint8_t nb_fetched = 0;
+
+    bench_start();
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        lr11xx_wifi_read_basic_complete_results(NULL, i, 1, &per_call[i]);
+    }
+    bench_report("basic complete, 1 result per call");
+
+    bench_start();
+    lr11xx_wifi_fetch_all_results(NULL, LR11XX_WIFI_RESULT_FORMAT_BASIC_COMPLETE, fetched, LR11XX_WIFI_MAX_RESULTS,
+                                  &nb_fetched);
+    bench_report("basic complete, fetch_all");
+
+    bench_capture_start();
+    bench_start();
+    wifi_fetch_and_print_scan_basic_complete_results(NULL);
+    bench_capture_stop();
+    bench_report("basic complete printer");
+
+    bench_check(nb_fetched == nb_results, "fetch_all result count", nb_fetched);
+
+    const char *cursor = bench_printer_output;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const lr11xx_wifi_basic_complete_result_t *result = &per_call[i];
+
+        bench_check_basic_complete_source(result, i);
+        bench_check_basic_complete(&fetched[i], result, i);
+
+        bench_expect_line(&cursor, i, "Result %u/%u\n", i + 1, nb_results);
+        bench_expect_mac_line(&cursor, i, "  -> MAC address: ", result->mac_address);
+        bench_expect_line(&cursor, i, "  -> Channel: %s\n",
+                          lr11xx_wifi_channel_to_str(lr11xx_wifi_extract_channel_from_info_byte(
+                              result->channel_info_byte)));
+        bench_expect_line(&cursor, i, "  -> Phi Offset: %i\n", result->phi_offset);
+        bench_expect_line(&cursor, i, "  -> Timestamp: %llu us\n", result->timestamp_us);
+        bench_expect_line(&cursor, i, "  -> Beacon period: %u TU\n", result->beacon_period_tu);
+    }
+}
+
+static void bench_extended_full(const uint8_t nb_results)
+{
+    static lr11xx_wifi_extended_full_result_t per_call[LR11XX_WIFI_MAX_RESULTS];
+    static lr11xx_wifi_extended_full_result_t fetched[LR11XX_WIFI_MAX_RESULTS];
+    uint8_t nb_fetched = 0;
+
+    bench_start();
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        lr11xx_wifi_read_extended_full_results(NULL, i, 1, &per_call[i]);
+    }
+    bench_report("extended full, 1 result per call");
+
+    bench_start();
+    lr11xx_wifi_fetch_all_results(NULL, LR11XX_WIFI_RESULT_FORMAT_EXTENDED_FULL, fetched, LR11XX_WIFI_MAX_RESULTS,
+                                  &nb_fetched);
+    bench_report("extended full, fetch_all");
+
+    bench_capture_start();
+    bench_start();
+    wifi_fetch_and_print_scan_extended_complete_results(NULL);
+    bench_capture_stop();
+    bench_report("extended full printer");
+
+    bench_check(nb_fetched == nb_results, "fetch_all result count", nb_fetched);
+
+    const char *cursor = bench_printer_output;
+
+    for (uint8_t i = 0; i < nb_results; i++)
+    {
+        const lr11xx_wifi_extended_full_result_t *result = &per_call[i];
+
+        bench_check_extended_full_source(result, i);
+        bench_check_extended_full(&fetched[i], result, i);
+
+        bench_expect_line(&cursor, i, "Result %u/%u\n", i + 1, nb_results);
+        bench_expect_mac_line(&cursor, i, "  -> MAC address 1: ", result->mac_address_1);
+        bench_expect_mac_line(&cursor, i, "  -> MAC address 2: ", result->mac_address_2);
+        bench_expect_mac_line(&cursor, i, "  -> MAC address 3: ", result->mac_address_3);
+        bench_expect_line(&cursor, i, "  -> Country code: %c%c\n", result->country_code[0], result->country_code[1]);
+        bench_expect_line(&cursor, i, "  -> RSSI: %i dBm\n", result->rssi);
+        bench_expect_line(&cursor, i, "  -> Frame control: 0x%04X\n", result->frame_control);
+        bench_expect_line(&cursor, i, "  -> Timestamp: %llu us\n", result->timestamp_us);
+        bench_expect_line(&cursor, i, "  -> Beacon period: %u TU\n", result->beacon_period_tu);
+        bench_expect_line(&cursor, i, "  -> Current channel: %s\n",
+                          lr11xx_wifi_channel_to_str(result->current_channel));
+    }
+}
+
+int main(void)
+{
+    static lr11xx_wifi_basic_mac_type_channel_result_t mac_type_channel[LR11XX_WIFI_MAX_RESULTS];
+    static lr11xx_wifi_basic_mac_type_channel_result_t fetched[LR11XX_WIFI_MAX_RESULTS];
+    uint8_t nb_results = 0;
+    uint8_t nb_fetched = 0;
+
+    lr11xx_sim_init(NULL);
+    for (uint8_t i = 0; i < BENCH_NB_ACCESS_POINTS; i++)
+    {
+        lr11xx_sim_access_point_t *access_point = &bench_access_points[i];
+
+        *access_point = (lr11xx_sim_access_point_t){
+            {0x10, 0x02, 0x03, 0x04, 0x05, i}, 1 + (i % 13), 2, -40 - i, 90, 100 + i, "", {'B', 'R'},
+        };
+        snprintf(access_point->ssid, sizeof(access_point->ssid), "bench-%02u", i);
+        lr11xx_sim_add_access_point(access_point);
+    }
+
+    // Beacon scan: basic formats
+    if ((HE_WifiScanAndWait(NULL, BENCH_SCAN_DEADLINE_MS, mac_type_channel, &nb_results) != LR1110_SUCCESS) ||
+        (nb_results == 0))
+    {
+        printf("beacon scan failed\n");
+        return 1;
+    }
+    printf("beacon scan: %u results\n", nb_results);
+
+    bench_basic_complete(nb_results);
+
+    bench_start();
+    lr11xx_wifi_fetch_all_results(NULL, LR11XX_WIFI_RESULT_FORMAT_BASIC_MAC_TYPE_CHANNEL, fetched,
+                                  LR11XX_WIFI_MAX_RESULTS, &nb_fetched);
+    bench_report("basic MAC/type/channel, fetch_all");
+
+    bench_check(nb_fetched == nb_results, "fetch_all result count", nb_fetched);
+    for (uint8_t i = 0; i < nb_fetched; i++)
+    {
+        bench_check(memcmp(&fetched[i], &mac_type_channel[i], sizeof(fetched[i])) == 0, "basic MAC/type/channel", i);
+    }
+
+    // Full beacon scan: extended full format
+    if (bench_full_beacon_scan(&nb_results) == false)
+    {
+        printf("full beacon scan failed\n");
+        return 1;
+    }
+    printf("full beacon scan: %u results\n", nb_results);
+
+    bench_extended_full(nb_results);
+
+    printf("%lu check failures\n", (unsigned long)bench_nb_failures);
+
+    return (bench_nb_failures == 0) ? 0 : 1;
+}
+
+/* --- EOF ------------------------------------------------------------------ */